@@ -69,6 +69,7 @@
 #include "equationdetect.h"
 #include "tessbox.h"
 #include "makerow.h"
+#include "objectpool.h"
 #include "otsuthr.h"
 #include "osdetect.h"
 #include "params.h"
@@ -93,10 +94,6 @@ const char kUNLVSuspect = '^';
  * for a possible UNLV zone file, if none is specified by SetInputName.
  */
 const char* kInputFile = "noname.tif";
-/**
- * Temp file used for storing current parameters before applying retry values.
- */
-const char* kOldVarsFile = "failed_vars.txt";
 /** Max string length of an int.  */
 const int kMaxIntSize = 22;
 /**
@@ -106,6 +103,11 @@ const int kMaxIntSize = 22;
 const int kMinCredibleResolution = 70;
 /** Maximum believable resolution.  */
 const int kMaxCredibleResolution = 2400;
+/**
+ * Number of bytes of output that the streaming output functions collect
+ * before passing them on to the sink.
+ */
+const int kOutputChunkSize = 4096;
 
 TessBaseAPI::TessBaseAPI()
   : tesseract_(NULL),
@@ -125,6 +127,11 @@ TessBaseAPI::TessBaseAPI()
     language_(NULL),
     last_oem_requested_(OEM_DEFAULT),
     recognition_done_(false),
+    init_configs_(NULL),
+    init_vars_vec_(NULL),
+    init_vars_values_(NULL),
+    init_only_non_debug_params_(false),
+    prototype_params_(NULL),
     truth_cb_(NULL),
     rect_left_(0), rect_top_(0), rect_width_(0), rect_height_(0),
     image_width_(0), image_height_(0) {
@@ -220,30 +227,26 @@ bool TessBaseAPI::SetDebugVariable(const char* name, const char* value) {
 }
 
 bool TessBaseAPI::GetIntVariable(const char *name, int *value) const {
-  IntParam *p = ParamUtils::FindParam<IntParam>(
-      name, GlobalParams()->int_params, tesseract_->params()->int_params);
+  IntParam *p = ParamUtils::FindParam<IntParam>(name, tesseract_->params());
   if (p == NULL) return false;
   *value = (inT32)(*p);
   return true;
 }
 
 bool TessBaseAPI::GetBoolVariable(const char *name, bool *value) const {
-  BoolParam *p = ParamUtils::FindParam<BoolParam>(
-      name, GlobalParams()->bool_params, tesseract_->params()->bool_params);
+  BoolParam *p = ParamUtils::FindParam<BoolParam>(name, tesseract_->params());
   if (p == NULL) return false;
   *value = (BOOL8)(*p);
   return true;
 }
 
 const char *TessBaseAPI::GetStringVariable(const char *name) const {
-  StringParam *p = ParamUtils::FindParam<StringParam>(
-      name, GlobalParams()->string_params, tesseract_->params()->string_params);
+  StringParam *p = ParamUtils::FindParam<StringParam>(name, tesseract_->params());
   return (p != NULL) ? p->string() : NULL;
 }
 
 bool TessBaseAPI::GetDoubleVariable(const char *name, double *value) const {
-  DoubleParam *p = ParamUtils::FindParam<DoubleParam>(
-      name, GlobalParams()->double_params, tesseract_->params()->double_params);
+  DoubleParam *p = ParamUtils::FindParam<DoubleParam>(name, tesseract_->params());
   if (p == NULL) return false;
   *value = (double)(*p);
   return true;
@@ -284,6 +287,7 @@ int TessBaseAPI::Init(const char* datapath, const char* language,
       (datapath_ == NULL || language_ == NULL ||
        *datapath_ != datapath || last_oem_requested_ != oem ||
        (*language_ != language && tesseract_->lang != language))) {
+    ClearPrototypeParams();
     delete tesseract_;
     tesseract_ = NULL;
   }
@@ -303,6 +307,16 @@ int TessBaseAPI::Init(const char* datapath, const char* language,
         set_only_non_debug_params) != 0) {
       return -1;
     }
+    // Keep the arguments that made tesseract_, for InitFromPrototype.
+    ClearInitArgs();
+    init_configs_ = new GenericVector<STRING>;
+    for (int i = 0; i < configs_size; ++i)
+      init_configs_->push_back(STRING(configs[i]));
+    if (vars_vec != NULL)
+      init_vars_vec_ = new GenericVector<STRING>(*vars_vec);
+    if (vars_values != NULL)
+      init_vars_values_ = new GenericVector<STRING>(*vars_values);
+    init_only_non_debug_params_ = set_only_non_debug_params;
   }
   PERF_COUNT_SUB("update tesseract_")
   // Update datapath and language requested for the last valid initialization.
@@ -329,6 +343,51 @@ int TessBaseAPI::Init(const char* datapath, const char* language,
   return 0;
 }
 
+/**
+ * Initializes this instance as a copy of an already initialized prototype.
+ * The Init does all the loading, and finds the static classifier model,
+ * dictionaries and universal ambiguities of the prototype in their global
+ * caches, so only the per-engine state is built.
+ */
+int TessBaseAPI::InitFromPrototype(const TessBaseAPI& prototype) {
+  if (&prototype == this || prototype.tesseract_ == NULL ||
+      prototype.datapath_ == NULL || prototype.language_ == NULL ||
+      prototype.init_configs_ == NULL)
+    return -1;
+  // Start from scratch, so that the configs are read again.
+  End();
+  GenericVector<char*> configs;
+  for (int i = 0; i < prototype.init_configs_->size(); ++i) {
+    configs.push_back(
+        const_cast<char*>((*prototype.init_configs_)[i].string()));
+  }
+  if (Init(prototype.datapath_->string(), prototype.language_->string(),
+           prototype.last_oem_requested_,
+           configs.empty() ? NULL : &configs[0], configs.size(),
+           prototype.init_vars_vec_, prototype.init_vars_values_,
+           prototype.init_only_non_debug_params_) != 0)
+    return -1;
+  // Bring the params to the prototype's current values, which include any
+  // that were set after its Init.
+  prototype_params_ = new ParamSet;
+  prototype_params_->AddValues(*prototype.tesseract_->params(),
+                               SET_PARAM_CONSTRAINT_NON_INIT_ONLY,
+                               tesseract_->params());
+  prototype_params_->Apply();
+  return 0;
+}
+
+/**
+ * Returns an instance initialized by InitFromPrototype to the state it had
+ * straight after it, without reading anything from disk.
+ */
+void TessBaseAPI::ResetToPrototype() {
+  Clear();
+  ClearAdaptiveClassifier();
+  if (prototype_params_ != NULL)
+    prototype_params_->Apply();
+}
+
 /**
  * Returns the languages string used in the last valid initialization.
  * If the last initialization specified "deu+hin" then that will be
@@ -446,6 +505,30 @@ void TessBaseAPI::ReadDebugConfigFile(const char* filename) {
   tesseract_->read_config_file(filename, SET_PARAM_CONSTRAINT_DEBUG_ONLY);
 }
 
+/**
+ * Reads a config file into param_set, to be applied later with
+ * ApplyParamSet without reading the file or looking up any names.
+ */
+bool TessBaseAPI::ResolveConfigFile(const char* filename,
+                                    ParamSet* param_set) {
+  if (tesseract_ == NULL) tesseract_ = new Tesseract;
+  return tesseract_->resolve_config_file(
+      filename, SET_PARAM_CONSTRAINT_NON_INIT_ONLY, param_set);
+}
+
+/** Adds a single setting to param_set, as SetVariable would make it. */
+bool TessBaseAPI::ResolveVariable(const char* name, const char* value,
+                                  ParamSet* param_set) {
+  if (tesseract_ == NULL) tesseract_ = new Tesseract;
+  return param_set->Add(name, value, SET_PARAM_CONSTRAINT_NON_INIT_ONLY,
+                        tesseract_->params());
+}
+
+/** Applies all the settings of a ParamSet resolved by the above. */
+void TessBaseAPI::ApplyParamSet(const ParamSet& param_set) {
+  param_set.Apply();
+}
+
 /**
  * Set the current page segmentation mode. Defaults to PSM_AUTO.
  * The mode is stored as an IntParam so it can also be modified by
@@ -507,6 +590,26 @@ void TessBaseAPI::ClearAdaptiveClassifier() {
   tesseract_->ResetDocumentDictionary();
 }
 
+/**
+ * Saves what the adaptive classifier has learned so far to the given
+ * buffer, to be put back later with RestoreAdaptiveClassifier.
+ */
+bool TessBaseAPI::SaveAdaptiveClassifier(GenericVector<char>* data) {
+  if (tesseract_ == NULL)
+    return false;
+  return tesseract_->SaveAdaptiveClassifier(data);
+}
+
+/**
+ * Replaces the state of the adaptive classifier with one saved by
+ * SaveAdaptiveClassifier.
+ */
+bool TessBaseAPI::RestoreAdaptiveClassifier(const GenericVector<char>& data) {
+  if (tesseract_ == NULL)
+    return false;
+  return tesseract_->RestoreAdaptiveClassifier(data);
+}
+
 /**
  * Provide an image for Tesseract to recognize. Format is as
  * TesseractRect above. Does not copy the image buffer, or take
@@ -816,6 +919,13 @@ PageIterator* TessBaseAPI::AnalyseLayout() {
  * internal structures.
  */
 int TessBaseAPI::Recognize(ETEXT_DESC* monitor) {
+  return RecognizeBlocks(monitor, NULL);
+}
+
+// As Recognize, but if block_done is not NULL, the blocks are recognized
+// in turn, and block_done is run with the results of each.
+int TessBaseAPI::RecognizeBlocks(ETEXT_DESC* monitor,
+                                 TessCallback1<PAGE_RES*>* block_done) {
   if (tesseract_ == NULL)
     return -1;
   if (FindLines() != 0)
@@ -874,7 +984,10 @@ int TessBaseAPI::Recognize(ETEXT_DESC* monitor) {
     bool wait_for_text = true;
     GetBoolVariable("paragraph_text_based", &wait_for_text);
     if (!wait_for_text) DetectParagraphs(false);
-    if (tesseract_->recog_all_words(page_res_, monitor, NULL, NULL, 0)) {
+    bool completed = block_done != NULL
+        ? tesseract_->RecogAllBlocksInTurn(page_res_, monitor, block_done)
+        : tesseract_->recog_all_words(page_res_, monitor, NULL, NULL, 0, 0);
+    if (completed) {
       if (wait_for_text) DetectParagraphs(true);
     } else {
       result = -1;
@@ -883,6 +996,129 @@ int TessBaseAPI::Recognize(ETEXT_DESC* monitor) {
   return result;
 }
 
+/**
+ * Starts Recognize of the image by running a closure on executor, and
+ * returns at once with a handle to follow or cancel it.
+ */
+RecognizeHandle* TessBaseAPI::RecognizeAsync(
+    RecognizeExecutor* executor, int timeout_millisec,
+    BlockResultCallback* block_callback, TessClosure* done_callback) {
+  if (tesseract_ == NULL || thresholder_ == NULL || thresholder_->IsEmpty()) {
+    delete block_callback;
+    delete done_callback;
+    return NULL;
+  }
+  RecognizeHandle* handle = new RecognizeHandle(timeout_millisec,
+                                                block_callback, done_callback);
+  executor->Run(NewTessCallback(this, &TessBaseAPI::RunRecognizeHandle,
+                                handle));
+  return handle;
+}
+
+// Runs the recognition started by RecognizeAsync.
+void TessBaseAPI::RunRecognizeHandle(RecognizeHandle* handle) {
+  if (handle->timeout_millisec_ > 0)
+    handle->monitor_->set_deadline_msecs(handle->timeout_millisec_);
+  TessCallback1<PAGE_RES*>* block_done =
+      NewPermanentTessCallback(this, &TessBaseAPI::RecognizeBlockDone, handle);
+  int result = RecognizeBlocks(handle->monitor_, block_done);
+  delete block_done;
+  // The caller may delete the handle as soon as it is done.
+  TessClosure* done_callback = handle->done_callback_;
+  handle->mutex_->Lock();
+  handle->result_ = result;
+  handle->progress_ = 100;
+  handle->done_ = true;
+  handle->mutex_->Unlock();
+  if (done_callback != NULL)
+    done_callback->Run();
+}
+
+// Runs the block callback of the handle with the results of a block.
+void TessBaseAPI::RecognizeBlockDone(RecognizeHandle* handle,
+                                     PAGE_RES* page_res) {
+  if (handle->block_callback_ != NULL) {
+    ResultIterator* it = ResultIterator::StartOfParagraph(LTRResultIterator(
+        page_res, tesseract_,
+        thresholder_->GetScaleFactor(), thresholder_->GetScaledYResolution(),
+        rect_left_, rect_top_, rect_width_, rect_height_));
+    handle->block_callback_->Run(handle->blocks_done(), it);
+    delete it;
+  }
+  handle->mutex_->Lock();
+  ++handle->blocks_done_;
+  handle->mutex_->Unlock();
+}
+
+RecognizeHandle::RecognizeHandle(int timeout_millisec,
+                                 BlockResultCallback* block_callback,
+                                 TessClosure* done_callback)
+  : mutex_(new CCUtilMutex), monitor_(new ETEXT_DESC),
+    block_callback_(block_callback), done_callback_(done_callback),
+    timeout_millisec_(timeout_millisec), cancelled_(false), done_(false),
+    blocks_done_(0), progress_(0), result_(-1) {
+  monitor_->cancel = &RecognizeHandle::CancelFunc;
+  monitor_->cancel_this = this;
+}
+
+RecognizeHandle::~RecognizeHandle() {
+  delete monitor_;
+  delete block_callback_;
+  delete mutex_;
+}
+
+void RecognizeHandle::Cancel() {
+  mutex_->Lock();
+  cancelled_ = true;
+  mutex_->Unlock();
+}
+
+bool RecognizeHandle::cancelled() const {
+  mutex_->Lock();
+  bool result = cancelled_;
+  mutex_->Unlock();
+  return result;
+}
+
+bool RecognizeHandle::done() const {
+  mutex_->Lock();
+  bool result = done_;
+  mutex_->Unlock();
+  return result;
+}
+
+int RecognizeHandle::result() const {
+  mutex_->Lock();
+  int result = result_;
+  mutex_->Unlock();
+  return result;
+}
+
+int RecognizeHandle::blocks_done() const {
+  mutex_->Lock();
+  int result = blocks_done_;
+  mutex_->Unlock();
+  return result;
+}
+
+/** Returns the progress so far as a percentage. */
+int RecognizeHandle::progress() const {
+  mutex_->Lock();
+  int result = progress_;
+  mutex_->Unlock();
+  return result;
+}
+
+// Cancel function of the monitor. Returns true if the handle is cancelled.
+bool RecognizeHandle::CancelFunc(void* handle, int words) {
+  RecognizeHandle* recognize_handle = static_cast<RecognizeHandle*>(handle);
+  recognize_handle->mutex_->Lock();
+  recognize_handle->progress_ = recognize_handle->monitor_->progress;
+  bool result = recognize_handle->cancelled_;
+  recognize_handle->mutex_->Unlock();
+  return result;
+}
+
 /** Tests the chopper by exhaustively running chop_one_blob. */
 int TessBaseAPI::RecognizeForChopTest(ETEXT_DESC* monitor) {
   if (tesseract_ == NULL)
@@ -1152,6 +1388,28 @@ bool TessBaseAPI::ProcessPage(Pix* pix, int page_index, const char* filename,
   PERF_COUNT_START("ProcessPage")
   SetInputName(filename);
   SetImage(pix);
+  bool retry = retry_config != NULL && retry_config[0] != '\0';
+  ParamSet retry_params;
+  if (retry)
+    ResolveConfigFile(retry_config, &retry_params);
+  // If the page may be retried with params that leave the thresholding and
+  // page segmentation alone, threshold it now and keep the results, so
+  // the retry does not have to threshold it again. The binary image is
+  // copied, as layout analysis modifies it.
+  Pix* retry_binary = NULL;
+  Pix* retry_grey = NULL;
+  Pix* retry_thresholds = NULL;
+  if (retry && tesseract_->tessedit_pageseg_mode != PSM_OSD_ONLY &&
+      tesseract_->tessedit_pageseg_mode != PSM_AUTO_ONLY &&
+      !retry_params.Contains(&tesseract_->tessedit_pageseg_mode) &&
+      !retry_params.Contains(&tesseract_->tessedit_reuse_page_threshold)) {
+    Threshold(tesseract_->mutable_pix_binary());
+    retry_binary = pixCopy(NULL, tesseract_->pix_binary());
+    if (tesseract_->pix_grey() != NULL)
+      retry_grey = pixClone(tesseract_->pix_grey());
+    if (tesseract_->pix_thresholds() != NULL)
+      retry_thresholds = pixClone(tesseract_->pix_thresholds());
+  }
   bool failed = false;
   if (timeout_millisec > 0) {
     // Running with a timeout.
@@ -1180,22 +1438,43 @@ bool TessBaseAPI::ProcessPage(Pix* pix, int page_index, const char* filename,
     Pix* page_pix = GetThresholdedImage();
     pixWrite("tessinput.tif", page_pix, IFF_TIFF_G4);
   }
-  if (failed && retry_config != NULL && retry_config[0] != '\0') {
-    // Save current config variables before switching modes.
-    FILE* fp = fopen(kOldVarsFile, "wb");
-    PrintVariables(fp);
-    fclose(fp);
-    // Switch to alternate mode for retry.
-    ReadConfigFile(retry_config);
-    SetImage(pix);
+  if (failed && retry) {
+    // Switch to the alternate mode for the retry, saving only the current
+    // values of the params that it changes, to be restored afterwards.
+    ParamSet saved_params;
+    saved_params.AddCurrentValues(retry_params);
+    ApplyParamSet(retry_params);
+    // Starting over clears the page stats, but the first attempt is still
+    // part of the cost of the page.
+    PageStats first_attempt_stats;
+    GetPageStats(&first_attempt_stats);
+    if (retry_binary != NULL) {
+      ClearResults();
+      *tesseract_->mutable_pix_binary() = retry_binary;
+      tesseract_->set_pix_grey(retry_grey);
+      tesseract_->set_pix_thresholds(retry_thresholds);
+      retry_binary = retry_grey = retry_thresholds = NULL;
+    } else {
+      SetImage(pix);
+    }
+    tesseract_->page_stats.Add(first_attempt_stats);
     Recognize(NULL);
-    // Restore saved config variables.
-    ReadConfigFile(kOldVarsFile);
+    ApplyParamSet(saved_params);
   }
+  pixDestroy(&retry_binary);
+  pixDestroy(&retry_grey);
+  pixDestroy(&retry_thresholds);
 
   if (renderer && !failed) {
+    PageStageTimer timer(tesseract_ != NULL ? &tesseract_->page_stats : NULL,
+                         PAGE_STAGE_RENDERING);
     failed = !renderer->AddImage(this);
   }
+  if (tesseract_->tessedit_dump_page_stats) {
+    char* json = GetPageStatsJSON();
+    tprintf("Page stats %d: %s\n", page_index, json);
+    delete [] json;
+  }
   PERF_COUNT_END
   return !failed;
 }
@@ -1247,23 +1526,44 @@ MutableIterator* TessBaseAPI::GetMutableIterator() {
                              rect_left_, rect_top_, rect_width_, rect_height_);
 }
 
+/**
+ * Appends the output data given to a sink to the STRING str. The data is
+ * '\0' terminated, so the length isn't needed.
+ */
+static void AppendToSTRING(STRING* str, const char* data, int) {
+  *str += data;
+}
+
 /** Make a text string from the internal data structures. */
 char* TessBaseAPI::GetUTF8Text() {
+  STRING text("");
+  TextSinkCallback* sink = NewPermanentTessCallback(&AppendToSTRING, &text);
+  bool ok = GetUTF8Text(sink);
+  delete sink;
+  if (!ok)
+    return NULL;
+  char* result = new char[text.length() + 1];
+  strncpy(result, text.string(), text.length() + 1);
+  return result;
+}
+
+/**
+ * Passes the recognized text to the sink one paragraph at a time, so the
+ * text of the whole page is never held in memory at once.
+ */
+bool TessBaseAPI::GetUTF8Text(TextSinkCallback* sink) {
   if (tesseract_ == NULL ||
       (!recognition_done_ && Recognize(NULL) < 0))
-    return NULL;
-  STRING text("");
+    return false;
   ResultIterator *it = GetIterator();
   do {
     if (it->Empty(RIL_PARA)) continue;
     char *para_text = it->GetUTF8Text(RIL_PARA);
-    text += para_text;
+    sink->Run(para_text, strlen(para_text));
     delete []para_text;
   } while (it->Next(RIL_PARA));
-  char* result = new char[text.length() + 1];
-  strncpy(result, text.string(), text.length() + 1);
   delete it;
-  return result;
+  return true;
 }
 
 /**
@@ -1350,9 +1650,27 @@ static void AddBoxTohOCR(const PageIterator *it,
  * STL removed from original patch submission and refactored by rays.
  */
 char* TessBaseAPI::GetHOCRText(int page_number) {
+  STRING hocr_str("");
+  TextSinkCallback* sink = NewPermanentTessCallback(&AppendToSTRING,
+                                                    &hocr_str);
+  bool ok = GetHOCRText(page_number, sink);
+  delete sink;
+  if (!ok)
+    return NULL;
+  char *ret = new char[hocr_str.length() + 1];
+  strcpy(ret, hocr_str.string());
+  return ret;
+}
+
+/**
+ * Streaming version of GetHOCRText. The markup is built in a small buffer
+ * that is passed to the sink and reused every kOutputChunkSize bytes or so,
+ * instead of building the whole page in one string.
+ */
+bool TessBaseAPI::GetHOCRText(int page_number, TextSinkCallback* sink) {
   if (tesseract_ == NULL ||
       (page_res_ == NULL && Recognize(NULL) < 0))
-    return NULL;
+    return false;
 
   int lcnt = 1, bcnt = 1, pcnt = 1, wcnt = 1;
   int page_id = page_number + 1;  // hOCR uses 1-based page numbers.
@@ -1360,6 +1678,7 @@ char* TessBaseAPI::GetHOCRText(int page_number) {
   GetBoolVariable("hocr_font_info", &font_info);
 
   STRING hocr_str("");
+  hocr_str.ensure(kOutputChunkSize * 2);
 
   if (input_file_ == NULL)
       SetInputName(NULL);
@@ -1494,13 +1813,16 @@ char* TessBaseAPI::GetHOCRText(int page_number) {
       hocr_str += "   </div>\n";
       bcnt++;
     }
+    if (hocr_str.length() >= kOutputChunkSize) {
+      sink->Run(hocr_str.string(), hocr_str.length());
+      hocr_str.truncate_at(0);
+    }
   }
   hocr_str += "  </div>\n";
+  sink->Run(hocr_str.string(), hocr_str.length());
 
-  char *ret = new char[hocr_str.length() + 1];
-  strcpy(ret, hocr_str.string());
   delete res_it;
-  return ret;
+  return true;
 }
 
 /** The 5 numbers output for each box (the usual 4 and a page number.) */
@@ -1726,6 +2048,30 @@ int* TessBaseAPI::AllWordConfidences() {
   return conf;
 }
 
+/**
+ * Copies to stats the time spent in each stage of processing the current
+ * page, and counts of the work done, summed over all the languages.
+ */
+void TessBaseAPI::GetPageStats(PageStats* stats) const {
+  stats->Clear();
+  if (tesseract_ == NULL)
+    return;
+  stats->Add(tesseract_->page_stats);
+  for (int i = 0; i < tesseract_->num_sub_langs(); ++i)
+    stats->Add(tesseract_->get_sub_lang(i)->page_stats);
+}
+
+/** As GetPageStats, but returned as a JSON object. */
+char* TessBaseAPI::GetPageStatsJSON() const {
+  PageStats stats;
+  GetPageStats(&stats);
+  STRING json;
+  stats.ToJSON(&json);
+  char* result = new char[json.length() + 1];
+  strncpy(result, json.string(), json.length() + 1);
+  return result;
+}
+
 /**
  * Applies the given word to the adaptive classifier if possible.
  * The word must be SPACE-DELIMITED UTF-8 - l i k e t h i s , so it can
@@ -1865,6 +2211,27 @@ void TessBaseAPI::End() {
     delete language_;
     language_ = NULL;
   }
+  ClearInitArgs();
+  ClearPrototypeParams();
+  // Return the memory of the objects recycled by this thread to the heap.
+  ReleaseThreadMemory();
+}
+
+/** Deletes the arguments of the last Init kept for InitFromPrototype. */
+void TessBaseAPI::ClearInitArgs() {
+  delete init_configs_;
+  init_configs_ = NULL;
+  delete init_vars_vec_;
+  init_vars_vec_ = NULL;
+  delete init_vars_values_;
+  init_vars_values_ = NULL;
+  init_only_non_debug_params_ = false;
+}
+
+/** Deletes the params copied by InitFromPrototype. */
+void TessBaseAPI::ClearPrototypeParams() {
+  delete prototype_params_;
+  prototype_params_ = NULL;
 }
 
 // Clear any library-level memory caches.
@@ -1874,6 +2241,13 @@ void TessBaseAPI::End() {
 // of these caches.
 void TessBaseAPI::ClearPersistentCache() {
   Dict::GlobalDawgCache()->DeleteUnusedDawgs();
+  Classify::GlobalStaticModelCache()->DeleteUnusedObjects();
+}
+
+// Frees the memory of the small objects that the calling thread keeps for
+// reuse in recognition.
+void TessBaseAPI::ReleaseThreadMemory() {
+  FreeBlockList::ReleaseThreadBlocks();
 }
 
 /**
@@ -1977,6 +2351,12 @@ void TessBaseAPI::Threshold(Pix** pix) {
     // than over-estimate resolution.
     thresholder_->SetSourceYResolution(kMinCredibleResolution);
   }
+  PageStageTimer timer(tesseract_ != NULL ? &tesseract_->page_stats : NULL,
+                       PAGE_STAGE_THRESHOLD);
+  if (tesseract_ != NULL) {
+    thresholder_->SetReusePageThreshold(
+        tesseract_->tessedit_reuse_page_threshold);
+  }
   thresholder_->ThresholdToPix(pix);
   thresholder_->GetImageSizes(&rect_left_, &rect_top_,
                               &rect_width_, &rect_height_,
@@ -2334,7 +2714,7 @@ void TessBaseAPI::AdaptToCharacter(const char *unichar_repr,
 PAGE_RES* TessBaseAPI::RecognitionPass1(BLOCK_LIST* block_list) {
   PAGE_RES *page_res = new PAGE_RES(block_list,
                                     &(tesseract_->prev_word_best_choice_));
-  tesseract_->recog_all_words(page_res, NULL, NULL, NULL, 1);
+  tesseract_->recog_all_words(page_res, NULL, NULL, NULL, 1, 0);
   return page_res;
 }
 
@@ -2343,7 +2723,7 @@ PAGE_RES* TessBaseAPI::RecognitionPass2(BLOCK_LIST* block_list,
   if (!pass1_result)
     pass1_result = new PAGE_RES(block_list,
                                 &(tesseract_->prev_word_best_choice_));
-  tesseract_->recog_all_words(pass1_result, NULL, NULL, NULL, 2);
+  tesseract_->recog_all_words(pass1_result, NULL, NULL, NULL, 2, 0);
   return pass1_result;
 }
 
@@ -73,6 +73,10 @@ class PageIterator;
 class LTRResultIterator;
 class ResultIterator;
 class MutableIterator;
+class PageStats;
+class ParamSet;
+class CCUtilMutex;
+class RecognizeHandle;
 class TessResultRenderer;
 class Tesseract;
 class Trie;
@@ -93,6 +97,17 @@ typedef void (Wordrec::*FillLatticeFunc)(const MATRIX &ratings,
                                          BlamerBundle *blamer_bundle);
 typedef TessCallback4<const UNICHARSET &, int, PageIterator *, Pix *>
     TruthCallback;
+// Receives consecutive pieces of the output of the streaming Get*Text
+// functions. The data is '\0' terminated, and only valid during the call.
+typedef TessCallback2<const char*, int> TextSinkCallback;
+// Runs a closure for RecognizeAsync, on a thread of the caller's choosing,
+// such as one from its own thread pool. The closure deletes itself when run.
+// The executor itself must be a permanent callback.
+typedef TessCallback1<TessClosure*> RecognizeExecutor;
+// Receives the final results of each block as RecognizeAsync finishes it,
+// as the index of the block on the page and an iterator over just that
+// block. The iterator is deleted after the call.
+typedef TessCallback2<int, ResultIterator*> BlockResultCallback;
 
 /**
  * Base class for all tesseract APIs.
@@ -238,6 +253,30 @@ class TESS_API TessBaseAPI {
     return Init(datapath, language, OEM_DEFAULT, NULL, 0, NULL, NULL, false);
   }
 
+  /**
+   * Initializes this instance as a copy of an already initialized prototype,
+   * for building a pool of ready engines to recognize pages in parallel.
+   * The prototype's language, datapath, engine mode, configs and init
+   * variables are used again, and then all its current param values,
+   * including any changed with SetVariable since its Init, are copied.
+   * The language models that are cached globally (dictionaries, static
+   * classifier templates and universal ambiguities) are shared with the
+   * prototype instead of being read again, so this is much faster and
+   * smaller than a full Init. Any previous initialization of this instance
+   * is ended first. The prototype must not be used from another thread
+   * during the call, but it may be destroyed afterwards.
+   * Returns zero on success and -1 on failure.
+   */
+  int InitFromPrototype(const TessBaseAPI& prototype);
+  /**
+   * Returns an instance initialized by InitFromPrototype to the state it
+   * had straight after it, so that it can be handed out of a pool again:
+   * the image and results are cleared, the adaptive classifier and document
+   * dictionary are reset, and the param values are set back to those copied
+   * from the prototype. Nothing is read from disk.
+   */
+  void ResetToPrototype();
+
   /**
    * Returns the languages string used in the last valid initialization.
    * If the last initialization specified "deu+hin" then that will be
@@ -283,6 +322,24 @@ class TESS_API TessBaseAPI {
   void ReadConfigFile(const char* filename);
   /** Same as above, but only set debug params from the given config file. */
   void ReadDebugConfigFile(const char* filename);
+  /**
+   * Reads a config file, found as by ReadConfigFile, into param_set, so that
+   * its settings can be applied repeatedly with ApplyParamSet without
+   * reading the file or looking up any param names again. This makes it
+   * cheap to switch between a few configurations between pages.
+   * As with ReadConfigFile, only non-init params are resolved. The ParamSet
+   * refers to the params of this instance, so it becomes invalid after End.
+   * Returns false if the file could not be read or named unknown params.
+   */
+  bool ResolveConfigFile(const char* filename, ParamSet* param_set);
+  /**
+   * Adds a single setting to param_set, as SetVariable would make it.
+   * Returns false if the param was not found.
+   */
+  bool ResolveVariable(const char* name, const char* value,
+                       ParamSet* param_set);
+  /** Applies all the settings of a ParamSet resolved by the above. */
+  void ApplyParamSet(const ParamSet& param_set);
 
   /**
    * Set the current page segmentation mode. Defaults to PSM_SINGLE_BLOCK.
@@ -321,6 +378,25 @@ class TESS_API TessBaseAPI {
    */
   void ClearAdaptiveClassifier();
 
+  /**
+   * Saves what the adaptive classifier has learned so far to the given
+   * buffer. The buffer may be kept to restore the state later, for
+   * instance to go back to the state after the first few pages of a
+   * document, or passed to another instance initialized with the same
+   * languages, so that it can carry on with the same document without
+   * having to learn the fonts again.
+   * Returns false if there is no adaptive classifier to save.
+   */
+  bool SaveAdaptiveClassifier(GenericVector<char>* data);
+
+  /**
+   * Replaces the state of the adaptive classifier with one saved by
+   * SaveAdaptiveClassifier. The document dictionary is not changed.
+   * Returns false if the buffer does not match the languages of this
+   * instance.
+   */
+  bool RestoreAdaptiveClassifier(const GenericVector<char>& data);
+
   /**
    * @defgroup AdvancedAPI Advanced API
    * The following methods break TesseractRect into pieces, so you can
@@ -363,6 +439,9 @@ class TESS_API TessBaseAPI {
    * Restrict recognition to a sub-rectangle of the image. Call after SetImage.
    * Each SetRectangle clears the recogntion results so multiple rectangles
    * can be recognized with the same image.
+   * Each rectangle is thresholded on its own, unless
+   * tessedit_reuse_page_threshold is set, in which case the whole image is
+   * thresholded once and each rectangle is cut out of it.
    */
   void SetRectangle(int left, int top, int width, int height);
 
@@ -501,6 +580,35 @@ class TESS_API TessBaseAPI {
    */
   int Recognize(ETEXT_DESC* monitor);
 
+  /**
+   * Starts Recognize of the image by running a closure on executor, and
+   * returns at once with a handle to follow or cancel it, or NULL if there
+   * is no image. The blocks of the page are recognized in turn, each through
+   * all the passes, and block_callback, if not NULL, is run with the final
+   * results of each block as soon as it is done, so the first blocks can be
+   * used while the rest are still being recognized. As adaption and font
+   * recognition then only learn from the blocks done so far, the results
+   * may differ slightly from Recognize. Paragraphs are only found once all
+   * the blocks are done, so the iterators given to block_callback have none.
+   * timeout_millisec, if positive, sets a deadline as in ProcessPages,
+   * counted from when the executor starts to run the closure, so time spent
+   * waiting in the queue of the executor does not count.
+   * done_callback, if not NULL, is run once recognition has finished,
+   * whether or not it succeeded.
+   * Ownership: executor stays with the caller and must be a permanent
+   * callback, as it is not deleted and may be used for many pages.
+   * block_callback must be permanent, as it is run once per block, and is
+   * owned and deleted by the handle. done_callback must not be permanent
+   * (made with NewTessCallback), as it is deleted by its own Run. Both are
+   * deleted at once if NULL is returned. The handle must be deleted by the
+   * caller, but not before it is done. This TessBaseAPI must not be used in
+   * any other way until the handle is done.
+   */
+  RecognizeHandle* RecognizeAsync(RecognizeExecutor* executor,
+                                  int timeout_millisec,
+                                  BlockResultCallback* block_callback,
+                                  TessClosure* done_callback);
+
   /**
    * Methods to retrieve information after SetAndThresholdImage(),
    * Recognize() or TesseractRect(). (Recognize is called implicitly if needed.)
@@ -520,7 +628,14 @@ class TESS_API TessBaseAPI {
    * reason.
    *
    * timeout_millisec terminates processing if any single page
-   * takes too long. Set to 0 for unlimited time.
+   * takes too long. Set to 0 for unlimited time. If tessedit_deadline_degrade
+   * is set, less work is done on the words as the timeout comes closer, and
+   * a page that runs out of time is not failed: words reached after the
+   * deadline in pass 1 are still recognized, with all the skippable work
+   * left out, and those reached in pass 2 keep their pass 1 results, so the
+   * page may run a little past the timeout, but no word is lost. Only a
+   * cancel fails the page. LTRResultIterator::WordSkippedWork tells what was
+   * left out of each word.
    *
    * renderer is responible for creating the output. For example,
    * use the TessTextRenderer if you want plaintext output, or
@@ -573,6 +688,11 @@ class TESS_API TessBaseAPI {
    * as UTF8 and must be freed with the delete [] operator.
    */
   char* GetUTF8Text();
+  /**
+   * As GetUTF8Text, but passes the text to sink piece by piece instead of
+   * returning it in one string. Returns false if recognition failed.
+   */
+  bool GetUTF8Text(TextSinkCallback* sink);
 
   /**
    * Make a HTML-formatted string with hOCR markup from the internal
@@ -580,6 +700,12 @@ class TESS_API TessBaseAPI {
    * page_number is 0-based but will appear in the output as 1-based.
    */
   char* GetHOCRText(int page_number);
+  /**
+   * As GetHOCRText, but passes the markup to sink piece by piece, so that the
+   * whole page never has to be held in memory. Returns false if recognition
+   * failed.
+   */
+  bool GetHOCRText(int page_number, TextSinkCallback* sink);
 
   /**
    * The recognized text is returned as a char* which is coded in the same
@@ -605,6 +731,20 @@ class TESS_API TessBaseAPI {
    */
   int* AllWordConfidences();
 
+  /**
+   * Copies to stats the wall and cpu time spent in each stage of processing
+   * the current page, and counts of the work done, summed over all the
+   * languages. The stats are reset whenever the results are cleared, so
+   * they cover the last SetImage/SetRectangle, including any rendering of
+   * the results by ProcessPage.
+   */
+  void GetPageStats(PageStats* stats) const;
+  /**
+   * As GetPageStats, but returned as a JSON object, which must be freed with
+   * the delete [] operator.
+   */
+  char* GetPageStatsJSON() const;
+
   /**
    * Applies the given word to the adaptive classifier if possible.
    * The word must be SPACE-DELIMITED UTF-8 - l i k e t h i s , so it can
@@ -628,6 +768,10 @@ class TESS_API TessBaseAPI {
   /**
    * Close down tesseract and free up all memory. End() is equivalent to
    * destructing and reconstructing your TessBaseAPI.
+   * Small objects used in recognition are recycled per thread. End() frees
+   * those of the calling thread only, and those of other threads, such as
+   * the executor threads of RecognizeAsync, are freed when the thread exits,
+   * or by ReleaseThreadMemory.
    * Once End() has been used, none of the other API functions may be used
    * other than Init and anything declared above it in the class definition.
    */
@@ -642,6 +786,15 @@ class TESS_API TessBaseAPI {
    **/
   static void ClearPersistentCache();
 
+  /**
+   * Frees the memory of the small objects that the calling thread keeps
+   * for reuse in recognition. It is freed anyway when the thread exits,
+   * except on Windows, where a thread that ran recognition, such as an
+   * executor thread of RecognizeAsync, should call this before it exits.
+   * May be called between recognitions, at the cost of new allocations.
+   */
+  static void ReleaseThreadMemory();
+
   /**
    * Check whether a word is valid according to Tesseract's language model
    * @return 0 if the word is invalid, non-zero if valid.
@@ -837,6 +990,11 @@ class TESS_API TessBaseAPI {
   STRING*           language_;        ///< Last initialized language.
   OcrEngineMode last_oem_requested_;  ///< Last ocr language mode requested.
   bool          recognition_done_;   ///< page_res_ contains recognition data.
+  GenericVector<STRING>* init_configs_;  ///< Configs given to the last Init.
+  GenericVector<STRING>* init_vars_vec_;  ///< Variables given to the last Init.
+  GenericVector<STRING>* init_vars_values_;  ///< Values of init_vars_vec_.
+  bool init_only_non_debug_params_;   ///< Last Init's set_only_non_debug_params.
+  ParamSet*     prototype_params_;    ///< Params copied by InitFromPrototype.
   TruthCallback *truth_cb_;           /// fxn for setting truth_* in WERD_RES
 
   /**
@@ -867,8 +1025,78 @@ class TESS_API TessBaseAPI {
                                  int timeout_millisec,
                                  TessResultRenderer* renderer,
                                  int tessedit_page_number);
+  // Deletes the arguments of the last Init kept for InitFromPrototype.
+  void ClearInitArgs();
+  // Deletes the params copied by InitFromPrototype.
+  void ClearPrototypeParams();
+  // As Recognize, but if block_done is not NULL, the blocks are recognized
+  // in turn, and block_done is run with the results of each.
+  int RecognizeBlocks(ETEXT_DESC* monitor,
+                      TessCallback1<PAGE_RES*>* block_done);
+  // Runs the recognition started by RecognizeAsync.
+  void RunRecognizeHandle(RecognizeHandle* handle);
+  // Runs the block callback of the handle with the results of a block.
+  void RecognizeBlockDone(RecognizeHandle* handle, PAGE_RES* page_res);
 };  // class TessBaseAPI.
 
+/**
+ * Follows and controls a recognition started by TessBaseAPI::RecognizeAsync.
+ * The state may be read from any thread while recognition runs.
+ */
+class TESS_API RecognizeHandle {
+ public:
+  ~RecognizeHandle();
+
+  /**
+   * Asks the recognition to stop. It stops before the next word or block
+   * is started, so the delay is bounded by the time taken by one word.
+   * Layout analysis is not interrupted, but recognition stops as soon as it
+   * is done. A cancelled recognition fails, and the blocks that were
+   * finished stay available through the iterators of the TessBaseAPI.
+   */
+  void Cancel();
+  bool cancelled() const;
+  /**
+   * Returns true once recognition has finished. Once it returns true,
+   * result() and the results in the TessBaseAPI are complete.
+   */
+  bool done() const;
+  /** Returns the value returned by Recognize. Only valid once done. */
+  int result() const;
+  /** Returns the number of blocks finished so far. */
+  int blocks_done() const;
+  /** Returns the progress so far as a percentage. */
+  int progress() const;
+
+ private:
+  friend class TessBaseAPI;
+
+  RecognizeHandle(int timeout_millisec, BlockResultCallback* block_callback,
+                  TessClosure* done_callback);
+  // Cancel function of the monitor. Returns true if the handle is cancelled.
+  // Also copies the progress of the monitor, as it runs on the recognizing
+  // thread, which is the only one that writes the monitor.
+  static bool CancelFunc(void* handle, int words);
+
+  // Guards the members below that are shared between threads.
+  CCUtilMutex* mutex_;
+  // The monitor given to the recognition, owned. Only used by the
+  // recognizing thread.
+  ETEXT_DESC* monitor_;
+  // Run with the results of each block. Owned. May be NULL.
+  BlockResultCallback* block_callback_;
+  // Run once when done, which deletes it. May be NULL.
+  TessClosure* done_callback_;
+  // The deadline, which starts when the recognition starts to run, rather
+  // than when it is queued on the executor.
+  int timeout_millisec_;
+  bool cancelled_;
+  bool done_;
+  int blocks_done_;
+  int progress_;
+  int result_;
+};
+
 /** Escape a char string - remove &<>"' with HTML codes. */
 void HOcrEscape(const char* text, STRING& ret);
 }  // namespace tesseract.
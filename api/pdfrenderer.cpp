@@ -21,6 +21,9 @@ namespace tesseract {
 // PDF representation.
 const int kBasicBufSize = 2048;
 
+// Size of the buffer used to copy image files into the PDF.
+const int kFileCopyBufSize = 65536;
+
 // If the font is 10 pts, nominal character width is 5 pts
 const int kCharWidth = 2;
 
@@ -423,13 +426,11 @@ bool TessPDFRenderer::BeginDocumentHandler() {
 // make most of them work without transcoding. If so that's a big win
 // versus what we do now. Try it out.
 bool TessPDFRenderer::fileToPDFObj(char *filename, long int objnum,
-                                   char **pdf_object,
                                    long int *pdf_object_size) {
   char b1[kBasicBufSize];
   char b2[kBasicBufSize];
-  if (!pdf_object_size || !pdf_object)
+  if (!pdf_object_size)
     return false;
-  *pdf_object = NULL;
   *pdf_object_size = 0;
   if (!filename)
     return false;
@@ -469,18 +470,24 @@ bool TessPDFRenderer::fileToPDFObj(char *filename, long int objnum,
       colorspace = "/DeviceRGB";
       break;
     case 4:
-      if (cmyk)
+      if (cmyk) {
         colorspace = "/DeviceCMYK";
-      else
-        return false;
-      break;
+        break;
+      }
+      fclose(fp);
+      return false;
     default:
+      fclose(fp);
       return false;
   }
 
   fseek(fp, 0, SEEK_END);
   long int file_size = ftell(fp);
   fseek(fp, 0, SEEK_SET);
+  if (file_size <= 0) {
+    fclose(fp);
+    return false;
+  }
 
   // IMAGE
   snprintf(b1, sizeof(b1),
@@ -504,27 +511,35 @@ bool TessPDFRenderer::fileToPDFObj(char *filename, long int objnum,
            "endobj\n");
   size_t b2_len = strlen(b2);
 
-  *pdf_object_size = b1_len + file_size + b2_len;
-  *pdf_object = new char[*pdf_object_size];
-  if (!pdf_object)
-    return false;
-  memcpy(*pdf_object, b1, b1_len);
-  if (static_cast<int>(fread(*pdf_object + b1_len, 1, file_size, fp)) !=
-      file_size) {
-    delete[] pdf_object;
-    return false;
+  // The compressed file is already exactly what the PDF wants, so copy it
+  // straight into the output a piece at a time, instead of reading the
+  // whole image into memory first. Once anything has been written there
+  // is no going back, so a short read fails the whole page.
+  AppendData(b1, b1_len);
+  char *buffer = new char[kFileCopyBufSize];
+  long int remaining = file_size;
+  while (remaining > 0) {
+    int chunk = remaining < kFileCopyBufSize ? remaining : kFileCopyBufSize;
+    if (static_cast<int>(fread(buffer, 1, chunk, fp)) != chunk)
+      break;
+    AppendData(buffer, chunk);
+    remaining -= chunk;
   }
-  memcpy(*pdf_object + b1_len + file_size, b2, b2_len);
+  delete[] buffer;
   fclose(fp);
+  if (remaining > 0) {
+    *pdf_object_size = b1_len + file_size - remaining;
+    return false;
+  }
+  AppendData(b2, b2_len);
+  *pdf_object_size = b1_len + file_size + b2_len;
   return true;
 }
 
 bool TessPDFRenderer::pixToPDFObj(TessBaseAPI* api, Pix *pix, long int objnum,
-                                  char **pdf_object,
                                   long int *pdf_object_size) {
-  if (!pdf_object_size || !pdf_object)
+  if (!pdf_object_size)
     return false;
-  *pdf_object = NULL;
   *pdf_object_size = 0;
   char b0[kBasicBufSize];
   char b1[kBasicBufSize * 2];
@@ -555,6 +570,7 @@ bool TessPDFRenderer::pixToPDFObj(TessBaseAPI* api, Pix *pix, long int objnum,
       filter = "/CCITTFaxDecode";
       break;
     default:
+      l_CIDataDestroy(&cid);
       return false;
   }
 
@@ -572,6 +588,7 @@ bool TessPDFRenderer::pixToPDFObj(TessBaseAPI* api, Pix *pix, long int objnum,
         colorspace = "/DeviceRGB";
         break;
       default:
+        l_CIDataDestroy(&cid);
         return false;
     }
   }
@@ -603,13 +620,12 @@ bool TessPDFRenderer::pixToPDFObj(TessBaseAPI* api, Pix *pix, long int objnum,
            "endobj\n");
   size_t b2_len = strlen(b2);
 
+  // Write the compressed data straight from the leptonica buffer.
+  AppendData(b1, b1_len);
+  AppendData(reinterpret_cast<char *>(cid->datacomp), cid->nbytescomp);
+  AppendData(b2, b2_len);
   *pdf_object_size = b1_len + cid->nbytescomp + b2_len;
-  *pdf_object = new char[*pdf_object_size];
-  if (!pdf_object)
-    return false;
-  memcpy(*pdf_object, b1, b1_len);
-  memcpy(*pdf_object + b1_len, cid->datacomp, cid->nbytescomp);
-  memcpy(*pdf_object + b1_len + cid->nbytescomp, b2, b2_len);
+  l_CIDataDestroy(&cid);
 
   return true;
 }
@@ -681,15 +697,15 @@ bool TessPDFRenderer::AddImageHandler(TessBaseAPI* api) {
   objsize += strlen(buf);
   AppendPDFObjectDIY(objsize);
 
-  char *pdf_object;
-  if (!fileToPDFObj(filename, obj_, &pdf_object, &objsize)) {
-    if (!pixToPDFObj(api, pix, obj_, &pdf_object, &objsize)) {
+  // Fall back to transcoding the Pix only if fileToPDFObj has not written
+  // anything yet.
+  if (!fileToPDFObj(filename, obj_, &objsize)) {
+    if (objsize != 0 ||
+        !pixToPDFObj(api, pix, obj_, &objsize)) {
       return false;
     }
   }
-  AppendData(pdf_object, objsize);
   AppendPDFObjectDIY(objsize);
-  delete[] pdf_object;
   return true;
 }
 
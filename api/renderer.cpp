@@ -106,15 +106,12 @@ TessTextRenderer::TessTextRenderer(const char *outputbase)
 }
 
 bool TessTextRenderer::AddImageHandler(TessBaseAPI* api) {
-  char* utf8 = api->GetUTF8Text();
-  if (utf8 == NULL) {
-    return false;
-  }
-
-  AppendString(utf8);
-  delete[] utf8;
+  TextSinkCallback* sink =
+      NewPermanentTessCallback(this, &TessTextRenderer::AppendData);
+  bool ok = api->GetUTF8Text(sink);
+  delete sink;
 
-  return true;
+  return ok;
 }
 
 /**********************************************************************
@@ -163,13 +160,12 @@ bool TessHOcrRenderer::EndDocumentHandler() {
 }
 
 bool TessHOcrRenderer::AddImageHandler(TessBaseAPI* api) {
-  char* hocr = api->GetHOCRText(imagenum());
-  if (hocr == NULL) return false;
+  TextSinkCallback* sink =
+      NewPermanentTessCallback(this, &TessHOcrRenderer::AppendData);
+  bool ok = api->GetHOCRText(imagenum(), sink);
+  delete sink;
 
-  AppendString(hocr);
-  delete[] hocr;
-
-  return true;
+  return ok;
 }
 
 /**********************************************************************
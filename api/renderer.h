@@ -194,13 +194,14 @@ private:
   static char* GetPDFTextObjects(TessBaseAPI* api,
                                  double width, double height,
                                  int page_number);
-  // Attempt to create PFD object from an image without transcoding.
-  static bool fileToPDFObj(char *filename, long int objnum,
-                           char **pdf_object, long int *pdf_object_size);
-  // Turn a Pix into a the very best PDF object that we can.
-  static bool pixToPDFObj(tesseract::TessBaseAPI *api, Pix *pix,
-                          long int objnum,
-                          char **pdf_object, long int *pdf_object_size);
+  // Attempt to write a PDF object for an image file without transcoding,
+  // copying the file straight into the output. If it fails after writing
+  // some of the object, *pdf_object_size is set to the bytes written.
+  bool fileToPDFObj(char *filename, long int objnum,
+                    long int *pdf_object_size);
+  // Turn a Pix into a the very best PDF object that we can, and write it.
+  bool pixToPDFObj(tesseract::TessBaseAPI *api, Pix *pix,
+                   long int objnum, long int *pdf_object_size);
 };
 
 
@@ -154,9 +154,12 @@ bool Tesseract::ProcessTargetWord(const TBOX& word_box,
 }
 
 // If tesseract is to be run, sets the words up ready for it.
+// If defer_setup, the words are only collected, and RecogAllWordsPassN sets
+// each one up just before recognizing it.
 void Tesseract::SetupAllWordsPassN(int pass_n,
                                    const TBOX* target_word_box,
                                    const char* word_config,
+                                   bool defer_setup,
                                    PAGE_RES* page_res,
                                    GenericVector<WordData>* words) {
   // Prepare all the words.
@@ -173,7 +176,8 @@ void Tesseract::SetupAllWordsPassN(int pass_n,
   }
   // Setup all the words for recognition with polygonal approximation.
   for (int w = 0; w < words->size(); ++w) {
-    SetupWordPassN(pass_n, &(*words)[w]);
+    if (!defer_setup)
+      SetupWordPassN(pass_n, &(*words)[w]);
     if (w > 0) (*words)[w].prev_word = &(*words)[w - 1];
   }
 }
@@ -218,36 +222,109 @@ void Tesseract::SetupWordPassN(int pass_n, WordData* word) {
 }
 
 
+// Returns true if the work on the words is to be reduced as the deadline of
+// the monitor comes closer, instead of failing the page when it passes.
+bool Tesseract::DeadlineDegradable(const ETEXT_DESC* monitor) const {
+  return tessedit_deadline_degrade && monitor != NULL &&
+         monitor->msecs_to_deadline() != MAX_INT32;
+}
+
+// Returns the bit mask of SkippedWork to leave out of the next word, given
+// the time that was left to the deadline of the monitor when word
+// recognition started. Nothing is skipped until tessedit_deadline_degrade_at
+// of the time has been used, then adaption and pass 2 are skipped, and after
+// half of the rest of the time chopping and segmentation search as well.
+int Tesseract::DeadlineSkippedWork(const ETEXT_DESC* monitor,
+                                   inT32 budget_msecs) const {
+  if (!DeadlineDegradable(monitor))
+    return SKIP_NONE;
+  double used = 1.0;
+  if (budget_msecs > 0) {
+    used -= static_cast<double>(monitor->msecs_to_deadline()) / budget_msecs;
+  }
+  int skipped_work = SKIP_NONE;
+  if (used >= tessedit_deadline_degrade_at)
+    skipped_work |= SKIP_ADAPTION | SKIP_PASS2;
+  if (used >= (1.0 + tessedit_deadline_degrade_at) / 2)
+    skipped_work |= SKIP_CHOPPING | SKIP_SEGSEARCH;
+  return skipped_work;
+}
+
+// Sets the work to leave out of the next word on this and all the
+// sub-languages.
+void Tesseract::SetSkippedWork(int skipped_work) {
+  skipped_work_ = skipped_work;
+  for (int i = 0; i < sub_langs_.size(); ++i)
+    sub_langs_[i]->skipped_work_ = skipped_work;
+}
+
 // Runs word recognition on all the words.
+// budget_msecs is the time that was left to the deadline of the monitor when
+// word recognition started, by which the work on each word is reduced as
+// the deadline comes closer when DeadlineDegradable. Then only a cancel
+// returns false, and no word is faked out at the deadline.
 bool Tesseract::RecogAllWordsPassN(int pass_n, ETEXT_DESC* monitor,
+                                   inT32 budget_msecs,
                                    GenericVector<WordData>* words) {
   // TODO(rays) Before this loop can be parallelized (it would yield a massive
   // speed-up) all remaining member globals need to be converted to local/heap
   // (eg set_pass1 and set_pass2) and an intermediate adaption pass needs to be
   // added. The results will be significantly different with adaption on, and
   // deterioration will need investigation.
+  bool degradable = DeadlineDegradable(monitor);
   for (int w = 0; w < words->size(); ++w) {
     WordData* word = &(*words)[w];
+    int skipped_work = SKIP_NONE;
     if (monitor != NULL) {
       monitor->ocr_alive = TRUE;
       if (pass_n == 1)
         monitor->progress = 30 + 50 * w / words->size();
       else
         monitor->progress = 80 + 10 * w / words->size();
-      if (monitor->deadline_exceeded() ||
+      bool deadline_passed = monitor->deadline_exceeded();
+      if ((deadline_passed && !degradable) ||
           (monitor->cancel != NULL && (*monitor->cancel)(monitor->cancel_this,
                                                          words->size()))) {
-        // Timeout. Fake out the rest of the words.
+        // Timeout or cancel. Fake out the rest of the words.
+        SetSkippedWork(SKIP_NONE);
         for (; w < words->size(); ++w) {
           (*words)[w].word->SetupFake(unicharset);
         }
         return false;
       }
+      if (deadline_passed && pass_n == 2) {
+        // The rest of the words keep their pass 1 results, as they have
+        // not been set up for pass 2 yet.
+        SetSkippedWork(SKIP_NONE);
+        for (; w < words->size(); ++w) {
+          if (!(*words)[w].word->done)
+            (*words)[w].word->skipped_work |= SKIP_PASS2;
+        }
+        return true;
+      }
+      // Past the deadline in pass 1, the rest of the words still need a
+      // result, so they are recognized with all the work that can be
+      // skipped left out, which DeadlineSkippedWork gives once the budget
+      // is used up.
+      skipped_work = DeadlineSkippedWork(monitor, budget_msecs);
+    }
+    if (pass_n == 2 && degradable) {
+      if ((skipped_work & SKIP_PASS2) && !word->word->done) {
+        // Keep the pass 1 result.
+        word->word->skipped_work |= SKIP_PASS2;
+        continue;
+      }
+      // Deferred by SetupAllWordsPassN, as it discards the pass 1 result.
+      SetupWordPassN(pass_n, word);
     }
     if (word->word->tess_failed) continue;
+    // Pass 2 skipping is dealt with above.
+    skipped_work &= ~SKIP_PASS2;
+    SetSkippedWork(skipped_work);
     WordRecognizer recognizer = pass_n == 1 ? &Tesseract::classify_word_pass1
                                             : &Tesseract::classify_word_pass2;
     classify_word_and_language(recognizer, word);
+    word->word->skipped_work |= skipped_work;
     if (tessedit_dump_choices) {
       word_dumper(NULL, word->row, word->word);
       tprintf("Pass%d: %s [%s]\n", pass_n,
@@ -255,6 +332,7 @@ bool Tesseract::RecogAllWordsPassN(int pass_n, ETEXT_DESC* monitor,
               word->word->best_choice->debug_string().string());
     }
   }
+  SetSkippedWork(SKIP_NONE);
   return true;
 }
 
@@ -277,14 +355,22 @@ bool Tesseract::RecogAllWordsPassN(int pass_n, ETEXT_DESC* monitor,
  * @param word_config word_config file
  * @param target_word_box specifies just to extract a rectangle
  * @param dopasses 0 - all, 1 just pass 1, 2 passes 2 and higher
+ * @param budget_msecs time left to the deadline when the page was started,
+ * or 0 to use the time left now
  */
 
 bool Tesseract::recog_all_words(PAGE_RES* page_res,
                                 ETEXT_DESC* monitor,
                                 const TBOX* target_word_box,
                                 const char* word_config,
-                                int dopasses) {
+                                int dopasses,
+                                inT32 budget_msecs) {
   PAGE_RES_IT page_res_it(page_res);
+  // The time left for word recognition, for DeadlineSkippedWork.
+  if (budget_msecs == 0) {
+    budget_msecs = monitor != NULL ? monitor->msecs_to_deadline()
+                                   : MAX_INT32;
+  }
 
   if (tessedit_minimal_rej_pass1) {
     tessedit_test_adaption.set_value (TRUE);
@@ -292,6 +378,7 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
   }
 
   if (dopasses==0 || dopasses==1) {
+    PageStageTimer timer(&page_stats, PAGE_STAGE_PASS1);
     page_res_it.restart_page();
     // ****************** Pass 1 *******************
 
@@ -310,7 +397,8 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
     // Set up all words ready for recognition, so that if parallelism is on
     // all the input and output classes are ready to run the classifier.
     GenericVector<WordData> words;
-    SetupAllWordsPassN(1, target_word_box, word_config, page_res, &words);
+    SetupAllWordsPassN(1, target_word_box, word_config, false, page_res,
+                       &words);
     if (tessedit_parallelize) {
       PrerecAllWordsPar(words);
     }
@@ -326,7 +414,7 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
 
     most_recently_used_ = this;
     // Run pass 1 word recognition.
-    if (!RecogAllWordsPassN(1, monitor, &words)) return false;
+    if (!RecogAllWordsPassN(1, monitor, budget_msecs, &words)) return false;
     // Pass 1 post-processing.
     while (page_res_it.word() != NULL) {
       if (page_res_it.word()->word->flag(W_REP_CHAR)) {
@@ -355,15 +443,22 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
 
   // ****************** Pass 2 *******************
   if (tessedit_tess_adaption_mode != 0x0 && !tessedit_test_adaption) {
+    PageStageTimer timer(&page_stats, PAGE_STAGE_PASS2);
     page_res_it.restart_page();
     GenericVector<WordData> words;
-    SetupAllWordsPassN(2, target_word_box, word_config, page_res, &words);
-    if (tessedit_parallelize) {
+    // When degrading near a deadline, each word is set up only when it is
+    // reached, so that the words that are not reached keep their pass 1
+    // results. The price is that pass 2 is not pre-classified in parallel,
+    // on every page that has a deadline, however far away it is.
+    bool defer_setup = DeadlineDegradable(monitor);
+    SetupAllWordsPassN(2, target_word_box, word_config, defer_setup, page_res,
+                       &words);
+    if (tessedit_parallelize && !defer_setup) {
       PrerecAllWordsPar(words);
     }
     most_recently_used_ = this;
     // Run pass 2 word recognition.
-    if (!RecogAllWordsPassN(2, monitor, &words)) return false;
+    if (!RecogAllWordsPassN(2, monitor, budget_msecs, &words)) return false;
     // Pass 2 post-processing.
     while (page_res_it.word() != NULL) {
       WERD_RES* word = page_res_it.word();
@@ -392,7 +487,10 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
     if (tessedit_enable_bigram_correction) bigram_correction_pass(page_res);
 
     // ****************** Pass 5,6 *******************
-    rejection_passes(page_res, monitor, target_word_box, word_config);
+    {
+      PageStageTimer timer(&page_stats, PAGE_STAGE_REJECTION);
+      rejection_passes(page_res, monitor, target_word_box, word_config);
+    }
 
     // ****************** Pass 7 *******************
     // Cube combiner.
@@ -424,12 +522,15 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
       static_cast<int>(tessedit_pageseg_mode));
   textord_.CleanupSingleRowResult(pageseg_mode, page_res);
 
-  // Remove empty words, as these mess up the result iterators.
+  // Remove empty words, as these mess up the result iterators. The words are
+  // final now, so in lean mode all that the iterators don't need is freed.
   for (page_res_it.restart_page(); page_res_it.word() != NULL;
        page_res_it.forward()) {
     WERD_RES* word = page_res_it.word();
     if (word->best_choice == NULL || word->best_choice->length() == 0)
       page_res_it.DeleteCurrentWord();
+    else if (tessedit_lean_results)
+      word->ClearIntermediateResults();
   }
 
   if (monitor != NULL) {
@@ -438,6 +539,69 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
   return true;
 }
 
+// Runs recog_all_words on each block of the page_res in turn, instead of on
+// the whole page at once, and runs block_done, if not NULL, with a page
+// holding just that block as soon as its results are final. Adaption and
+// font recognition only learn from the blocks done so far, so the results
+// may differ from recog_all_words. The progress of the monitor counts the
+// blocks done, and cancellation is also checked between blocks.
+// Returns false if cancelled or timed out, in which case the page_res
+// keeps only the blocks that were reached. When DeadlineDegradable, the
+// deadline passing does not stop the page, just as in recog_all_words.
+bool Tesseract::RecogAllBlocksInTurn(PAGE_RES* page_res, ETEXT_DESC* monitor,
+                                     TessCallback1<PAGE_RES*>* block_done) {
+  BLOCK_RES_LIST done_blocks;
+  BLOCK_RES_IT done_it(&done_blocks);
+  int num_blocks = page_res->block_res_list.length();
+  // All the blocks measure the time used against the budget of the page, so
+  // that the work is reduced across the page as the deadline comes closer.
+  inT32 budget_msecs = monitor != NULL ? monitor->msecs_to_deadline()
+                                       : MAX_INT32;
+  bool completed = true;
+  for (int b = 0; b < num_blocks && completed; ++b) {
+    // Each block gets a copy of the monitor with the same deadline and
+    // cancel function, so that its own progress does not show in the
+    // progress of the page.
+    ETEXT_DESC block_monitor;
+    if (monitor != NULL) {
+      monitor->ocr_alive = TRUE;
+      monitor->progress = 30 + 70 * b / num_blocks;
+      // When degrading, the blocks after the deadline are still run, and
+      // recog_all_words gives their words the full skip mask, so only a
+      // cancel stops the page, as it would in recog_all_words.
+      if ((monitor->deadline_exceeded() && !DeadlineDegradable(monitor)) ||
+          (monitor->cancel != NULL &&
+           (*monitor->cancel)(monitor->cancel_this, stats_.dict_words))) {
+        completed = false;
+        break;
+      }
+      block_monitor = *monitor;
+    }
+    PAGE_RES block_page;
+    block_page.prev_word_best_choice = page_res->prev_word_best_choice;
+    BLOCK_RES_IT block_it(&page_res->block_res_list);
+    BLOCK_RES_IT(&block_page.block_res_list).add_to_end(block_it.extract());
+    completed = recog_all_words(&block_page,
+                                monitor != NULL ? &block_monitor : NULL,
+                                NULL, NULL, 0, budget_msecs);
+    page_res->char_count += block_page.char_count;
+    page_res->rej_count += block_page.rej_count;
+    for (int i = 0; i < block_page.blame_reasons.size(); ++i)
+      page_res->blame_reasons[i] += block_page.blame_reasons[i];
+    page_res->misadaption_log += block_page.misadaption_log;
+    if (completed && block_done != NULL)
+      block_done->Run(&block_page);
+    done_it.move_to_last();
+    done_it.add_list_after(&block_page.block_res_list);
+  }
+  // The blocks that were not reached are dropped, as they have no results.
+  page_res->block_res_list.clear();
+  BLOCK_RES_IT(&page_res->block_res_list).add_list_after(&done_blocks);
+  if (monitor != NULL && completed)
+    monitor->progress = 100;
+  return completed;
+}
+
 void Tesseract::bigram_correction_pass(PAGE_RES *page_res) {
   PAGE_RES_IT word_it(page_res);
 
@@ -933,10 +1097,12 @@ void Tesseract::classify_word_pass1(WordData* word_data, WERD_RES* word) {
   match_word_pass_n(1, word, row, block);
   if (!word->tess_failed && !word->word->flag(W_REP_CHAR)) {
     word->tess_would_adapt = AdaptableWord(word);
-    bool adapt_ok = word_adaptable(word, tessedit_tess_adaption_mode);
+    bool adapt_ok = !(skipped_work_ & SKIP_ADAPTION) &&
+                    word_adaptable(word, tessedit_tess_adaption_mode);
 
     if (adapt_ok) {
       // Send word to adaptive classifier for training.
+      PageStageTimer timer(&page_stats, PAGE_STAGE_ADAPTION);
       word->BestChoiceToCorrectText();
       LearnWord(NULL, word);
       // Mark misadaptions if running blamer.
@@ -391,6 +391,9 @@ int EquationDetect::FindEquationParts(
     GetOutputTiffName("_bi", &outfile);
     pixWrite(outfile.string(), lang_tesseract_->pix_binary(), IFF_TIFF_G4);
   }
+  // The foreground density of many boxes is needed below, so count the
+  // pixels of the page once up front.
+  pixel_counts_.Init(lang_tesseract_->pix_binary());
 
   // Pass 0: Compute special text type for blobs.
   IdentifySpecialText();
@@ -432,6 +435,7 @@ int EquationDetect::FindEquationParts(
     GetOutputTiffName("_merged", &outfile);
     PaintColParts(outfile);
   }
+  pixel_counts_.Clear();
 
   return 0;
 }
@@ -624,22 +628,7 @@ void EquationDetect::IdentifySeedParts() {
 }
 
 float EquationDetect::ComputeForegroundDensity(const TBOX& tbox) {
-#if LIBLEPT_MINOR_VERSION < 69 && LIBLEPT_MAJOR_VERSION <= 1
-  // This will disable the detector because no seed will be identified.
-  return 1.0f;
-#else
-  Pix *pix_bi = lang_tesseract_->pix_binary();
-  int pix_height = pixGetHeight(pix_bi);
-  Box* box = boxCreate(tbox.left(), pix_height - tbox.top(),
-                       tbox.width(), tbox.height());
-  Pix *pix_sub = pixClipRectangle(pix_bi, box, NULL);
-  l_float32 fract;
-  pixForegroundFraction(pix_sub, &fract);
-  pixDestroy(&pix_sub);
-  boxDestroy(&box);
-
-  return fract;
-#endif
+  return pixel_counts_.ForegroundFraction(tbox);
 }
 
 bool EquationDetect::CheckSeedFgDensity(const float density_th,
@@ -23,6 +23,7 @@
 #include "blobbox.h"
 #include "equationdetectbase.h"
 #include "genericvector.h"
+#include "pixcount.h"
 #include "unichar.h"
 
 class BLOBNBOX;
@@ -268,6 +269,10 @@ class EquationDetect : public EquationDetectBase {
   // The resolution (dpi) of the processing image.
   int resolution_;
 
+  // Black pixel counts of lang_tesseract_->pix_binary(), for
+  // ComputeForegroundDensity. Only valid during FindEquationParts.
+  PixelCountTable pixel_counts_;
+
   // The number of pages we have processed.
   int page_count_;
 };
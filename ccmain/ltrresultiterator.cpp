@@ -219,6 +219,13 @@ bool LTRResultIterator::WordIsNumeric() const {
   return permuter == NUMBER_PERM;
 }
 
+// Returns the bit mask of SkippedWork that was left out of the recognition
+// of the current word to meet a deadline.
+int LTRResultIterator::WordSkippedWork() const {
+  if (it_->word() == NULL) return SKIP_NONE;  // Already at the end!
+  return it_->word()->skipped_work;
+}
+
 // Returns true if the word contains blamer information.
 bool LTRResultIterator::HasBlamerInfo() const {
   return it_->word() != NULL && it_->word()->blamer_bundle != NULL &&
@@ -123,6 +123,10 @@ class TESS_API LTRResultIterator : public PageIterator {
   // Returns true if the current word is numeric.
   bool WordIsNumeric() const;
 
+  // Returns the bit mask of SkippedWork (see publictypes.h) that was left
+  // out of the recognition of the current word to meet a deadline.
+  int WordSkippedWork() const;
+
   // Returns true if the word contains blamer information.
   bool HasBlamerInfo() const;
 
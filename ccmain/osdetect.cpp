@@ -33,8 +33,15 @@
 #include "tesseractclass.h"
 #include "textord.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 const int kMinCharactersToTry = 50;
 const int kMaxCharactersToTry = 5 * kMinCharactersToTry;
+// Number of blobs classified together, in parallel if possible, before their
+// scores are added to the detectors and the stopping criteria tested.
+const int kOSDBatchSize = 16;
 
 const float kSizeRatioToReject = 2.0;
 const int kMinAcceptableBlobHeight = 10;
@@ -46,6 +53,10 @@ const float kHanRatioInKorean = 0.7;
 const float kHanRatioInJapanese = 0.3;
 
 const float kNonAmbiguousMargin = 1.0;
+// Multiple of min_orientation_margin (the margin between the best and second
+// best orientation scores that pagesegmain.cpp requires before it accepts an
+// orientation at all) beyond which no more blobs need be tried.
+const float kOrientationStopFactor = 2.0;
 
 // General scripts
 static const char* han_script = "Han";
@@ -279,7 +290,7 @@ int os_detect_blobs(const GenericVector<int>* allowed_scripts,
     osr = &osr_;
 
   osr->unicharset = &tess->unicharset;
-  OrientationDetector o(allowed_scripts, osr);
+  OrientationDetector o(allowed_scripts, osr, tess);
   ScriptDetector s(allowed_scripts, osr, tess);
 
   BLOBNBOX_C_IT filtered_it(blob_list);
@@ -301,15 +312,40 @@ int os_detect_blobs(const GenericVector<int>* allowed_scripts,
     blobs[number_of_blobs++] = (BLOBNBOX*)filtered_it.data();
   }
   QRSequenceGenerator sequence(number_of_blobs);
+  BLOBNBOX** ordered_blobs = new BLOBNBOX*[real_max];
+  for (int i = 0; i < real_max; ++i)
+    ordered_blobs[i] = blobs[sequence.GetVal()];
+  delete [] blobs;
+
+  tess->tess_cn_matching.set_value(true); // turn it on
+  tess->tess_bn_matching.set_value(false);
+  // The blobs of a batch are classified independently of each other, so they
+  // may be done in parallel, but their scores are added to the detectors in
+  // the original order, so the result does not depend on the thread count.
+  // The stopping criteria are tested after every blob as before, and the rest
+  // of a batch is discarded once they are met.
+  BLOB_CHOICE_LIST (*ratings)[4] = new BLOB_CHOICE_LIST[kOSDBatchSize][4];
   int num_blobs_evaluated = 0;
-  for (int i = 0; i < real_max; ++i) {
-    if (os_detect_blob(blobs[sequence.GetVal()], &o, &s, osr, tess)
-        && i > kMinCharactersToTry) {
-      break;
+  bool stop = false;
+  for (int start = 0; start < real_max && !stop; start += kOSDBatchSize) {
+    int batch_size = MIN(kOSDBatchSize, real_max - start);
+    #pragma omp parallel for schedule(dynamic, 1) if (batch_size > 1)
+    for (int b = 0; b < batch_size; ++b)
+      os_classify_blob(ordered_blobs[start + b], tess, ratings[b]);
+    for (int b = 0; b < batch_size; ++b) {
+      int i = start + b;
+      if (!stop) {
+        stop = os_accumulate_blob(ratings[b], &o, &s) &&
+               i > kMinCharactersToTry;
+        if (!stop)
+          ++num_blobs_evaluated;
+      }
+      for (int r = 0; r < 4; ++r)
+        ratings[b][r].clear();
     }
-    ++num_blobs_evaluated;
   }
-  delete [] blobs;
+  delete [] ratings;
+  delete [] ordered_blobs;
 
   // Make sure the best_result is up-to-date
   int orientation = o.get_orientation();
@@ -325,12 +361,23 @@ bool os_detect_blob(BLOBNBOX* bbox, OrientationDetector* o,
                     tesseract::Tesseract* tess) {
   tess->tess_cn_matching.set_value(true); // turn it on
   tess->tess_bn_matching.set_value(false);
+  BLOB_CHOICE_LIST ratings[4];
+  os_classify_blob(bbox, tess, ratings);
+  return os_accumulate_blob(ratings, o, s);
+}
+
+// Classifies a single blob in each of the 4 orientations, putting the
+// results in ratings[0..3]. The caller must have set tess_cn_matching, as
+// the parameters must not be changed while other threads are classifying.
+// Only the static classifier is used, so it is safe to call this
+// concurrently for different blobs with the same Tesseract.
+void os_classify_blob(BLOBNBOX* bbox, tesseract::Tesseract* tess,
+                      BLOB_CHOICE_LIST* ratings) {
   C_BLOB* blob = bbox->cblob();
   TBLOB* tblob = TBLOB::PolygonalCopy(tess->poly_allow_detailed_fx, blob);
   TBOX box = tblob->bounding_box();
   FCOORD current_rotation(1.0f, 0.0f);
   FCOORD rotation90(0.0f, 1.0f);
-  BLOB_CHOICE_LIST ratings[4];
   // Test the 4 orientations
   for (int i = 0; i < 4; ++i) {
     // Normalize the blob. Set the origin to the place we want to be the
@@ -357,7 +404,13 @@ bool os_detect_blob(BLOBNBOX* bbox, OrientationDetector* o,
     current_rotation.rotate(rotation90);
   }
   delete tblob;
+}
 
+// Adds the ratings of a blob from os_classify_blob to the estimates of
+// orientation and script. Returns true if the estimate now satisfies the
+// stopping criteria.
+bool os_accumulate_blob(BLOB_CHOICE_LIST* ratings, OrientationDetector* o,
+                        ScriptDetector* s) {
   bool stop = o->detect_blob(ratings);
   s->detect_blob(ratings);
   int orientation = o->get_orientation();
@@ -367,8 +420,10 @@ bool os_detect_blob(BLOBNBOX* bbox, OrientationDetector* o,
 
 
 OrientationDetector::OrientationDetector(
-    const GenericVector<int>* allowed_scripts, OSResults* osr) {
+    const GenericVector<int>* allowed_scripts, OSResults* osr,
+    tesseract::Tesseract* tess) {
   osr_ = osr;
+  tess_ = tess;
   allowed_scripts_ = allowed_scripts;
 }
 
@@ -434,9 +489,10 @@ bool OrientationDetector::detect_blob(BLOB_CHOICE_LIST* scores) {
     osr_->orientations[i] += log(blob_o_score[i] / total_blob_o_score);
   }
 
-  // TODO(ranjith) Add an early exit test, based on min_orientation_margin,
-  // as used in pagesegmain.cpp.
-  return false;
+  // Stop once the best orientation is well clear of the second best.
+  osr_->update_best_orientation();
+  return osr_->best_result.oconfidence >
+      tess_->min_orientation_margin * kOrientationStopFactor;
 }
 
 int OrientationDetector::get_orientation() {
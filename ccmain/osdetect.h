@@ -82,7 +82,7 @@ struct OSResults {
 class OrientationDetector {
  public:
   OrientationDetector(const GenericVector<int>* allowed_scripts,
-                      OSResults* results);
+                      OSResults* results, tesseract::Tesseract* tess);
   bool detect_blob(BLOB_CHOICE_LIST* scores);
   int get_orientation();
  private:
@@ -131,6 +131,16 @@ bool os_detect_blob(BLOBNBOX* bbox, OrientationDetector* o,
                     ScriptDetector* s, OSResults*,
                     tesseract::Tesseract* tess);
 
+// Classifies a single blob in each of the 4 orientations, putting the
+// results in ratings[0..3]. Safe to call concurrently for different blobs.
+void os_classify_blob(BLOBNBOX* bbox, tesseract::Tesseract* tess,
+                      BLOB_CHOICE_LIST* ratings);
+
+// Adds the ratings of a blob to the orientation and script estimates.
+// Returns true if the estimate now satisfies the stopping criteria.
+bool os_accumulate_blob(BLOB_CHOICE_LIST* ratings, OrientationDetector* o,
+                        ScriptDetector* s);
+
 // Helper method to convert an orientation index to its value in degrees.
 // The value represents the amount of clockwise rotation in degrees that must be
 // applied for the text to be upright (readable).
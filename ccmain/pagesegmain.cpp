@@ -169,6 +169,7 @@ int Tesseract::SegmentPage(const STRING* input_file, BLOCK_LIST* blocks,
       pageseg_devanagari_split_strategy != ShiroRekhaSplitter::NO_SPLIT;
   bool cjk_mode = textord_use_cjk_fp_model;
 
+  PageStageTimer timer(&page_stats, PAGE_STAGE_TEXTLINES);
   textord_.TextordPage(pageseg_mode, reskew_, width, height, pix_binary_,
                        pix_thresholds_, pix_grey_, splitting || cjk_mode,
                        blocks, &to_blocks);
@@ -247,6 +248,7 @@ int Tesseract::AutoPageSeg(PageSegMode pageseg_mode,
     if (equ_detect_) {
       finder->SetEquationDetect(equ_detect_);
     }
+    PageStageTimer timer(&page_stats, PAGE_STAGE_LAYOUT);
     result = finder->FindBlocks(pageseg_mode, scaled_color_, scaled_factor_,
                                 to_block, photomask_pix,
                                 pix_thresholds_, pix_grey_,
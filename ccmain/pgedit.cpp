@@ -417,7 +417,7 @@ BOOL8 Tesseract::process_cmd_win_event(                 // UI command semantics
     case SHOW_SMALLCAPS_CMD_EVENT:
     case SHOW_DROPCAPS_CMD_EVENT:
       if (!recog_done) {
-        recog_all_words(current_page_res, NULL, NULL, NULL, 0);
+        recog_all_words(current_page_res, NULL, NULL, NULL, 0, 0);
         recog_done = true;
       }
       break;
@@ -641,7 +641,8 @@ void Tesseract::process_image_event( // action in image win
  */
 void Tesseract::debug_word(PAGE_RES* page_res, const TBOX &selection_box) {
   ResetAdaptiveClassifier();
-  recog_all_words(page_res, NULL, &selection_box, word_config_.string(), 0);
+  recog_all_words(page_res, NULL, &selection_box, word_config_.string(), 0,
+                  0);
 }
 }  // namespace tesseract
 
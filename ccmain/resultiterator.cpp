@@ -655,9 +655,8 @@ void ResultIterator::AppendUTF8ParagraphText(STRING *text) const {
 
 bool ResultIterator::BidiDebug(int min_level) const {
   int debug_level = 1;
-  IntParam *p = ParamUtils::FindParam<IntParam>(
-      "bidi_debug", GlobalParams()->int_params,
-      tesseract_->params()->int_params);
+  IntParam *p = ParamUtils::FindParam<IntParam>("bidi_debug",
+                                                tesseract_->params());
   if (p != NULL) debug_level = (inT32)(*p);
   return debug_level >= min_level;
 }
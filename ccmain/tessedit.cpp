@@ -49,6 +49,23 @@ namespace tesseract {
 // and also accepts a relative or absolute path name.
 void Tesseract::read_config_file(const char *filename,
                                  SetParamConstraint constraint) {
+  STRING path = config_file_path(filename);
+  ParamUtils::ReadParamsFile(path.string(), constraint, this->params());
+}
+
+// Resolves the settings of a config file, found in the same places as by
+// read_config_file, into param_set, to be applied later without reading
+// the file again. Returns false if the file named any unknown params.
+bool Tesseract::resolve_config_file(const char *filename,
+                                    SetParamConstraint constraint,
+                                    ParamSet *param_set) {
+  STRING path = config_file_path(filename);
+  return param_set->AddFile(path.string(), constraint, this->params());
+}
+
+// Returns the path of the given config file, looking in the configs and
+// tessconfigs directories of the datadir before using the name as given.
+STRING Tesseract::config_file_path(const char *filename) const {
   STRING path = datadir;
   path += "configs/";
   path += filename;
@@ -65,7 +82,7 @@ void Tesseract::read_config_file(const char *filename,
       path = filename;
     }
   }
-  ParamUtils::ReadParamsFile(path.string(), constraint, this->params());
+  return path;
 }
 
 // Returns false if a unicharset file for the specified language was not found
@@ -180,17 +197,44 @@ bool Tesseract::init_tesseract_lang_data(
   UNICHARSET encoder_unicharset;
   encoder_unicharset.CopyFrom(unicharset);
   unichar_ambigs.InitUnicharAmbigs(unicharset, use_ambigs_for_adaption);
-  unichar_ambigs.LoadUniversal(encoder_unicharset, &unicharset);
-
-  if (!tessedit_ambigs_training &&
-      tessdata_manager.SeekToStart(TESSDATA_AMBIGS)) {
-    TFile ambigs_file;
-    ambigs_file.Open(tessdata_manager.GetDataFilePtr(),
-                     tessdata_manager.GetEndOffset(TESSDATA_AMBIGS) + 1);
-    unichar_ambigs.LoadUnicharAmbigs(
-        encoder_unicharset,
-        &ambigs_file,
-        ambigs_debug_level, use_ambigs_for_adaption, &unicharset);
+  TFile ambigs_file;
+  bool have_ambigs = tessdata_manager.SeekToStart(TESSDATA_AMBIGS) &&
+      ambigs_file.Open(tessdata_manager.GetDataFilePtr(),
+                       tessdata_manager.GetEndOffset(TESSDATA_AMBIGS) + 1);
+  // Use the precompiled ambigs if there are any, and they were compiled
+  // from the same unicharset and ambigs as the ones loaded, which saves
+  // parsing the text of the ambigs.
+  CompiledAmbigs universal_ambigs;
+  CompiledAmbigs lang_ambigs;
+  bool use_compiled = false;
+  if (tessdata_manager.SeekToStart(TESSDATA_COMPILED_AMBIGS)) {
+    FILE* fp = tessdata_manager.GetDataFilePtr();
+    bool swap = tessdata_manager.swap();
+    use_compiled = universal_ambigs.DeSerialize(swap, fp) &&
+        lang_ambigs.DeSerialize(swap, fp) &&
+        universal_ambigs.signature() ==
+            UnicharAmbigs::UniversalSignature(encoder_unicharset) &&
+        lang_ambigs.signature() == CompiledAmbigs::Signature(
+            encoder_unicharset, have_ambigs ? &ambigs_file : NULL);
+    if (tessdata_manager_debug_level) {
+      tprintf("%s compiled ambigs\n", use_compiled ? "Using" : "Ignoring");
+    }
+  }
+  if (use_compiled)
+    unichar_ambigs.AddCompiledAmbigs(universal_ambigs, 0, false, &unicharset);
+  else
+    unichar_ambigs.LoadUniversal(encoder_unicharset, &unicharset);
+
+  if (!tessedit_ambigs_training && have_ambigs) {
+    if (use_compiled) {
+      unichar_ambigs.AddCompiledAmbigs(lang_ambigs, ambigs_debug_level,
+                                       use_ambigs_for_adaption, &unicharset);
+    } else {
+      unichar_ambigs.LoadUnicharAmbigs(
+          encoder_unicharset,
+          &ambigs_file,
+          ambigs_debug_level, use_ambigs_for_adaption, &unicharset);
+    }
     if (tessdata_manager_debug_level) tprintf("Loaded ambigs\n");
   }
 
@@ -20,6 +20,8 @@
 
 #include "tesseractclass.h"
 
+#include <string.h>
+
 #include "allheaders.h"
 #include "cube_reco_context.h"
 #include "edgblob.h"
@@ -48,6 +50,27 @@ Tesseract::Tesseract()
     BOOL_MEMBER(tessedit_dump_pageseg_images, false,
                "Dump intermediate images made during page segmentation",
                this->params()),
+    BOOL_MEMBER(tessedit_dump_page_stats, false,
+                "Print the stage times and work counts of each page as JSON",
+                this->params()),
+    BOOL_MEMBER(tessedit_deadline_degrade, false,
+                "Near the deadline of a timeout, skip expensive work on the"
+                " remaining words and keep the results instead of failing."
+                " Pass 2 then sets up each word only when it is reached, so"
+                " tessedit_parallelize no longer pre-classifies pass 2",
+                this->params()),
+    double_MEMBER(tessedit_deadline_degrade_at, 0.5,
+                  "Fraction of the word recognition time budget after which"
+                  " work is skipped",
+                  this->params()),
+    BOOL_MEMBER(tessedit_lean_results, false,
+                "Free the ratings, alternative choices and segmentation of each"
+                " word once it is final, keeping only what the iterators use",
+                this->params()),
+    BOOL_MEMBER(tessedit_reuse_page_threshold, false,
+                "Threshold the whole image once per SetImage and cut each"
+                " SetRectangle out of it, instead of thresholding each one",
+                this->params()),
     // The default for pageseg_mode is the old behaviour, so as not to
     // upset anything that relies on that.
     INT_MEMBER(tessedit_pageseg_mode, PSM_SINGLE_BLOCK,
@@ -544,6 +567,8 @@ void Tesseract::Clear() {
   reskew_ = FCOORD(1.0f, 0.0f);
   splitter_.Clear();
   scaled_factor_ = -1;
+  page_stats.Clear();
+  ClearStaticResultCache();
   for (int i = 0; i < sub_langs_.size(); ++i)
     sub_langs_[i]->Clear();
 }
@@ -561,6 +586,67 @@ void Tesseract::ResetAdaptiveClassifier() {
   }
 }
 
+// Saves the state of the adaptive classifier of this and all subclassifiers
+// to the given buffer, as the size and contents of the state of each in turn.
+bool Tesseract::SaveAdaptiveClassifier(GenericVector<char>* data) {
+  data->truncate(0);
+  GenericVector<char> state;
+  for (int i = 0; i <= sub_langs_.size(); ++i) {
+    Tesseract* lang_tess = i == 0 ? this : sub_langs_[i - 1];
+    if (!lang_tess->SaveAdaptiveClassifierInternal(&state))
+      return false;
+    inT32 size = state.size();
+    const char* size_bytes = reinterpret_cast<const char*>(&size);
+    data->reserve(data->size() + sizeof(size) + size);
+    for (int b = 0; b < static_cast<int>(sizeof(size)); ++b)
+      data->push_back(size_bytes[b]);
+    for (int b = 0; b < size; ++b)
+      data->push_back(state[b]);
+  }
+  return true;
+}
+
+// Restores the state saved by SaveAdaptiveClassifier into an instance
+// initialized with the same languages. Every language is read before any
+// is replaced, so on failure the instance is left unchanged.
+bool Tesseract::RestoreAdaptiveClassifier(const GenericVector<char>& data) {
+  GenericVector<ADAPT_TEMPLATES> templates;
+  GenericVector<char> state;
+  int offset = 0;
+  bool ok = true;
+  for (int i = 0; ok && i <= sub_langs_.size(); ++i) {
+    Tesseract* lang_tess = i == 0 ? this : sub_langs_[i - 1];
+    inT32 size;
+    ok = lang_tess->AdaptedTemplates != NULL &&
+        offset + static_cast<int>(sizeof(size)) <= data.size();
+    if (!ok) break;
+    memcpy(&size, &data[offset], sizeof(size));
+    offset += sizeof(size);
+    ok = size >= 0 && size <= data.size() - offset;
+    if (!ok) break;
+    state.init_to_size(size, 0);
+    if (size > 0)
+      memcpy(&state[0], &data[offset], size);
+    offset += size;
+    ADAPT_TEMPLATES lang_templates =
+        lang_tess->DeSerializeAdaptedTemplates(state);
+    ok = lang_templates != NULL;
+    if (ok)
+      templates.push_back(lang_templates);
+  }
+  if (!ok || offset != data.size()) {
+    tprintf("Invalid adaptive classifier state!\n");
+    for (int i = 0; i < templates.size(); ++i)
+      free_adapted_templates(templates[i]);
+    return false;
+  }
+  for (int i = 0; i <= sub_langs_.size(); ++i) {
+    Tesseract* lang_tess = i == 0 ? this : sub_langs_[i - 1];
+    lang_tess->RestoreAdaptiveClassifierInternal(templates[i]);
+  }
+  return true;
+}
+
 // Clear the document dictionary for this and all subclassifiers.
 void Tesseract::ResetDocumentDictionary() {
   getDict().ResetDocumentDictionary();
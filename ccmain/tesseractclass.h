@@ -159,6 +159,13 @@ class Tesseract : public Wordrec {
   void Clear();
   // Clear all memory of adaption for this and all subclassifiers.
   void ResetAdaptiveClassifier();
+  // Saves the state of the adaptive classifier of this and all
+  // subclassifiers to the given buffer, so that a long document can be
+  // continued later, or by another instance, without adapting afresh.
+  bool SaveAdaptiveClassifier(GenericVector<char>* data);
+  // Restores the state saved by SaveAdaptiveClassifier into an instance
+  // initialized with the same languages. Returns false on failure.
+  bool RestoreAdaptiveClassifier(const GenericVector<char>& data);
   // Clear the document dictionary for this and all subclassifiers.
   void ResetDocumentDictionary();
 
@@ -194,6 +201,9 @@ class Tesseract : public Wordrec {
   Pix* BestPix() const {
     return pix_grey_ != NULL ? pix_grey_ : pix_binary_;
   }
+  Pix* pix_thresholds() const {
+    return pix_thresholds_;
+  }
   void set_pix_thresholds(Pix* thresholds) {
     pixDestroy(&pix_thresholds_);
     pix_thresholds_ = thresholds;
@@ -270,21 +280,57 @@ class Tesseract : public Wordrec {
   bool ProcessTargetWord(const TBOX& word_box, const TBOX& target_word_box,
                          const char* word_config, int pass);
   // Sets up the words ready for whichever engine is to be run
+  // If defer_setup, the words are only collected, and RecogAllWordsPassN sets
+  // each one up just before recognizing it.
   void SetupAllWordsPassN(int pass_n,
                           const TBOX* target_word_box,
                           const char* word_config,
+                          bool defer_setup,
                           PAGE_RES* page_res,
                           GenericVector<WordData>* words);
   // Sets up the single word ready for whichever engine is to be run.
   void SetupWordPassN(int pass_n, WordData* word);
+  // Returns true if the work on the words is to be reduced as the deadline of
+  // the monitor comes closer, instead of failing the page when it passes.
+  bool DeadlineDegradable(const ETEXT_DESC* monitor) const;
+  // Returns the bit mask of SkippedWork to leave out of the next word, given
+  // the time that was left to the deadline of the monitor when word
+  // recognition started.
+  int DeadlineSkippedWork(const ETEXT_DESC* monitor, inT32 budget_msecs) const;
+  // Sets the work to leave out of the next word on this and all the
+  // sub-languages.
+  void SetSkippedWork(int skipped_work);
   // Runs word recognition on all the words.
+  // budget_msecs is the time that was left to the deadline of the monitor
+  // when word recognition started, by which the work on each word is reduced
+  // as the deadline comes closer when DeadlineDegradable. Then only a cancel
+  // returns false, and the words past the deadline are still recognized in
+  // pass 1 with all the skippable work left out, and keep their pass 1
+  // results in pass 2.
   bool RecogAllWordsPassN(int pass_n, ETEXT_DESC* monitor,
+                          inT32 budget_msecs,
                           GenericVector<WordData>* words);
+  // budget_msecs is the time that was left to the deadline of the monitor
+  // when recognition of the page started, against which the time used is
+  // measured when DeadlineDegradable, or 0 to start measuring now.
   bool recog_all_words(PAGE_RES* page_res,
                        ETEXT_DESC* monitor,
                        const TBOX* target_word_box,
                        const char* word_config,
-                       int dopasses);
+                       int dopasses,
+                       inT32 budget_msecs);
+  // Runs recog_all_words on each block of the page_res in turn, instead of on
+  // the whole page at once, and runs block_done, if not NULL, with a page
+  // holding just that block as soon as its results are final. Adaption and
+  // font recognition only learn from the blocks done so far, so the results
+  // may differ from recog_all_words. The progress of the monitor counts the
+  // blocks done, and cancellation is also checked between blocks. The time
+  // budget of a degradable deadline is shared by all the blocks.
+  // Returns false if cancelled or timed out, in which case the page_res
+  // keeps only the blocks that were reached. When degradable, passing the
+  // deadline is not a time out, and all the blocks are still run.
+  bool RecogAllBlocksInTurn(PAGE_RES* page_res, ETEXT_DESC* monitor,
+                            TessCallback1<PAGE_RES*>* block_done);
   void rejection_passes(PAGE_RES* page_res,
                         ETEXT_DESC* monitor,
                         const TBOX* target_word_box,
@@ -390,6 +436,14 @@ class Tesseract : public Wordrec {
   inT16 count_alphas(const WERD_CHOICE &word);
   //// tessedit.h ////////////////////////////////////////////////////////
   void read_config_file(const char *filename, SetParamConstraint constraint);
+  // Resolves the settings of a config file, found in the same places as by
+  // read_config_file, into param_set, to be applied later without reading
+  // the file again. Returns false if the file named any unknown params.
+  bool resolve_config_file(const char *filename, SetParamConstraint constraint,
+                           ParamSet *param_set);
+  // Returns the path of the given config file, looking in the configs and
+  // tessconfigs directories of the datadir before using the name as given.
+  STRING config_file_path(const char *filename) const;
   // Initialize for potentially a set of languages defined by the language
   // string and recursively any additional languages required by any language
   // traineddata file (via tessedit_load_sublangs in its config) that is loaded.
@@ -711,6 +765,22 @@ class Tesseract : public Wordrec {
              "Generate more boxes from boxed chars");
   BOOL_VAR_H(tessedit_dump_pageseg_images, false,
              "Dump intermediate images made during page segmentation");
+  BOOL_VAR_H(tessedit_dump_page_stats, false,
+             "Print the stage times and work counts of each page as JSON");
+  BOOL_VAR_H(tessedit_deadline_degrade, false,
+             "Near the deadline of a timeout, skip expensive work on the"
+             " remaining words and keep the results instead of failing."
+             " Pass 2 then sets up each word only when it is reached, so"
+             " tessedit_parallelize no longer pre-classifies pass 2");
+  double_VAR_H(tessedit_deadline_degrade_at, 0.5,
+               "Fraction of the word recognition time budget after which"
+               " work is skipped");
+  BOOL_VAR_H(tessedit_lean_results, false,
+             "Free the ratings, alternative choices and segmentation of each"
+             " word once it is final, keeping only what the iterators use");
+  BOOL_VAR_H(tessedit_reuse_page_threshold, false,
+             "Threshold the whole image once per SetImage and cut each"
+             " SetRectangle out of it, instead of thresholding each one");
   INT_VAR_H(tessedit_pageseg_mode, PSM_SINGLE_BLOCK,
             "Page seg mode: 0=osd only, 1=auto+osd, 2=auto, 3=col, 4=block,"
             " 5=line, 6=word, 7=char"
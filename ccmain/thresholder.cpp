@@ -33,7 +33,9 @@ ImageThresholder::ImageThresholder()
   : pix_(NULL),
     image_width_(0), image_height_(0),
     pix_channels_(0), pix_wpl_(0),
-    scale_(1), yres_(300), estimated_res_(300) {
+    scale_(1), yres_(300), estimated_res_(300),
+    reuse_page_threshold_(false), page_binary_(NULL),
+    page_grey_threshold_(-1) {
   SetRectangle(0, 0, 0, 0);
 }
 
@@ -44,6 +46,8 @@ ImageThresholder::~ImageThresholder() {
 // Destroy the Pix if there is one, freeing memory.
 void ImageThresholder::Clear() {
   pixDestroy(&pix_);
+  pixDestroy(&page_binary_);
+  page_grey_threshold_ = -1;
 }
 
 // Return true if no image has been set.
@@ -148,6 +152,8 @@ void ImageThresholder::GetImageSizes(int* left, int* top,
 void ImageThresholder::SetImage(const Pix* pix) {
   if (pix_ != NULL)
     pixDestroy(&pix_);
+  pixDestroy(&page_binary_);
+  page_grey_threshold_ = -1;
   Pix* src = const_cast<Pix*>(pix);
   int depth;
   pixGetDimensions(src, &image_width_, &image_height_, &depth);
@@ -175,6 +181,8 @@ void ImageThresholder::ThresholdToPix(Pix** pix) {
   if (pix_channels_ == 0) {
     // We have a binary image, so it just has to be cloned.
     *pix = GetPixRect();
+  } else if (reuse_page_threshold_) {
+    PageThresholdRectToPix(pix);
   } else {
     OtsuThresholdRectToPix(pix_, pix);
   }
@@ -189,19 +197,31 @@ void ImageThresholder::ThresholdToPix(Pix** pix) {
 // Returns NULL if the input is binary. PixDestroy after use.
 Pix* ImageThresholder::GetPixRectThresholds() {
   if (IsBinary()) return NULL;
-  Pix* pix_grey = GetPixRectGrey();
-  int width = pixGetWidth(pix_grey);
-  int height = pixGetHeight(pix_grey);
+  int threshold;
+  if (reuse_page_threshold_) {
+    if (page_grey_threshold_ < 0)
+      page_grey_threshold_ = GreyThreshold(ConvertToGrey(pixClone(pix_)));
+    threshold = page_grey_threshold_;
+  } else {
+    threshold = GreyThreshold(GetPixRectGrey());
+  }
+  Pix* pix_thresholds = pixCreate(rect_width_, rect_height_, 8);
+  pixSetAllArbitrary(pix_thresholds, threshold);
+  return pix_thresholds;
+}
+
+// Returns the single threshold used by GetPixRectThresholds for the given
+// greyscale image, which is destroyed.
+int ImageThresholder::GreyThreshold(Pix* pix_grey) {
   int* thresholds;
   int* hi_values;
-  OtsuThreshold(pix_grey, 0, 0, width, height, &thresholds, &hi_values);
+  OtsuThreshold(pix_grey, 0, 0, pixGetWidth(pix_grey), pixGetHeight(pix_grey),
+                &thresholds, &hi_values);
   pixDestroy(&pix_grey);
-  Pix* pix_thresholds = pixCreate(width, height, 8);
   int threshold = thresholds[0] > 0 ? thresholds[0] : 128;
-  pixSetAllArbitrary(pix_thresholds, threshold);
   delete [] thresholds;
   delete [] hi_values;
-  return pix_thresholds;
+  return threshold;
 }
 
 // Common initialization shared between SetImage methods.
@@ -232,7 +252,11 @@ Pix* ImageThresholder::GetPixRect() {
 // The returned Pix must be pixDestroyed.
 // Provided to the classifier to extract features from the greyscale image.
 Pix* ImageThresholder::GetPixRectGrey() {
-  Pix* pix = GetPixRect();  // May have to be reduced to grey.
+  return ConvertToGrey(GetPixRect());
+}
+
+// Returns pix reduced to 8 bit greyscale, taking ownership of pix.
+Pix* ImageThresholder::ConvertToGrey(Pix* pix) {
   int depth = pixGetDepth(pix);
   if (depth != 8) {
     Pix* result = depth < 8 ? pixConvertTo8(pix, false)
@@ -273,6 +297,28 @@ void ImageThresholder::OtsuThresholdRectToPix(Pix* src_pix,
   PERF_COUNT_END
 }
 
+// Cuts the rectangle out of the thresholded whole image, thresholding the
+// whole image first if it has not been done since SetImage.
+void ImageThresholder::PageThresholdRectToPix(Pix** out_pix) {
+  if (page_binary_ == NULL) {
+    int left = rect_left_;
+    int top = rect_top_;
+    int width = rect_width_;
+    int height = rect_height_;
+    SetRectangle(0, 0, image_width_, image_height_);
+    OtsuThresholdRectToPix(pix_, &page_binary_);
+    SetRectangle(left, top, width, height);
+  }
+  // The caller may modify the result, so it is always a copy.
+  if (IsFullImage()) {
+    *out_pix = pixCopy(NULL, page_binary_);
+  } else {
+    Box* box = boxCreate(rect_left_, rect_top_, rect_width_, rect_height_);
+    *out_pix = pixClipRectangle(page_binary_, box, NULL);
+    boxDestroy(&box);
+  }
+}
+
 /// Threshold the rectangle, taking everything except the src_pix
 /// from the class, using thresholds/hi_values to the output pix.
 /// NOTE that num_channels is the size of the thresholds and hi_values
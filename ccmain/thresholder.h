@@ -118,6 +118,19 @@ class TESS_API ImageThresholder {
   /// Caller must use pixDestroy to free the created Pix.
   virtual void ThresholdToPix(Pix** pix);
 
+  /// If reuse is true, the whole image is thresholded only once per SetImage,
+  /// and ThresholdToPix cuts each rectangle out of the result, so many calls
+  /// to SetRectangle on one image are cheap. Greyscale and color images are
+  /// then thresholded with values computed over the whole image, rather than
+  /// over each rectangle, so the results may differ slightly. Binary images
+  /// give the same results either way.
+  void SetReusePageThreshold(bool reuse) {
+    reuse_page_threshold_ = reuse;
+  }
+  bool reuse_page_threshold() const {
+    return reuse_page_threshold_;
+  }
+
   // Gets a pix that contains an 8 bit threshold value at each pixel. The
   // returned pix may be an integer reduction of the binary image such that
   // the scale factor may be inferred from the ratio of the sizes, even down
@@ -156,6 +169,17 @@ class TESS_API ImageThresholder {
   // Otsu thresholds the rectangle, taking the rectangle from *this.
   void OtsuThresholdRectToPix(Pix* src_pix, Pix** out_pix) const;
 
+  // Cuts the rectangle out of the thresholded whole image, thresholding the
+  // whole image first if it has not been done since SetImage.
+  void PageThresholdRectToPix(Pix** out_pix);
+
+  // Returns the single threshold used by GetPixRectThresholds for the given
+  // greyscale image, which is destroyed.
+  static int GreyThreshold(Pix* pix_grey);
+
+  // Returns pix reduced to 8 bit greyscale, taking ownership of pix.
+  static Pix* ConvertToGrey(Pix* pix);
+
   /// Threshold the rectangle, taking everything except the src_pix
   /// from the class, using thresholds/hi_values to the output pix.
   /// NOTE that num_channels is the size of the thresholds and hi_values
@@ -181,6 +205,14 @@ class TESS_API ImageThresholder {
   int                  rect_top_;
   int                  rect_width_;
   int                  rect_height_;
+  // True if the whole image is thresholded only once. See
+  // SetReusePageThreshold.
+  bool                 reuse_page_threshold_;
+  // The thresholded whole image, if reuse_page_threshold_ and it has been
+  // made since SetImage.
+  Pix*                 page_binary_;
+  // The threshold of the whole greyscale image, or -1 if not yet found.
+  int                  page_grey_threshold_;
 };
 
 }  // namespace tesseract.
@@ -40,6 +40,7 @@
 #include "linlsq.h"
 #include "ndminx.h"
 #include "normalis.h"
+#include "objectpool.h"
 #include "ocrblock.h"
 #include "ocrrow.h"
 #include "points.h"
@@ -64,6 +65,19 @@ const TPOINT kDivisibleVerticalItalic(1, 5);
 
 CLISTIZE(EDGEPT);
 
+// Free blocks for recycling EDGEPTs.
+static TESS_THREAD_LOCAL tesseract::FreeBlockList edgept_blocks;
+
+void* EDGEPT::operator new(size_t size) {
+  return tesseract::FreeBlockList::Alloc(size, sizeof(EDGEPT),
+                                         &edgept_blocks);
+}
+
+void EDGEPT::operator delete(void* block, size_t size) {
+  tesseract::FreeBlockList::Free(block, size, sizeof(EDGEPT),
+                                 &edgept_blocks);
+}
+
 // Consume the circular list of EDGEPTs to make a TESSLINE.
 TESSLINE* TESSLINE::BuildFromOutlineList(EDGEPT* outline) {
   TESSLINE* result = new TESSLINE;
@@ -78,6 +78,10 @@ struct EDGEPT {
     CopyFrom(src);
     return *this;
   }
+  // Instances are recycled through a per-thread FreeBlockList, as very
+  // many are made and destroyed for every word.
+  static void* operator new(size_t size);
+  static void operator delete(void* block, size_t size);
   // Copies the data elements, but leaves the pointers untouched.
   void CopyFrom(const EDGEPT& src) {
     pos = src.pos;
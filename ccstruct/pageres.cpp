@@ -206,6 +206,7 @@ void WERD_RES::CopySimpleFields(const WERD_RES& source) {
   tess_accepted = source.tess_accepted;
   tess_would_adapt = source.tess_would_adapt;
   done = source.done;
+  skipped_work = source.skipped_work;
   unlv_crunch_mode = source.unlv_crunch_mode;
   small_caps = source.small_caps;
   italic = source.italic;
@@ -1036,6 +1037,7 @@ void WERD_RES::InitNonPointers() {
   tess_accepted = FALSE;
   tess_would_adapt = FALSE;
   done = FALSE;
+  skipped_work = tesseract::SKIP_NONE;
   unlv_crunch_mode = CR_NONE;
   small_caps = false;
   italic = FALSE;
@@ -1133,6 +1135,35 @@ void WERD_RES::ClearRatings() {
     ratings = NULL;
   }
 }
+// Frees everything that is only needed while the word is being recognized,
+// keeping just what the result iterators use: the word, best_choice,
+// box_word, reject_map, the fonts and the blamer_bundle. The word cannot
+// be recognized again afterwards, and there are no alternative choices.
+void WERD_RES::ClearIntermediateResults() {
+  delete bln_boxes;
+  bln_boxes = NULL;
+  delete chopped_word;
+  chopped_word = NULL;
+  delete rebuild_word;
+  rebuild_word = NULL;
+  best_state.clear();
+  correct_text.clear();
+  seam_array.delete_data_pointers();
+  seam_array.clear();
+  blob_widths.clear();
+  blob_gaps.clear();
+  ClearRatings();
+  delete raw_choice;
+  raw_choice = NULL;
+  delete ep_choice;
+  ep_choice = NULL;
+  // best_choice is one of best_choices, and is the only one kept.
+  WERD_CHOICE_IT it(&best_choices);
+  for (it.mark_cycle_pt(); !it.cycled_list(); it.forward()) {
+    if (it.data() != best_choice)
+      delete it.extract();
+  }
+}
 
 
 bool PAGE_RES_IT::operator ==(const PAGE_RES_IT &other) const {
@@ -279,6 +279,7 @@ class WERD_RES : public ELIST_LINK {
   BOOL8 tess_accepted;          // Tess thinks its ok?
   BOOL8 tess_would_adapt;       // Tess would adapt?
   BOOL8 done;                   // ready for output?
+  int skipped_work;             // Bit mask of SkippedWork left out.
   bool small_caps;             // word appears to be small caps
   inT8 italic;
   inT8 bold;
@@ -412,6 +413,11 @@ class WERD_RES : public ELIST_LINK {
   void ClearResults();
   void ClearWordChoices();
   void ClearRatings();
+  // Frees everything that is only needed while the word is being recognized,
+  // keeping just what the result iterators use: the word, best_choice,
+  // box_word, reject_map, the fonts and the blamer_bundle. The word cannot
+  // be recognized again afterwards, and there are no alternative choices.
+  void ClearIntermediateResults();
 
   // Deep copies everything except the ratings MATRIX.
   // To get that use deep_copy below.
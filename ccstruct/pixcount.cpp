@@ -0,0 +1,197 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pixcount.cpp
+// Description: Fast counting of the black pixels in rectangles of a
+//              binary image.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pixcount.h"
+
+#include "allheaders.h"
+#include "helpers.h"
+#include "rect.h"
+
+namespace tesseract {
+
+// Number of pixels in each word of a 1 bpp image.
+const int kPixelsPerWord = 32;
+
+// Returns the number of set bits in the word.
+static inline int CountBits(uinT32 word) {
+  word = word - ((word >> 1) & 0x55555555);
+  word = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+  word = (word + (word >> 4)) & 0x0f0f0f0f;
+  return (word * 0x01010101) >> 24;
+}
+
+// Returns a mask of the bits of a word that hold the pixels [left, right),
+// where 0 <= left < right <= kPixelsPerWord. The first pixel is the most
+// significant bit, as in leptonica.
+static inline uinT32 PixelMask(int left, int right) {
+  uinT32 mask = ~0u >> left;
+  if (right < kPixelsPerWord)
+    mask &= ~(~0u >> right);
+  return mask;
+}
+
+PixelCountTable::PixelCountTable()
+  : pix_(NULL), width_(0), height_(0), wpl_(0) {
+}
+
+PixelCountTable::~PixelCountTable() {
+  Clear();
+}
+
+// Builds the table for the given 1 bpp pix, which is cloned, so it must
+// not be modified while the table is in use. Any previous table is
+// discarded.
+void PixelCountTable::Init(Pix* pix) {
+  Clear();
+  if (pix == NULL || pixGetDepth(pix) != 1)
+    return;
+  pix_ = pixClone(pix);
+  width_ = pixGetWidth(pix_);
+  height_ = pixGetHeight(pix_);
+  wpl_ = pixGetWpl(pix_);
+  int stride = wpl_ + 1;
+  counts_.init_to_size((height_ + 1) * stride, 0);
+  // The padding at the end of each line is not guaranteed to be clear.
+  uinT32 last_mask = ~0u;
+  if (width_ % kPixelsPerWord != 0)
+    last_mask = PixelMask(0, width_ % kPixelsPerWord);
+  const uinT32* data = pixGetData(pix_);
+  for (int y = 0; y < height_; ++y, data += wpl_) {
+    const inT32* prev_row = &counts_[y * stride];
+    inT32* row = &counts_[(y + 1) * stride];
+    int row_count = 0;
+    for (int w = 0; w < wpl_; ++w) {
+      uinT32 word = data[w];
+      if (w == wpl_ - 1)
+        word &= last_mask;
+      row_count += CountBits(word);
+      row[w + 1] = prev_row[w + 1] + row_count;
+    }
+  }
+}
+
+// Discards the table and releases the pix.
+void PixelCountTable::Clear() {
+  pixDestroy(&pix_);
+  width_ = height_ = wpl_ = 0;
+  counts_.clear();
+}
+
+// Returns the number of black pixels in [left, right) x [top, bottom).
+int PixelCountTable::CountPixels(int left, int top,
+                                 int right, int bottom) const {
+  if (pix_ == NULL || !ClipRect(width_, height_, &left, &top, &right, &bottom))
+    return 0;
+  const uinT32* data = pixGetData(pix_);
+  int left_word = left / kPixelsPerWord;
+  int right_word = right / kPixelsPerWord;
+  int left_bit = left % kPixelsPerWord;
+  int right_bit = right % kPixelsPerWord;
+  if (left_word == right_word) {
+    return CountPixelsInWord(data, wpl_, left_word, left_bit, right_bit,
+                             top, bottom);
+  }
+  int count = 0;
+  // Partial words at the ends are counted from the image.
+  if (left_bit != 0) {
+    count += CountPixelsInWord(data, wpl_, left_word, left_bit,
+                               kPixelsPerWord, top, bottom);
+    ++left_word;
+  }
+  if (right_bit != 0) {
+    count += CountPixelsInWord(data, wpl_, right_word, 0, right_bit,
+                               top, bottom);
+  }
+  // Whole words in between come from the table.
+  if (left_word < right_word) {
+    int stride = wpl_ + 1;
+    count += counts_[bottom * stride + right_word] -
+             counts_[top * stride + right_word] -
+             counts_[bottom * stride + left_word] +
+             counts_[top * stride + left_word];
+  }
+  return count;
+}
+
+// Returns the number of black pixels in the box.
+int PixelCountTable::CountPixels(const TBOX& box) const {
+  return CountPixels(box.left(), height_ - box.top(),
+                     box.right(), height_ - box.bottom());
+}
+
+// Returns the fraction of the pixels of the box, clipped to the image, that
+// are black, or 0 if the clipped box is empty.
+float PixelCountTable::ForegroundFraction(const TBOX& box) const {
+  int left = box.left();
+  int top = height_ - box.top();
+  int right = box.right();
+  int bottom = height_ - box.bottom();
+  if (pix_ == NULL || !ClipRect(width_, height_, &left, &top, &right, &bottom))
+    return 0.0f;
+  int area = (right - left) * (bottom - top);
+  return static_cast<float>(CountPixels(left, top, right, bottom)) / area;
+}
+
+// Returns the number of black pixels in [left, right) x [top, bottom) of
+// a 1 bpp pix without building a table, for images that change too often
+// for a table to be worth keeping. Nothing is allocated, and the cost is
+// proportional to the number of image words covered.
+int PixelCountTable::CountPixelsInRect(Pix* pix, int left, int top,
+                                       int right, int bottom) {
+  if (pix == NULL || pixGetDepth(pix) != 1 ||
+      !ClipRect(pixGetWidth(pix), pixGetHeight(pix),
+                &left, &top, &right, &bottom))
+    return 0;
+  const uinT32* data = pixGetData(pix);
+  int wpl = pixGetWpl(pix);
+  int count = 0;
+  int last_word = (right - 1) / kPixelsPerWord;
+  for (int w = left / kPixelsPerWord; w <= last_word; ++w) {
+    int word_start = w * kPixelsPerWord;
+    int word_left = MAX(left, word_start) - word_start;
+    int word_right = MIN(right, word_start + kPixelsPerWord) - word_start;
+    count += CountPixelsInWord(data, wpl, w, word_left, word_right,
+                               top, bottom);
+  }
+  return count;
+}
+
+// Clips the rectangle to the given image size. Returns false if it is empty.
+bool PixelCountTable::ClipRect(int width, int height,
+                               int* left, int* top, int* right, int* bottom) {
+  *left = ClipToRange(*left, 0, width);
+  *right = ClipToRange(*right, 0, width);
+  *top = ClipToRange(*top, 0, height);
+  *bottom = ClipToRange(*bottom, 0, height);
+  return *left < *right && *top < *bottom;
+}
+
+// Returns the number of black pixels in the columns [left, right) of the
+// rows [top, bottom) of the given image data, where the columns all lie
+// within a single word of each row.
+int PixelCountTable::CountPixelsInWord(const uinT32* data, int wpl, int word,
+                                       int left, int right,
+                                       int top, int bottom) {
+  uinT32 mask = PixelMask(left, right);
+  int count = 0;
+  const uinT32* line = data + top * wpl + word;
+  for (int y = top; y < bottom; ++y, line += wpl)
+    count += CountBits(*line & mask);
+  return count;
+}
+
+}  // namespace tesseract.
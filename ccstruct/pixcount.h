@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pixcount.h
+// Description: Fast counting of the black pixels in rectangles of a
+//              binary image.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCSTRUCT_PIXCOUNT_H_
+#define TESSERACT_CCSTRUCT_PIXCOUNT_H_
+
+#include "genericvector.h"
+#include "host.h"
+
+struct Pix;
+class TBOX;
+
+namespace tesseract {
+
+// A summed-area table of the black pixels in a 1 bpp Pix, built once so that
+// the number of black pixels in any rectangle can be found without clipping
+// or scanning the image. The table works on whole 32 bit words of the image,
+// so it is 1/32 of the size of a full resolution table, and only the two
+// partial words at the left and right edges of a rectangle are counted from
+// the image itself.
+// Rectangles are given in image coordinates (origin top-left) by the
+// functions that take ints, and in tesseract coordinates (origin
+// bottom-left) by the functions that take a TBOX. All rectangles are clipped
+// to the image.
+class PixelCountTable {
+ public:
+  PixelCountTable();
+  ~PixelCountTable();
+
+  // Builds the table for the given 1 bpp pix, which is cloned, so it must
+  // not be modified while the table is in use. Any previous table is
+  // discarded.
+  void Init(Pix* pix);
+  // Discards the table and releases the pix.
+  void Clear();
+
+  bool empty() const {
+    return pix_ == NULL;
+  }
+
+  // Returns the number of black pixels in [left, right) x [top, bottom).
+  int CountPixels(int left, int top, int right, int bottom) const;
+  // Returns the number of black pixels in the box.
+  int CountPixels(const TBOX& box) const;
+  // Returns the fraction of the pixels of the box, clipped to the image, that
+  // are black, or 0 if the clipped box is empty.
+  float ForegroundFraction(const TBOX& box) const;
+
+  // Returns the number of black pixels in [left, right) x [top, bottom) of
+  // a 1 bpp pix without building a table, for images that change too often
+  // for a table to be worth keeping. Nothing is allocated, and the cost is
+  // proportional to the number of image words covered.
+  static int CountPixelsInRect(Pix* pix, int left, int top,
+                               int right, int bottom);
+
+ private:
+  // Clips the rectangle to the given image size. Returns false if it is empty.
+  static bool ClipRect(int width, int height,
+                       int* left, int* top, int* right, int* bottom);
+  // Returns the number of black pixels in the columns [left, right) of the
+  // rows [top, bottom) of the given image data, where the columns all lie
+  // within a single word of each row.
+  static int CountPixelsInWord(const uinT32* data, int wpl, int word,
+                               int left, int right, int top, int bottom);
+
+  // The image. NULL if the table is empty.
+  Pix* pix_;
+  int width_;
+  int height_;
+  // Words per line of pix_.
+  int wpl_;
+  // counts_[y * (wpl_ + 1) + w] is the number of black pixels in the rows
+  // above y and the words to the left of w.
+  GenericVector<inT32> counts_;
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_CCSTRUCT_PIXCOUNT_H_
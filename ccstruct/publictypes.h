@@ -254,6 +254,22 @@ enum OcrEngineMode {
                                 // default OEM_TESSERACT_ONLY.
 };
 
+/**
+ * Parts of the recognition of a word that were left out to finish a page
+ * before the deadline of a timeout, when tessedit_deadline_degrade is on.
+ * The work done on a word is reduced progressively as the deadline comes
+ * closer, and LTRResultIterator::WordSkippedWork returns a bit mask of
+ * these for each word. Words that are not reached by the deadline at all
+ * are left out of the results.
+ */
+enum SkippedWork {
+  SKIP_NONE = 0,
+  SKIP_ADAPTION = 1,    // The adaptive classifier was not trained on it.
+  SKIP_PASS2 = 2,       // It was not recognized again in pass 2.
+  SKIP_CHOPPING = 4,    // Its blobs were not chopped.
+  SKIP_SEGSEARCH = 8,   // Its blobs were not joined by the segmentation search.
+};
+
 }  // namespace tesseract.
 
 #endif  // TESSERACT_CCSTRUCT_PUBLICTYPES_H__
@@ -29,6 +29,7 @@
 #include "genericvector.h"
 #include "matrix.h"
 #include "normalis.h"  // kBlnBaselineOffset.
+#include "objectpool.h"
 #include "unicharset.h"
 
 using tesseract::ScriptPos;
@@ -128,6 +129,19 @@ BLOB_CHOICE::BLOB_CHOICE(const BLOB_CHOICE &other) {
   classifier_ = other.classifier_;
 }
 
+// Free blocks for recycling BLOB_CHOICEs.
+static TESS_THREAD_LOCAL tesseract::FreeBlockList blob_choice_blocks;
+
+void* BLOB_CHOICE::operator new(size_t size) {
+  return tesseract::FreeBlockList::Alloc(size, sizeof(BLOB_CHOICE),
+                                         &blob_choice_blocks);
+}
+
+void BLOB_CHOICE::operator delete(void* block, size_t size) {
+  tesseract::FreeBlockList::Free(block, size, sizeof(BLOB_CHOICE),
+                                 &blob_choice_blocks);
+}
+
 // Returns true if *this and other agree on the baseline and x-height
 // to within some tolerance based on a given estimate of the x-height.
 bool BLOB_CHOICE::PosAndSizeAgree(const BLOB_CHOICE& other, float x_height,
@@ -172,6 +186,32 @@ BLOB_CHOICE* FindMatchingChoice(UNICHAR_ID char_id,
   return NULL;
 }
 
+namespace tesseract {
+
+// Copies the choices of the given list in order, replacing any previous
+// contents, but keeping the memory for reuse.
+void BlobChoiceTable::Set(BLOB_CHOICE_LIST* choices) {
+  clear();
+  BLOB_CHOICE_IT c_it(choices);
+  for (c_it.mark_cycle_pt(); !c_it.cycled_list(); c_it.forward()) {
+    BLOB_CHOICE* choice = c_it.data();
+    choices_.push_back(choice);
+    unichar_ids_.push_back(choice->unichar_id());
+    certainties_.push_back(choice->certainty());
+  }
+}
+
+// Returns the index of the first choice with the given unichar_id in
+// [0, end), or -1 if there is none.
+int BlobChoiceTable::FindUnichar(UNICHAR_ID unichar_id, int end) const {
+  for (int i = 0; i < end; ++i) {
+    if (unichar_ids_[i] == unichar_id) return i;
+  }
+  return -1;
+}
+
+}  // namespace tesseract.
+
 const char *WERD_CHOICE::permuter_name(uinT8 permuter) {
   return kPermuterTypeNames[permuter];
 }
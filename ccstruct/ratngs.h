@@ -74,6 +74,11 @@ class BLOB_CHOICE: public ELIST_LINK
     BLOB_CHOICE(const BLOB_CHOICE &other);
     ~BLOB_CHOICE() {}
 
+    // Instances are recycled through a per-thread FreeBlockList, as very
+    // many are made and destroyed for every word.
+    static void* operator new(size_t size);
+    static void operator delete(void* block, size_t size);
+
     UNICHAR_ID unichar_id() const {
       return unichar_id_;
     }
@@ -251,6 +256,55 @@ enum ScriptPos {
 
 const char *ScriptPosToString(tesseract::ScriptPos script_pos);
 
+// A compact copy of the choices of a BLOB_CHOICE_LIST, held as parallel
+// arrays, so that the choices of a ratings matrix cell can be scanned many
+// times over by the language model without chasing the list pointers.
+// The BLOB_CHOICEs stay on the list, which still owns them, and choice(i)
+// gives the whole BLOB_CHOICE to code that needs more than the scores.
+// The list must not be changed while the table is in use.
+// The table is only a cache: the ratings MATRIX still holds the lists, so it
+// saves no memory, and LanguageModel::UpdateState refills it on every call.
+// Filling it costs about one walk of the list, which UpdateState earns back
+// from the two or three walks and the case variant searches it replaces.
+// training/tessbench times both on the lists of a recognized corpus.
+class BlobChoiceTable {
+ public:
+  BlobChoiceTable() {}
+
+  // Copies the choices of the given list in order, replacing any previous
+  // contents, but keeping the memory for reuse.
+  void Set(BLOB_CHOICE_LIST* choices);
+  void clear() {
+    choices_.truncate(0);
+    unichar_ids_.truncate(0);
+    certainties_.truncate(0);
+  }
+
+  int size() const {
+    return choices_.size();
+  }
+  bool empty() const {
+    return choices_.empty();
+  }
+  BLOB_CHOICE* choice(int index) const {
+    return choices_[index];
+  }
+  UNICHAR_ID unichar_id(int index) const {
+    return unichar_ids_[index];
+  }
+  float certainty(int index) const {
+    return certainties_[index];
+  }
+  // Returns the index of the first choice with the given unichar_id in
+  // [0, end), or -1 if there is none.
+  int FindUnichar(UNICHAR_ID unichar_id, int end) const;
+
+ private:
+  GenericVector<BLOB_CHOICE*> choices_;
+  GenericVector<UNICHAR_ID> unichar_ids_;
+  GenericVector<float> certainties_;
+};
+
 }  // namespace tesseract.
 
 class WERD_CHOICE : public ELIST_LINK {
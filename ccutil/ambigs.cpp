@@ -21,6 +21,8 @@
 #include "ambigs.h"
 
 #include <stdio.h>
+#include <string.h>
+#include "ccutil.h"
 #include "helpers.h"
 #include "universalambigs.h"
 
@@ -63,12 +65,161 @@ void UnicharAmbigs::InitUnicharAmbigs(const UNICHARSET& unicharset,
   }
 }
 
+// Maximum number of encoder unicharsets whose compiled universal ambigs are
+// kept for the life of the process.
+const int kMaxCachedUniversalAmbigs = 8;
+
+// Returns the FNV-1a hash of the bytes, continuing from hash.
+static uinT32 HashBytes(const void* data, int size, uinT32 hash) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (int i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Returns the signature of the given encoder unicharset and ambigs file,
+// which is rewound afterwards. ambigs_file may be NULL for no ambigs.
+uinT32 CompiledAmbigs::Signature(const UNICHARSET& encoder_set,
+                                 TFile* ambigs_file) {
+  uinT32 hash = 2166136261u;
+  int size = encoder_set.size();
+  hash = HashBytes(&size, sizeof(size), hash);
+  for (int id = 0; id < size; ++id) {
+    const char* unichar = encoder_set.id_to_unichar(id);
+    hash = HashBytes(unichar, strlen(unichar) + 1, hash);
+  }
+  if (ambigs_file != NULL) {
+    char buffer[kUnigramAmbigsBufferSize];
+    while (ambigs_file->FGets(buffer, sizeof(buffer)) != NULL)
+      hash = HashBytes(buffer, strlen(buffer), hash);
+    ambigs_file->Rewind();
+  }
+  return hash;
+}
+
+// Appends a parsed ambiguity.
+void CompiledAmbigs::Add(int type, int test_ambig_part_size,
+                         const UNICHAR_ID* test_unichar_ids,
+                         int replacement_ambig_part_size,
+                         const char* replacement_string) {
+  types_.push_back(type);
+  test_sizes_.push_back(test_ambig_part_size);
+  replacement_sizes_.push_back(replacement_ambig_part_size);
+  test_starts_.push_back(test_ids_.size());
+  for (int i = 0; test_unichar_ids[i] != INVALID_UNICHAR_ID; ++i)
+    test_ids_.push_back(test_unichar_ids[i]);
+  test_ids_.push_back(INVALID_UNICHAR_ID);
+  replacement_starts_.push_back(replacements_.size());
+  do {
+    replacements_.push_back(*replacement_string);
+  } while (*replacement_string++ != '\0');
+}
+
+void CompiledAmbigs::clear() {
+  signature_ = 0;
+  types_.truncate(0);
+  test_sizes_.truncate(0);
+  replacement_sizes_.truncate(0);
+  test_starts_.truncate(0);
+  replacement_starts_.truncate(0);
+  test_ids_.truncate(0);
+  replacements_.truncate(0);
+}
+
+// Writes to the given file. Returns false in case of error.
+bool CompiledAmbigs::Serialize(FILE* fp) const {
+  if (fwrite(&signature_, sizeof(signature_), 1, fp) != 1) return false;
+  return types_.Serialize(fp) && test_sizes_.Serialize(fp) &&
+      replacement_sizes_.Serialize(fp) && test_starts_.Serialize(fp) &&
+      replacement_starts_.Serialize(fp) && test_ids_.Serialize(fp) &&
+      replacements_.Serialize(fp);
+}
+
+// Reads from the given file. Returns false in case of error.
+// If swap is true, assumes a big/little-endian swap is needed.
+bool CompiledAmbigs::DeSerialize(bool swap, FILE* fp) {
+  if (fread(&signature_, sizeof(signature_), 1, fp) != 1) return false;
+  if (swap) Reverse32(&signature_);
+  if (!types_.DeSerialize(swap, fp) || !test_sizes_.DeSerialize(swap, fp) ||
+      !replacement_sizes_.DeSerialize(swap, fp) ||
+      !test_starts_.DeSerialize(swap, fp) ||
+      !replacement_starts_.DeSerialize(swap, fp) ||
+      !test_ids_.DeSerialize(swap, fp) || !replacements_.DeSerialize(swap, fp))
+    return false;
+  // Check the consistency of the data, as it is indexed without checks.
+  int size = types_.size();
+  if (test_sizes_.size() != size || replacement_sizes_.size() != size ||
+      test_starts_.size() != size || replacement_starts_.size() != size)
+    return false;
+  if (!test_ids_.empty() && test_ids_.back() != INVALID_UNICHAR_ID)
+    return false;
+  if (!replacements_.empty() && replacements_.back() != '\0')
+    return false;
+  for (int i = 0; i < size; ++i) {
+    if (test_starts_[i] < 0 || test_starts_[i] >= test_ids_.size() ||
+        replacement_starts_[i] < 0 ||
+        replacement_starts_[i] >= replacements_.size() ||
+        test_sizes_[i] <= 0 || test_sizes_[i] > MAX_AMBIG_SIZE ||
+        replacement_sizes_[i] <= 0 ||
+        replacement_sizes_[i] > MAX_AMBIG_SIZE)
+      return false;
+  }
+  return true;
+}
+
 // Loads the universal ambigs that are useful for any language.
+// The universal ambigs are compiled only once for each encoder unicharset
+// in the process, as parsing them is a large part of the Init time.
 void UnicharAmbigs::LoadUniversal(const UNICHARSET& encoder_set,
                                   UNICHARSET* unicharset) {
+  static CCUtilMutex cache_mutex;
+  static PointerVector<CompiledAmbigs> cache;
+  uinT32 signature = UniversalSignature(encoder_set);
+  const CompiledAmbigs* compiled = NULL;
+  cache_mutex.Lock();
+  for (int i = 0; i < cache.size() && compiled == NULL; ++i) {
+    if (cache[i]->signature() == signature)
+      compiled = cache[i];
+  }
+  if (compiled == NULL) {
+    CompiledAmbigs* new_compiled = new CompiledAmbigs;
+    CompileUniversal(encoder_set, new_compiled);
+    if (cache.size() >= kMaxCachedUniversalAmbigs)
+      cache.remove(0);
+    cache.push_back(new_compiled);
+    compiled = new_compiled;
+  }
+  // The entries are never modified, but may be removed, so the lock is
+  // held while they are added.
+  AddCompiledAmbigs(*compiled, 0, false, unicharset);
+  cache_mutex.Unlock();
+}
+
+// Compiles the universal ambigs for the given encoder unicharset.
+void UnicharAmbigs::CompileUniversal(const UNICHARSET& encoder_set,
+                                     CompiledAmbigs* compiled) {
   TFile file;
-  if (!file.Open(kUniversalAmbigsFile, ksizeofUniversalAmbigsFile)) return;
-  LoadUnicharAmbigs(encoder_set, &file, 0, false, unicharset);
+  if (file.Open(kUniversalAmbigsFile, ksizeofUniversalAmbigsFile))
+    CompileUnicharAmbigs(encoder_set, &file, 0, compiled);
+  else
+    compiled->clear();
+  compiled->set_signature(UniversalSignature(encoder_set));
+  // The text is hashed here, where it is parsed anyway, to catch a hash
+  // that was not regenerated with the data.
+  if (HashBytes(kUniversalAmbigsFile, ksizeofUniversalAmbigsFile,
+                2166136261u) != kUniversalAmbigsHash)
+    tprintf("Warning: kUniversalAmbigsHash does not match the data!\n");
+}
+
+// Returns the signature that CompileUniversal would give the compiled
+// ambigs for the given encoder unicharset, without compiling them.
+// The embedded text is represented by its precomputed hash, so only the
+// unicharset is hashed.
+uinT32 UnicharAmbigs::UniversalSignature(const UNICHARSET& encoder_set) {
+  uinT32 hash = CompiledAmbigs::Signature(encoder_set, NULL);
+  return HashBytes(&kUniversalAmbigsHash, sizeof(kUniversalAmbigsHash), hash);
 }
 
 void UnicharAmbigs::LoadUnicharAmbigs(const UNICHARSET& encoder_set,
@@ -76,8 +227,20 @@ void UnicharAmbigs::LoadUnicharAmbigs(const UNICHARSET& encoder_set,
                                       int debug_level,
                                       bool use_ambigs_for_adaption,
                                       UNICHARSET *unicharset) {
-  int i, j;
-  UnicharIdVector *adaption_ambigs_entry;
+  CompiledAmbigs compiled;
+  CompileUnicharAmbigs(encoder_set, ambig_file, debug_level, &compiled);
+  AddCompiledAmbigs(compiled, debug_level, use_ambigs_for_adaption,
+                    unicharset);
+}
+
+// Parses the ambigs file into compiled, keeping the ambiguities that are
+// valid for encoder_set. ambigs_file may be NULL for no ambigs.
+void UnicharAmbigs::CompileUnicharAmbigs(const UNICHARSET& encoder_set,
+                                         TFile *ambig_file, int debug_level,
+                                         CompiledAmbigs* compiled) {
+  compiled->clear();
+  compiled->set_signature(CompiledAmbigs::Signature(encoder_set, ambig_file));
+  if (ambig_file == NULL) return;
   if (debug_level) tprintf("Reading ambiguities\n");
 
   int test_ambig_part_size;
@@ -109,6 +272,27 @@ void UnicharAmbigs::LoadUnicharAmbigs(const UNICHARSET& encoder_set,
                             buffer, &test_ambig_part_size, test_unichar_ids,
                             &replacement_ambig_part_size,
                             replacement_string, &type)) continue;
+    compiled->Add(type, test_ambig_part_size, test_unichar_ids,
+                  replacement_ambig_part_size, replacement_string);
+  }
+  delete[] buffer;
+}
+
+// Adds the compiled ambiguities to the tables as LoadUnicharAmbigs does.
+// The compiled ambigs must have been made with a copy of unicharset as it
+// was before any ambigs were added.
+void UnicharAmbigs::AddCompiledAmbigs(const CompiledAmbigs& compiled,
+                                      int debug_level,
+                                      bool use_ambigs_for_adaption,
+                                      UNICHARSET *unicharset) {
+  int i, j;
+  UnicharIdVector *adaption_ambigs_entry;
+  for (int a = 0; a < compiled.size(); ++a) {
+    int type = compiled.type(a);
+    int test_ambig_part_size = compiled.test_ambig_part_size(a);
+    const UNICHAR_ID* test_unichar_ids = compiled.test_unichar_ids(a);
+    int replacement_ambig_part_size = compiled.replacement_ambig_part_size(a);
+    const char* replacement_string = compiled.replacement_string(a);
     // Construct AmbigSpec and add it to the appropriate AmbigSpec_LIST.
     AmbigSpec *ambig_spec = new AmbigSpec();
     if (!InsertIntoTable((type == REPLACE_AMBIG) ? replace_ambigs_
@@ -158,7 +342,6 @@ void UnicharAmbigs::LoadUnicharAmbigs(const UNICHARSET& encoder_set,
       }
     }
   }
-  delete[] buffer;
 
   // Fill in reverse_ambigs_for_adaption from ambigs_for_adaption vector.
   if (use_ambigs_for_adaption) {
@@ -337,7 +520,7 @@ bool UnicharAmbigs::ParseAmbiguityLine(
 
 bool UnicharAmbigs::InsertIntoTable(
     UnicharAmbigsVector &table, int test_ambig_part_size,
-    UNICHAR_ID *test_unichar_ids, int replacement_ambig_part_size,
+    const UNICHAR_ID *test_unichar_ids, int replacement_ambig_part_size,
     const char *replacement_string, int type,
     AmbigSpec *ambig_spec, UNICHARSET *unicharset) {
   ambig_spec->type = static_cast<AmbigType>(type);
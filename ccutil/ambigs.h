@@ -137,6 +137,67 @@ class AmbigSpec : public ELIST_LINK {
 };
 ELISTIZEH(AmbigSpec);
 
+// The ambiguities of an ambigs file that are valid for a given unicharset,
+// parsed in the order that they appear in the file, so that they can be
+// added to a UnicharAmbigs without parsing the text again. Adding them
+// inserts ngrams and fragments into the unicharset, so they are kept in file
+// order to reproduce the same unichar ids as loading the text would.
+// The signature ties the compiled ambigs to the unicharset used to encode
+// them and to the text that they were parsed from.
+class CompiledAmbigs {
+ public:
+  CompiledAmbigs() : signature_(0) {}
+
+  // Returns the signature of the given encoder unicharset and ambigs file,
+  // which is rewound afterwards. ambigs_file may be NULL for no ambigs.
+  static uinT32 Signature(const UNICHARSET& encoder_set, TFile* ambigs_file);
+
+  uinT32 signature() const { return signature_; }
+  void set_signature(uinT32 signature) { signature_ = signature; }
+
+  int size() const { return types_.size(); }
+  int type(int index) const { return types_[index]; }
+  // The test unichar ids are terminated by INVALID_UNICHAR_ID.
+  const UNICHAR_ID* test_unichar_ids(int index) const {
+    return &test_ids_[test_starts_[index]];
+  }
+  int test_ambig_part_size(int index) const {
+    return test_sizes_[index];
+  }
+  int replacement_ambig_part_size(int index) const {
+    return replacement_sizes_[index];
+  }
+  const char* replacement_string(int index) const {
+    return &replacements_[replacement_starts_[index]];
+  }
+
+  // Appends a parsed ambiguity.
+  void Add(int type, int test_ambig_part_size,
+           const UNICHAR_ID* test_unichar_ids,
+           int replacement_ambig_part_size, const char* replacement_string);
+  void clear();
+
+  // Writes to the given file. Returns false in case of error.
+  bool Serialize(FILE* fp) const;
+  // Reads from the given file. Returns false in case of error.
+  // If swap is true, assumes a big/little-endian swap is needed.
+  bool DeSerialize(bool swap, FILE* fp);
+
+ private:
+  uinT32 signature_;
+  GenericVector<inT32> types_;
+  GenericVector<inT32> test_sizes_;
+  GenericVector<inT32> replacement_sizes_;
+  // Start of each ambiguity in test_ids_ and replacements_.
+  GenericVector<inT32> test_starts_;
+  GenericVector<inT32> replacement_starts_;
+  // The test unichar ids of all the ambiguities, each sequence terminated by
+  // INVALID_UNICHAR_ID.
+  GenericVector<UNICHAR_ID> test_ids_;
+  // The replacement strings of all the ambiguities, each null terminated.
+  GenericVector<char> replacements_;
+};
+
 // AMBIG_TABLE[i] stores a set of ambiguities whose
 // wrong ngram starts with unichar id i.
 typedef GenericVector<AmbigSpec_LIST *> UnicharAmbigsVector;
@@ -158,7 +219,15 @@ class UnicharAmbigs {
                          bool use_ambigs_for_adaption);
 
   // Loads the universal ambigs that are useful for any language.
+  // The universal ambigs are compiled only once for each encoder unicharset
+  // in the process, as parsing them is a large part of the Init time.
   void LoadUniversal(const UNICHARSET& encoder_set, UNICHARSET* unicharset);
+  // Compiles the universal ambigs for the given encoder unicharset.
+  static void CompileUniversal(const UNICHARSET& encoder_set,
+                               CompiledAmbigs* compiled);
+  // Returns the signature that CompileUniversal would give the compiled
+  // ambigs for the given encoder unicharset, without compiling them.
+  static uinT32 UniversalSignature(const UNICHARSET& encoder_set);
 
   // Fills in two ambiguity tables (replaceable and dangerous) with information
   // read from the ambigs file. An ambiguity table is an array of lists.
@@ -176,6 +245,17 @@ class UnicharAmbigs {
                          TFile *ambigs_file, int debug_level,
                          bool use_ambigs_for_adaption, UNICHARSET *unicharset);
 
+  // Parses the ambigs file into compiled, keeping the ambiguities that are
+  // valid for encoder_set. ambigs_file may be NULL for no ambigs.
+  static void CompileUnicharAmbigs(const UNICHARSET& encoder_set,
+                                   TFile *ambigs_file, int debug_level,
+                                   CompiledAmbigs* compiled);
+  // Adds the compiled ambiguities to the tables as LoadUnicharAmbigs does.
+  // The compiled ambigs must have been made with a copy of unicharset as it
+  // was before any ambigs were added.
+  void AddCompiledAmbigs(const CompiledAmbigs& compiled, int debug_level,
+                         bool use_ambigs_for_adaption, UNICHARSET *unicharset);
+
   // Returns definite 1-1 ambigs for the given unichar id.
   inline const UnicharIdVector *OneToOneDefiniteAmbigs(
       UNICHAR_ID unichar_id) const {
@@ -204,14 +284,14 @@ class UnicharAmbigs {
   }
 
  private:
-  bool ParseAmbiguityLine(int line_num, int version, int debug_level,
-                          const UNICHARSET &unicharset, char *buffer,
-                          int *test_ambig_part_size,
-                          UNICHAR_ID *test_unichar_ids,
-                          int *replacement_ambig_part_size,
-                          char *replacement_string, int *type);
-  bool InsertIntoTable(UnicharAmbigsVector &table,
-                       int test_ambig_part_size, UNICHAR_ID *test_unichar_ids,
+  static bool ParseAmbiguityLine(int line_num, int version, int debug_level,
+                                 const UNICHARSET &unicharset, char *buffer,
+                                 int *test_ambig_part_size,
+                                 UNICHAR_ID *test_unichar_ids,
+                                 int *replacement_ambig_part_size,
+                                 char *replacement_string, int *type);
+  bool InsertIntoTable(UnicharAmbigsVector &table, int test_ambig_part_size,
+                       const UNICHAR_ID *test_unichar_ids,
                        int replacement_ambig_part_size,
                        const char *replacement_string, int type,
                        AmbigSpec *ambig_spec, UNICHARSET *unicharset);
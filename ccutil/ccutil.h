@@ -21,6 +21,7 @@
 
 #include "ambigs.h"
 #include "errcode.h"
+#include "pagestats.h"
 #include "strngs.h"
 #include "tessdatamanager.h"
 #include "params.h"
@@ -73,6 +74,8 @@ class CCUtil {
   UnicharAmbigs unichar_ambigs;
   STRING imagefile;  // image file name
   STRING directory;  // main directory
+  // Timing and work counts of the current page.
+  PageStats page_stats;
 
  private:
   ParamsVectors params_;
@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////
+// File:        objectpool.cpp
+// Description: Per-thread recycling of the memory of small objects.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "objectpool.h"
+
+#include <new>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+namespace tesseract {
+
+// Maximum number of blocks kept in a list. Enough for the objects of a
+// long word, without holding on to the memory of a pathological one.
+const int kMaxFreeBlocks = 4096;
+
+// Chain of all the lists that have been used by the current thread.
+static TESS_THREAD_LOCAL FreeBlockList* thread_lists = NULL;
+
+#ifndef _WIN32
+// Key whose destructor releases the blocks of each thread as it exits, so
+// that worker threads that never call ReleaseThreadBlocks do not leak them.
+static pthread_key_t thread_exit_key;
+static pthread_once_t thread_exit_key_once = PTHREAD_ONCE_INIT;
+
+static void ReleaseBlocksAtThreadExit(void*) {
+  FreeBlockList::ReleaseThreadBlocks();
+}
+
+static void CreateThreadExitKey() {
+  pthread_key_create(&thread_exit_key, &ReleaseBlocksAtThreadExit);
+}
+#endif
+
+// Adds the list to the chain of lists of the calling thread.
+static void RegisterList(FreeBlockList* list) {
+  if (thread_lists == NULL) {
+#ifndef _WIN32
+    // The destructor only runs for a thread with a non-NULL value.
+    pthread_once(&thread_exit_key_once, &CreateThreadExitKey);
+    pthread_setspecific(thread_exit_key, &thread_lists);
+#endif
+  }
+  list->next_list = thread_lists;
+  thread_lists = list;
+  list->registered = true;
+}
+
+// Returns a block of the given size, from the list if it is block_size.
+void* FreeBlockList::Alloc(size_t size, size_t block_size,
+                           FreeBlockList* list) {
+  if (size != block_size || list->head == NULL)
+    return ::operator new(size);
+  void* block = list->head;
+  list->head = *static_cast<void**>(block);
+  --list->length;
+  return block;
+}
+
+// Puts a block of the given size back on the list if it is block_size and
+// the list is not full, otherwise returns it to the heap.
+void FreeBlockList::Free(void* block, size_t size, size_t block_size,
+                         FreeBlockList* list) {
+  if (block == NULL)
+    return;
+  if (size != block_size || list->length >= kMaxFreeBlocks) {
+    ::operator delete(block);
+    return;
+  }
+  if (!list->registered)
+    RegisterList(list);
+  *static_cast<void**>(block) = list->head;
+  list->head = block;
+  ++list->length;
+}
+
+// Returns all the free blocks of all the lists of the calling thread to
+// the heap.
+void FreeBlockList::ReleaseThreadBlocks() {
+  for (FreeBlockList* list = thread_lists; list != NULL;
+       list = list->next_list) {
+    while (list->head != NULL) {
+      void* block = list->head;
+      list->head = *static_cast<void**>(block);
+      ::operator delete(block);
+    }
+    list->length = 0;
+  }
+}
+
+}  // namespace tesseract.
@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////
+// File:        objectpool.h
+// Description: Per-thread recycling of the memory of small objects.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_OBJECTPOOL_H_
+#define TESSERACT_CCUTIL_OBJECTPOOL_H_
+
+#include <stddef.h>
+
+// Storage class of a variable that has a separate instance in each thread.
+// Only usable for plain data with a constant (or no) initializer.
+#ifdef _MSC_VER
+#define TESS_THREAD_LOCAL __declspec(thread)
+#else
+#define TESS_THREAD_LOCAL __thread
+#endif
+
+namespace tesseract {
+
+// A list of free memory blocks of a single size, private to one thread, for
+// the class operator new and delete of an object that is made and destroyed
+// in large numbers for every word, such as BLOB_CHOICE or EDGEPT. Recycling
+// the blocks within the thread takes the allocator, and its locks, out of
+// the recognition loop and stops long-lived threads from fragmenting the
+// heap. Each class has a zero-initialized thread-local list:
+//   static TESS_THREAD_LOCAL FreeBlockList my_class_blocks;
+//   void* MyClass::operator new(size_t size) {
+//     return FreeBlockList::Alloc(size, sizeof(MyClass), &my_class_blocks);
+//   }
+//   void MyClass::operator delete(void* block, size_t size) {
+//     FreeBlockList::Free(block, size, sizeof(MyClass), &my_class_blocks);
+//   }
+// Objects of other sizes (derived classes) use the global operator new.
+// A block may be freed by a different thread to the one that allocated it.
+struct FreeBlockList {
+  // Returns a block of the given size, from the list if it is block_size.
+  static void* Alloc(size_t size, size_t block_size, FreeBlockList* list);
+  // Puts a block of the given size back on the list if it is block_size and
+  // the list is not full, otherwise returns it to the heap.
+  static void Free(void* block, size_t size, size_t block_size,
+                   FreeBlockList* list);
+  // Returns all the free blocks of all the lists of the calling thread to
+  // the heap. Called automatically when a thread exits, except on Windows,
+  // where it should be called before a thread that used the lists exits,
+  // as the blocks would otherwise be lost.
+  static void ReleaseThreadBlocks();
+
+  // First free block. The first word of each block points to the next.
+  void* head;
+  // Number of blocks in the list.
+  int length;
+  // Next list used by the same thread.
+  FreeBlockList* next_list;
+  // True once the list is on the chain of lists of its thread.
+  bool registered;
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_CCUTIL_OBJECTPOOL_H_
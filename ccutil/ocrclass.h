@@ -140,6 +140,16 @@ class ETEXT_DESC {             // output header
     }
   }
 
+  // Returns the number of milliseconds left until the end_time, which is
+  // negative once it has passed, or MAX_INT32 if no deadline is set.
+  inT32 msecs_to_deadline() const {
+    if (end_time.tv_sec == 0 && end_time.tv_usec == 0) return MAX_INT32;
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (end_time.tv_sec - now.tv_sec) * 1000 +
+           (end_time.tv_usec - now.tv_usec) / 1000;
+  }
+
   // Returns false if we've not passed the end_time, or have not set a deadline.
   bool deadline_exceeded() const {
     if (end_time.tv_sec == 0 && end_time.tv_usec == 0) return false;
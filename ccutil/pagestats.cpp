@@ -0,0 +1,147 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagestats.cpp
+// Description: Timing of the stages of processing a page, and counts of
+//              the work done.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pagestats.h"
+
+#include <stdio.h>
+#include <time.h>
+#include "ocrclass.h"
+#include "strngs.h"
+
+namespace tesseract {
+
+static const char* kStageNames[PAGE_STAGE_COUNT] = {
+  "threshold", "components", "layout", "textlines", "pass1", "pass2",
+  "adaption", "segsearch", "rejection", "rendering"
+};
+
+static const char* kCounterNames[PAGE_COUNTER_COUNT] = {
+  "blobs_classified", "pain_points", "chops", "static_cache_hits"
+};
+
+// Returns the current wall clock time in seconds.
+static double WallTime() {
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return now.tv_sec + now.tv_usec / 1000000.0;
+}
+
+// Returns the cpu time used by the calling thread in seconds. Where there is
+// no thread cpu clock, it falls back to the cpu time of the whole process.
+static double ThreadCpuTime() {
+#ifdef _WIN32
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time,
+                      &kernel_time, &user_time))
+    return 0.0;
+  ULARGE_INTEGER kernel, user;
+  kernel.LowPart = kernel_time.dwLowDateTime;
+  kernel.HighPart = kernel_time.dwHighDateTime;
+  user.LowPart = user_time.dwLowDateTime;
+  user.HighPart = user_time.dwHighDateTime;
+  // FILETIMEs count in units of 100ns.
+  return (kernel.QuadPart + user.QuadPart) / 10000000.0;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec now;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0)
+    return 0.0;
+  return now.tv_sec + now.tv_nsec / 1000000000.0;
+#else
+  return static_cast<double>(clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+PageStats::PageStats() {
+  Clear();
+}
+
+// Resets all the times and counts to zero.
+void PageStats::Clear() {
+  for (int s = 0; s < PAGE_STAGE_COUNT; ++s)
+    wall_times_[s] = cpu_times_[s] = 0.0;
+  for (int c = 0; c < PAGE_COUNTER_COUNT; ++c)
+    counts_[c] = 0;
+}
+
+// Adds all the times and counts of other to this.
+void PageStats::Add(const PageStats& other) {
+  for (int s = 0; s < PAGE_STAGE_COUNT; ++s) {
+    wall_times_[s] += other.wall_times_[s];
+    cpu_times_[s] += other.cpu_times_[s];
+  }
+  for (int c = 0; c < PAGE_COUNTER_COUNT; ++c)
+    counts_[c] += other.counts_[c];
+}
+
+// Adds the given times in seconds to a stage.
+void PageStats::AddTime(PageStage stage, double wall_time, double cpu_time) {
+  wall_times_[stage] += wall_time;
+  cpu_times_[stage] += cpu_time;
+}
+
+// Adds one to the counter. May be called from several threads at once.
+void PageStats::Increment(PageCounter counter) {
+  #ifdef _WIN32
+  InterlockedIncrement(&counts_[counter]);
+  #else
+  __sync_fetch_and_add(&counts_[counter], 1);
+  #endif
+}
+
+// Returns the name of the stage or counter, as used in the JSON.
+const char* PageStats::StageName(PageStage stage) {
+  return kStageNames[stage];
+}
+
+const char* PageStats::CounterName(PageCounter counter) {
+  return kCounterNames[counter];
+}
+
+// Appends the stats to json as a JSON object.
+void PageStats::ToJSON(STRING* json) const {
+  char buf[128];
+  *json += "{\"stages\":{";
+  for (int s = 0; s < PAGE_STAGE_COUNT; ++s) {
+    snprintf(buf, sizeof(buf), "%s\"%s\":{\"wall\":%.6f,\"cpu\":%.6f}",
+             s > 0 ? "," : "", kStageNames[s], wall_times_[s], cpu_times_[s]);
+    *json += buf;
+  }
+  *json += "},\"counters\":{";
+  for (int c = 0; c < PAGE_COUNTER_COUNT; ++c) {
+    snprintf(buf, sizeof(buf), "%s\"%s\":%ld",
+             c > 0 ? "," : "", kCounterNames[c], counts_[c]);
+    *json += buf;
+  }
+  *json += "}}";
+}
+
+PageStageTimer::PageStageTimer(PageStats* stats, PageStage stage)
+  : stats_(stats), stage_(stage), wall_start_(0.0), cpu_start_(0.0) {
+  if (stats_ != NULL) {
+    wall_start_ = WallTime();
+    cpu_start_ = ThreadCpuTime();
+  }
+}
+
+PageStageTimer::~PageStageTimer() {
+  if (stats_ != NULL) {
+    stats_->AddTime(stage_, WallTime() - wall_start_,
+                    ThreadCpuTime() - cpu_start_);
+  }
+}
+
+}  // namespace tesseract.
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagestats.h
+// Description: Timing of the stages of processing a page, and counts of
+//              the work done.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_PAGESTATS_H_
+#define TESSERACT_CCUTIL_PAGESTATS_H_
+
+#include "host.h"
+#include "platform.h"
+
+class STRING;
+
+namespace tesseract {
+
+// The timed stages of processing a page.
+enum PageStage {
+  PAGE_STAGE_THRESHOLD,   // Thresholding to a binary image.
+  PAGE_STAGE_COMPONENTS,  // Connected component extraction.
+  PAGE_STAGE_LAYOUT,      // Column and block finding (ColumnFinder).
+  PAGE_STAGE_TEXTLINES,   // Textline and word finding (TextordPage).
+  PAGE_STAGE_PASS1,       // Recognition pass 1, including adaption.
+  PAGE_STAGE_PASS2,       // Recognition pass 2.
+  PAGE_STAGE_ADAPTION,    // Training of the adaptive classifier.
+  PAGE_STAGE_SEGSEARCH,   // Segmentation search of the words.
+  PAGE_STAGE_REJECTION,   // Rejection passes.
+  PAGE_STAGE_RENDERING,   // Output by a TessResultRenderer.
+  PAGE_STAGE_COUNT
+};
+
+// The counted units of work.
+enum PageCounter {
+  PAGE_COUNTER_BLOBS_CLASSIFIED,  // Calls to the classifier from wordrec.
+  PAGE_COUNTER_PAIN_POINTS,       // Pain points processed by the seg search.
+  PAGE_COUNTER_CHOPS,             // Attempts to chop a blob.
+  PAGE_COUNTER_STATIC_CACHE_HITS, // Static classifications found in cache.
+  PAGE_COUNTER_COUNT
+};
+
+// Wall and cpu time spent in each stage of processing a page, and counts of
+// the work done, gathered cheaply enough to be left on in production.
+// Some stages run inside others (adaption inside pass 1, segmentation search
+// inside both passes, and component extraction inside textline finding when
+// layout analysis is off), so the times do not add up to the total. The cpu
+// time is that of the thread that ran the stage, so it is not inflated by
+// other engines running on other threads, but it also leaves out the work
+// that the stage itself hands to other threads, such as the OpenMP
+// classification of blobs.
+class TESS_API PageStats {
+ public:
+  PageStats();
+
+  // Resets all the times and counts to zero.
+  void Clear();
+  // Adds all the times and counts of other to this.
+  void Add(const PageStats& other);
+  // Adds the given times in seconds to a stage.
+  void AddTime(PageStage stage, double wall_time, double cpu_time);
+  // Adds one to the counter. May be called from several threads at once.
+  void Increment(PageCounter counter);
+
+  double wall_time(PageStage stage) const {
+    return wall_times_[stage];
+  }
+  double cpu_time(PageStage stage) const {
+    return cpu_times_[stage];
+  }
+  inT64 count(PageCounter counter) const {
+    return counts_[counter];
+  }
+
+  // Returns the name of the stage or counter, as used in the JSON.
+  static const char* StageName(PageStage stage);
+  static const char* CounterName(PageCounter counter);
+
+  // Appends the stats to json as a JSON object of the form:
+  // {"stages":{"threshold":{"wall":0.01,"cpu":0.01},...},
+  //  "counters":{"blobs_classified":1234,...}}
+  void ToJSON(STRING* json) const;
+
+ private:
+  double wall_times_[PAGE_STAGE_COUNT];
+  double cpu_times_[PAGE_STAGE_COUNT];
+  long counts_[PAGE_COUNTER_COUNT];
+};
+
+// Adds the wall and cpu time from its construction to its destruction to a
+// stage of the given PageStats, which may be NULL.
+class TESS_API PageStageTimer {
+ public:
+  PageStageTimer(PageStats* stats, PageStage stage);
+  ~PageStageTimer();
+
+ private:
+  PageStats* stats_;
+  PageStage stage_;
+  double wall_start_;
+  double cpu_start_;
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_CCUTIL_PAGESTATS_H_
@@ -30,6 +30,10 @@
 #define MINUS         '-'
 #define EQUAL         '='
 
+// Initial number of buckets in a ParamsIndex. The index is rehashed to
+// twice the size whenever the number of entries exceeds the buckets.
+const int kNumInitialParamBuckets = 64;
+
 tesseract::ParamsVectors *GlobalParams() {
   static tesseract::ParamsVectors *global_params =
     new tesseract::ParamsVectors();
@@ -38,6 +42,291 @@ tesseract::ParamsVectors *GlobalParams() {
 
 namespace tesseract {
 
+// Splits a line of a params file into the name, which is terminated in
+// place, and the value, which is returned. Returns NULL if the line is
+// blank or a comment.
+static char *SplitParamLine(char *line) {
+  if (line[0] == '\n' || line[0] == '#')
+    return NULL;
+  chomp_string(line);  // remove newline
+  char *valptr;
+  for (valptr = line; *valptr && *valptr != ' ' && *valptr != '\t';
+    valptr++);
+  if (*valptr) {             // found blank
+    *valptr = '\0';          // make name a string
+    do
+      valptr++;              // find end of blanks
+    while (*valptr == ' ' || *valptr == '\t');
+  }
+  return valptr;
+}
+
+ParamsIndex::ParamsIndex() : num_entries_(0) {
+}
+
+// Adds the param, which must not already be in the index.
+void ParamsIndex::Add(Param *param, ParamType type) {
+  if (num_entries_ >= buckets_.size()) {
+    Rehash(buckets_.empty() ? kNumInitialParamBuckets
+                            : buckets_.size() * 2);
+  }
+  Entry entry;
+  entry.param = param;
+  entry.type = type;
+  entry.hash = HashName(param->name_str());
+  buckets_[entry.hash % buckets_.size()].push_back(entry);
+  ++num_entries_;
+}
+
+// Removes the param from the index, if it is there.
+void ParamsIndex::Remove(Param *param) {
+  if (buckets_.empty()) return;
+  GenericVector<Entry> &bucket =
+      buckets_[HashName(param->name_str()) % buckets_.size()];
+  for (int i = 0; i < bucket.size(); ++i) {
+    if (bucket[i].param == param) {
+      bucket.remove(i);
+      --num_entries_;
+      return;
+    }
+  }
+}
+
+// Returns the param of the given name and type, or NULL if there is none.
+Param *ParamsIndex::Find(const char *name, ParamType type) const {
+  if (buckets_.empty()) return NULL;
+  uinT32 hash = HashName(name);
+  const GenericVector<Entry> &bucket = buckets_[hash % buckets_.size()];
+  for (int i = 0; i < bucket.size(); ++i) {
+    const Entry &entry = bucket[i];
+    if (entry.hash == hash && entry.type == type &&
+        strcmp(entry.param->name_str(), name) == 0)
+      return entry.param;
+  }
+  return NULL;
+}
+
+// Returns the hash of the given param name. (FNV-1a.)
+uinT32 ParamsIndex::HashName(const char *name) {
+  uinT32 hash = 2166136261u;
+  for (const unsigned char *p = reinterpret_cast<const unsigned char *>(name);
+       *p != '\0'; ++p) {
+    hash ^= *p;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Redistributes the entries over the given number of buckets.
+void ParamsIndex::Rehash(int num_buckets) {
+  GenericVector<GenericVector<Entry> > old_buckets(buckets_);
+  buckets_.clear();
+  buckets_.init_to_size(num_buckets, GenericVector<Entry>());
+  for (int b = 0; b < old_buckets.size(); ++b) {
+    const GenericVector<Entry> &bucket = old_buckets[b];
+    for (int i = 0; i < bucket.size(); ++i)
+      buckets_[bucket[i].hash % num_buckets].push_back(bucket[i]);
+  }
+}
+
+// Adds the named param(s) with the given value, exactly as SetParam would
+// set them, and returns true if a param of that name was found.
+bool ParamSet::Add(const char *name, const char *value,
+                   SetParamConstraint constraint,
+                   ParamsVectors *member_params) {
+  Setting setting;
+  setting.int_value = 0;
+  setting.double_value = 0.0;
+  // Look for the parameter among string parameters.
+  StringParam *sp =
+      ParamUtils::FindParam<StringParam>(name, member_params);
+  if (sp != NULL && sp->constraint_ok(constraint)) {
+    setting.param = sp;
+    setting.type = PARAM_STRING;
+    setting.string_value = value;
+    settings_.push_back(setting);
+  }
+  if (*value == '\0') return (sp != NULL);
+
+  // Look for the parameter among int parameters.
+  int intval;
+  IntParam *ip = ParamUtils::FindParam<IntParam>(name, member_params);
+  if (ip && ip->constraint_ok(constraint) &&
+      sscanf(value, INT32FORMAT, &intval) == 1) {
+    setting.param = ip;
+    setting.type = PARAM_INT;
+    setting.int_value = intval;
+    settings_.push_back(setting);
+  }
+
+  // Look for the parameter among bool parameters.
+  BoolParam *bp = ParamUtils::FindParam<BoolParam>(name, member_params);
+  if (bp != NULL && bp->constraint_ok(constraint)) {
+    setting.param = bp;
+    setting.type = PARAM_BOOL;
+    if (*value == 'T' || *value == 't' ||
+        *value == 'Y' || *value == 'y' || *value == '1') {
+      setting.int_value = true;
+      settings_.push_back(setting);
+    } else if (*value == 'F' || *value == 'f' ||
+                *value == 'N' || *value == 'n' || *value == '0') {
+      setting.int_value = false;
+      settings_.push_back(setting);
+    }
+  }
+
+  // Look for the parameter among double parameters.
+  double doubleval;
+  DoubleParam *dp = ParamUtils::FindParam<DoubleParam>(name, member_params);
+  if (dp != NULL && dp->constraint_ok(constraint)) {
+    setting.param = dp;
+    setting.type = PARAM_DOUBLE;
+#ifdef EMBEDDED
+      doubleval = strtofloat(value);
+#else
+      if (sscanf(value, "%lf", &doubleval) == 1)
+#endif
+      {
+        setting.double_value = doubleval;
+        settings_.push_back(setting);
+      }
+  }
+  return (sp || ip || bp || dp);
+}
+
+// Adds all the settings in a file of parameter definitions, in the format
+// read by ParamUtils::ReadParamsFile. Returns false if the file could not
+// be read or named an unknown param, in which case the rest of the valid
+// settings are still added.
+bool ParamSet::AddFile(const char *file, SetParamConstraint constraint,
+                       ParamsVectors *member_params) {
+  if (*file == PLUS || *file == MINUS) ++file;
+  FILE *fp = fopen(file, "rb");
+  if (fp == NULL) {
+    tprintf("ParamSet: Can't open %s\n", file);
+    return false;
+  }
+  char line[MAX_PATH];
+  bool ok = true;
+  while (fgets(line, MAX_PATH, fp)) {
+    char *valptr = SplitParamLine(line);
+    if (valptr != NULL && !Add(line, valptr, constraint, member_params)) {
+      tprintf("ParamSet: parameter not found: %s\n", line);
+      ok = false;
+    }
+  }
+  fclose(fp);
+  return ok;
+}
+
+// Adds the current values of all the params in source, which is usually
+// the member_params of another engine, to be set on the params of the same
+// name and type in member_params. The values are copied exactly, without
+// going through strings. Params that are not found in member_params or not
+// allowed by the constraint are skipped.
+void ParamSet::AddValues(const ParamsVectors &source,
+                         SetParamConstraint constraint,
+                         ParamsVectors *member_params) {
+  Setting setting;
+  setting.int_value = 0;
+  setting.double_value = 0.0;
+  for (int i = 0; i < source.int_params.size(); ++i) {
+    setting.param = member_params->index.Find(
+        source.int_params[i]->name_str(), PARAM_INT);
+    if (setting.param == NULL || !setting.param->constraint_ok(constraint))
+      continue;
+    setting.type = PARAM_INT;
+    setting.int_value = *source.int_params[i];
+    settings_.push_back(setting);
+  }
+  for (int i = 0; i < source.bool_params.size(); ++i) {
+    setting.param = member_params->index.Find(
+        source.bool_params[i]->name_str(), PARAM_BOOL);
+    if (setting.param == NULL || !setting.param->constraint_ok(constraint))
+      continue;
+    setting.type = PARAM_BOOL;
+    setting.int_value = static_cast<BOOL8>(*source.bool_params[i]);
+    settings_.push_back(setting);
+  }
+  for (int i = 0; i < source.string_params.size(); ++i) {
+    setting.param = member_params->index.Find(
+        source.string_params[i]->name_str(), PARAM_STRING);
+    if (setting.param == NULL || !setting.param->constraint_ok(constraint))
+      continue;
+    setting.type = PARAM_STRING;
+    setting.string_value = source.string_params[i]->string();
+    settings_.push_back(setting);
+  }
+  setting.string_value = "";
+  for (int i = 0; i < source.double_params.size(); ++i) {
+    setting.param = member_params->index.Find(
+        source.double_params[i]->name_str(), PARAM_DOUBLE);
+    if (setting.param == NULL || !setting.param->constraint_ok(constraint))
+      continue;
+    setting.type = PARAM_DOUBLE;
+    setting.double_value = *source.double_params[i];
+    settings_.push_back(setting);
+  }
+}
+
+// Adds the current values of the params set by changes, so that Apply
+// puts back the values they had before changes was applied. Only the
+// params in changes are visited.
+void ParamSet::AddCurrentValues(const ParamSet &changes) {
+  for (int i = 0; i < changes.settings_.size(); ++i) {
+    Setting setting = changes.settings_[i];
+    switch (setting.type) {
+      case PARAM_INT:
+        setting.int_value = *static_cast<IntParam *>(setting.param);
+        break;
+      case PARAM_BOOL:
+        setting.int_value = static_cast<BOOL8>(
+            *static_cast<BoolParam *>(setting.param));
+        break;
+      case PARAM_STRING:
+        setting.string_value =
+            static_cast<StringParam *>(setting.param)->string();
+        break;
+      case PARAM_DOUBLE:
+        setting.double_value = *static_cast<DoubleParam *>(setting.param);
+        break;
+    }
+    settings_.push_back(setting);
+  }
+}
+
+// Returns true if the set holds a value for the given param.
+bool ParamSet::Contains(const Param *param) const {
+  for (int i = 0; i < settings_.size(); ++i) {
+    if (settings_[i].param == param) return true;
+  }
+  return false;
+}
+
+// Sets all the params to their values, in the order they were added.
+void ParamSet::Apply() const {
+  for (int i = 0; i < settings_.size(); ++i) {
+    const Setting &setting = settings_[i];
+    switch (setting.type) {
+      case PARAM_INT:
+        static_cast<IntParam *>(setting.param)->set_value(setting.int_value);
+        break;
+      case PARAM_BOOL:
+        static_cast<BoolParam *>(setting.param)->set_value(
+            setting.int_value != 0);
+        break;
+      case PARAM_STRING:
+        static_cast<StringParam *>(setting.param)->set_value(
+            setting.string_value);
+        break;
+      case PARAM_DOUBLE:
+        static_cast<DoubleParam *>(setting.param)->set_value(
+            setting.double_value);
+        break;
+    }
+  }
+}
+
 bool ParamUtils::ReadParamsFile(const char *file,
                                 SetParamConstraint constraint,
                                 ParamsVectors *member_params) {
@@ -69,22 +358,12 @@ bool ParamUtils::ReadParamsFromFp(FILE *fp, inT64 end_offset,
   char line[MAX_PATH];           // input line
   bool anyerr = false;           // true if any error
   bool foundit;                  // found parameter
-  inT16 length;                  // length of line
   char *valptr;                  // value field
 
   while ((end_offset < 0 || ftell(fp) < end_offset) &&
          fgets(line, MAX_PATH, fp)) {
-    if (line[0] != '\n' && line[0] != '#') {
-      length = strlen (line);
-      chomp_string(line);  // remove newline
-      for (valptr = line; *valptr && *valptr != ' ' && *valptr != '\t';
-        valptr++);
-      if (*valptr) {             // found blank
-        *valptr = '\0';          // make name a string
-        do
-          valptr++;              // find end of blanks
-        while (*valptr == ' ' || *valptr == '\t');
-      }
+    valptr = SplitParamLine(line);
+    if (valptr != NULL) {
       foundit = SetParam(line, valptr, constraint, member_params);
 
       if (!foundit) {
@@ -101,21 +380,18 @@ bool ParamUtils::SetParam(const char *name, const char* value,
                           SetParamConstraint constraint,
                           ParamsVectors *member_params) {
   // Look for the parameter among string parameters.
-  StringParam *sp = FindParam<StringParam>(name, GlobalParams()->string_params,
-                                           member_params->string_params);
+  StringParam *sp = FindParam<StringParam>(name, member_params);
   if (sp != NULL && sp->constraint_ok(constraint)) sp->set_value(value);
   if (*value == '\0') return (sp != NULL);
 
   // Look for the parameter among int parameters.
   int intval;
-  IntParam *ip = FindParam<IntParam>(name, GlobalParams()->int_params,
-                                     member_params->int_params);
+  IntParam *ip = FindParam<IntParam>(name, member_params);
   if (ip && ip->constraint_ok(constraint) &&
       sscanf(value, INT32FORMAT, &intval) == 1) ip->set_value(intval);
 
   // Look for the parameter among bool parameters.
-  BoolParam *bp = FindParam<BoolParam>(name, GlobalParams()->bool_params,
-                                       member_params->bool_params);
+  BoolParam *bp = FindParam<BoolParam>(name, member_params);
   if (bp != NULL && bp->constraint_ok(constraint)) {
     if (*value == 'T' || *value == 't' ||
         *value == 'Y' || *value == 'y' || *value == '1') {
@@ -128,8 +404,7 @@ bool ParamUtils::SetParam(const char *name, const char* value,
 
   // Look for the parameter among double parameters.
   double doubleval;
-  DoubleParam *dp = FindParam<DoubleParam>(name, GlobalParams()->double_params,
-                                           member_params->double_params);
+  DoubleParam *dp = FindParam<DoubleParam>(name, member_params);
   if (dp != NULL && dp->constraint_ok(constraint)) {
 #ifdef EMBEDDED
       doubleval = strtofloat(value);
@@ -141,19 +416,27 @@ bool ParamUtils::SetParam(const char *name, const char* value,
   return (sp || ip || bp || dp);
 }
 
+// Returns the param of the given name and type among the global params or
+// the given member_params, which may be NULL.
+Param *ParamUtils::FindParamOfType(const char *name, ParamType type,
+                                   const ParamsVectors *member_params) {
+  Param *param = GlobalParams()->index.Find(name, type);
+  if (param == NULL && member_params != NULL)
+    param = member_params->index.Find(name, type);
+  return param;
+}
+
 bool ParamUtils::GetParamAsString(const char *name,
                                   const ParamsVectors* member_params,
                                   STRING *value) {
   // Look for the parameter among string parameters.
-  StringParam *sp = FindParam<StringParam>(name, GlobalParams()->string_params,
-                                           member_params->string_params);
+  StringParam *sp = FindParam<StringParam>(name, member_params);
   if (sp) {
     *value = sp->string();
     return true;
   }
   // Look for the parameter among int parameters.
-  IntParam *ip = FindParam<IntParam>(name, GlobalParams()->int_params,
-                                     member_params->int_params);
+  IntParam *ip = FindParam<IntParam>(name, member_params);
   if (ip) {
     char buf[128];
     snprintf(buf, sizeof(buf), "%d", inT32(*ip));
@@ -161,15 +444,13 @@ bool ParamUtils::GetParamAsString(const char *name,
     return true;
   }
   // Look for the parameter among bool parameters.
-  BoolParam *bp = FindParam<BoolParam>(name, GlobalParams()->bool_params,
-                                       member_params->bool_params);
+  BoolParam *bp = FindParam<BoolParam>(name, member_params);
   if (bp != NULL) {
     *value = BOOL8(*bp) ? "1": "0";
     return true;
   }
   // Look for the parameter among double parameters.
-  DoubleParam *dp = FindParam<DoubleParam>(name, GlobalParams()->double_params,
-                                           member_params->double_params);
+  DoubleParam *dp = FindParam<DoubleParam>(name, member_params);
   if (dp != NULL) {
     char buf[128];
     snprintf(buf, sizeof(buf), "%g", double(*dp));
@@ -27,10 +27,12 @@
 
 namespace tesseract {
 
+class Param;
 class IntParam;
 class BoolParam;
 class StringParam;
 class DoubleParam;
+struct ParamsVectors;
 
 // Enum for constraints on what kind of params should be set by SetParam().
 enum SetParamConstraint {
@@ -40,11 +42,113 @@ enum SetParamConstraint {
   SET_PARAM_CONSTRAINT_NON_INIT_ONLY,
 };
 
+// Enum for the type of a param, as held in a ParamsIndex.
+enum ParamType {
+  PARAM_INT,
+  PARAM_BOOL,
+  PARAM_STRING,
+  PARAM_DOUBLE,
+};
+
+// Hash table of params by name, so that they can be found without comparing
+// the name against every param in a ParamsVectors. The names are not copied,
+// as the name of a param is always a string literal, and the hash of each
+// name is computed only once, when the param is added.
+class ParamsIndex {
+ public:
+  ParamsIndex();
+
+  // Adds the param, which must not already be in the index.
+  void Add(Param *param, ParamType type);
+  // Removes the param from the index, if it is there.
+  void Remove(Param *param);
+  // Returns the param of the given name and type, or NULL if there is none.
+  Param *Find(const char *name, ParamType type) const;
+
+  int size() const {
+    return num_entries_;
+  }
+
+ private:
+  struct Entry {
+    Param *param;
+    ParamType type;
+    uinT32 hash;
+  };
+
+  // Returns the hash of the given param name.
+  static uinT32 HashName(const char *name);
+  // Redistributes the entries over the given number of buckets.
+  void Rehash(int num_buckets);
+
+  GenericVector<GenericVector<Entry> > buckets_;
+  int num_entries_;
+};
+
 struct ParamsVectors {
   GenericVector<IntParam *> int_params;
   GenericVector<BoolParam *> bool_params;
   GenericVector<StringParam *> string_params;
   GenericVector<DoubleParam *> double_params;
+  // Index of all the above by name.
+  ParamsIndex index;
+};
+
+// A list of param values resolved ahead of time against the global params
+// and a particular ParamsVectors, so that they can be applied repeatedly,
+// for example to switch an engine between a few configurations, without
+// any name lookups, value parsing or file reading. The params that were
+// resolved must outlive the ParamSet.
+class ParamSet {
+ public:
+  // Adds the named param(s) with the given value, exactly as SetParam would
+  // set them, and returns true if a param of that name was found.
+  bool Add(const char *name, const char *value,
+           SetParamConstraint constraint,
+           ParamsVectors *member_params);
+  // Adds all the settings in a file of parameter definitions, in the format
+  // read by ParamUtils::ReadParamsFile. Returns false if the file could not
+  // be read or named an unknown param, in which case the rest of the valid
+  // settings are still added.
+  bool AddFile(const char *file, SetParamConstraint constraint,
+               ParamsVectors *member_params);
+  // Adds the current values of all the params in source, which is usually
+  // the member_params of another engine, to be set on the params of the same
+  // name and type in member_params. The values are copied exactly, without
+  // going through strings. Params that are not found in member_params or not
+  // allowed by the constraint are skipped.
+  void AddValues(const ParamsVectors &source, SetParamConstraint constraint,
+                 ParamsVectors *member_params);
+  // Adds the current values of the params set by changes, so that Apply
+  // puts back the values they had before changes was applied. Only the
+  // params in changes are visited.
+  void AddCurrentValues(const ParamSet &changes);
+  // Returns true if the set holds a value for the given param.
+  bool Contains(const Param *param) const;
+  // Sets all the params to their values, in the order they were added.
+  void Apply() const;
+
+  int size() const {
+    return settings_.size();
+  }
+  bool empty() const {
+    return settings_.empty();
+  }
+  void clear() {
+    settings_.clear();
+  }
+
+ private:
+  struct Setting {
+    Param *param;
+    ParamType type;
+    // The value of an int or bool param.
+    inT32 int_value;
+    double double_value;
+    STRING string_value;
+  };
+
+  GenericVector<Setting> settings_;
 };
 
 // Utility functions for working with Tesseract parameters.
@@ -71,6 +175,17 @@ class ParamUtils {
                        ParamsVectors *member_params);
 
   // Returns the pointer to the parameter with the given name (of the
+  // appropriate type) if it was found in the global params or in the
+  // given member_params, which may be NULL. Uses the index of each
+  // ParamsVectors, so it is much faster than the version below.
+  template<class T>
+  static T *FindParam(const char *name, const ParamsVectors *member_params) {
+    return static_cast<T *>(FindParamOfType(name, T::kType, member_params));
+  }
+  // As above, but only for the given type.
+  static Param *FindParamOfType(const char *name, ParamType type,
+                                const ParamsVectors *member_params);
+  // Returns the pointer to the parameter with the given name (of the
   // appropriate type) if it was found in the vector obtained from
   // GlobalParams() or in the given member_params.
   template<class T>
@@ -130,7 +245,7 @@ class Param {
 
  protected:
   Param(const char *name, const char *comment, bool init) :
-    name_(name), info_(comment), init_(init) {
+    name_(name), info_(comment), init_(init), index_(NULL) {
     debug_ = (strstr(name, "debug") != NULL) || (strstr(name, "display"));
   }
 
@@ -138,18 +253,27 @@ class Param {
   const char *info_;      // for menus
   bool init_;             // needs to be set before init
   bool debug_;
+  // The index that holds this param (not owned by this class).
+  ParamsIndex *index_;
 };
 
 class IntParam : public Param {
   public:
+   static const ParamType kType = PARAM_INT;
+
    IntParam(inT32 value, const char *name, const char *comment, bool init,
             ParamsVectors *vec) : Param(name, comment, init) {
     value_ = value;
     default_ = value;
     params_vec_ = &(vec->int_params);
     vec->int_params.push_back(this);
+    index_ = &(vec->index);
+    index_->Add(this, kType);
+  }
+  ~IntParam() {
+    ParamUtils::RemoveParam<IntParam>(this, params_vec_);
+    index_->Remove(this);
   }
-  ~IntParam() { ParamUtils::RemoveParam<IntParam>(this, params_vec_); }
   operator inT32() const { return value_; }
   void operator=(inT32 value) { value_ = value; }
   void set_value(inT32 value) { value_ = value; }
@@ -166,14 +290,21 @@ class IntParam : public Param {
 
 class BoolParam : public Param {
  public:
+  static const ParamType kType = PARAM_BOOL;
+
   BoolParam(bool value, const char *name, const char *comment, bool init,
             ParamsVectors *vec) : Param(name, comment, init) {
     value_ = value;
     default_ = value;
     params_vec_ = &(vec->bool_params);
     vec->bool_params.push_back(this);
+    index_ = &(vec->index);
+    index_->Add(this, kType);
+  }
+  ~BoolParam() {
+    ParamUtils::RemoveParam<BoolParam>(this, params_vec_);
+    index_->Remove(this);
   }
-  ~BoolParam() { ParamUtils::RemoveParam<BoolParam>(this, params_vec_); }
   operator BOOL8() const { return value_; }
   void operator=(BOOL8 value) { value_ = value; }
   void set_value(BOOL8 value) { value_ = value; }
@@ -190,6 +321,8 @@ class BoolParam : public Param {
 
 class StringParam : public Param {
  public:
+  static const ParamType kType = PARAM_STRING;
+
   StringParam(const char *value, const char *name,
               const char *comment, bool init,
               ParamsVectors *vec) : Param(name, comment, init) {
@@ -197,8 +330,13 @@ class StringParam : public Param {
     default_ = value;
     params_vec_ = &(vec->string_params);
     vec->string_params.push_back(this);
+    index_ = &(vec->index);
+    index_->Add(this, kType);
+  }
+  ~StringParam() {
+    ParamUtils::RemoveParam<StringParam>(this, params_vec_);
+    index_->Remove(this);
   }
-  ~StringParam() { ParamUtils::RemoveParam<StringParam>(this, params_vec_); }
   operator STRING &() { return value_; }
   const char *string() const { return value_.string(); }
   const char *c_str() const { return value_.string(); }
@@ -219,14 +357,21 @@ class StringParam : public Param {
 
 class DoubleParam : public Param {
  public:
+  static const ParamType kType = PARAM_DOUBLE;
+
   DoubleParam(double value, const char *name, const char *comment,
               bool init, ParamsVectors *vec) : Param(name, comment, init) {
     value_ = value;
     default_ = value;
     params_vec_ = &(vec->double_params);
     vec->double_params.push_back(this);
+    index_ = &(vec->index);
+    index_->Add(this, kType);
+  }
+  ~DoubleParam() {
+    ParamUtils::RemoveParam<DoubleParam>(this, params_vec_);
+    index_->Remove(this);
   }
-  ~DoubleParam() { ParamUtils::RemoveParam<DoubleParam>(this, params_vec_); }
   operator double() const { return value_; }
   void operator=(double value) { value_ = value; }
   void set_value(double value) { value_ = value; }
@@ -30,33 +30,27 @@
 #include          "tprintf.h"
 
 #define MAX_MSG_LEN     65536
+// Messages up to this length are formatted on the stack.
+#define SHORT_MSG_LEN   1024
 
 #define EXTERN
 // Since tprintf is protected by a mutex, these parameters can remain global.
 DLLSYM STRING_VAR(debug_file, "", "File to send tprintf output to");
+DLLSYM INT_VAR(log_level, MAX_INT32,
+               "Logging level: only tprintf_level messages below it are"
+               " printed");
 
-DLLSYM void
-tprintf_internal(                       // Trace printf
-    const char *format, ...             // Message
-) {
+// Number of messages suppressed by tprintf_level.
+static volatile long suppressed_count = 0;
+
+// Writes a formatted message to the debug file or stderr.
+static void tprintf_write(const char *msg) {
   tesseract::tprintfMutex.Lock();
-  va_list args;                  // variable args
   static FILE *debugfp = NULL;   // debug file
-                                 // debug window
-  inT32 offset = 0;              // into message
-  static char msg[MAX_MSG_LEN + 1];
-
-  va_start(args, format);  // variable list
-  // Format into msg
   #ifdef _WIN32
-  offset += _vsnprintf(msg + offset, MAX_MSG_LEN - offset, format, args);
   if (strcmp(debug_file.string(), "/dev/null") == 0)
     debug_file.set_value("nul");
-  #else
-  offset += vsnprintf(msg + offset, MAX_MSG_LEN - offset, format, args);
   #endif
-  va_end(args);
-
   if (debugfp == NULL && strlen(debug_file.string()) > 0) {
     debugfp = fopen(debug_file.string(), "wb");
   } else if (debugfp != NULL && strlen(debug_file.string()) == 0) {
@@ -64,8 +58,62 @@ tprintf_internal(                       // Trace printf
     debugfp = NULL;
   }
   if (debugfp != NULL)
-    fprintf(debugfp, "%s", msg);
+    fputs(msg, debugfp);
   else
-    fprintf(stderr, "%s", msg);
+    fputs(msg, stderr);
   tesseract::tprintfMutex.Unlock();
 }
+
+// The message is formatted into a buffer of the calling thread, on the stack
+// if it is short, so that only the output itself is done under the mutex,
+// and threads printing at the same time do not wait for each other's
+// formatting.
+DLLSYM void
+tprintf_internal(                       // Trace printf
+    const char *format, ...             // Message
+) {
+  va_list args;                  // variable args
+  char short_msg[SHORT_MSG_LEN];
+  va_start(args, format);  // variable list
+  // Format into msg
+  #ifdef _WIN32
+  int length = _vsnprintf(short_msg, SHORT_MSG_LEN, format, args);
+  #else
+  int length = vsnprintf(short_msg, SHORT_MSG_LEN, format, args);
+  #endif
+  va_end(args);
+  if (length >= 0 && length < SHORT_MSG_LEN) {
+    tprintf_write(short_msg);
+    return;
+  }
+  // Too long for the stack, or (on Windows) of unknown length.
+  char *msg = new char[MAX_MSG_LEN + 1];
+  va_start(args, format);
+  #ifdef _WIN32
+  _vsnprintf(msg, MAX_MSG_LEN, format, args);
+  #else
+  vsnprintf(msg, MAX_MSG_LEN, format, args);
+  #endif
+  va_end(args);
+  msg[MAX_MSG_LEN] = '\0';
+  tprintf_write(msg);
+  delete [] msg;
+}
+
+// Counts a message suppressed by tprintf_level.
+DLLSYM void tprintf_suppress() {
+  #ifdef _WIN32
+  InterlockedIncrement(&suppressed_count);
+  #else
+  __sync_fetch_and_add(&suppressed_count, 1);
+  #endif
+}
+
+// Returns the number of messages suppressed by tprintf_level so far.
+DLLSYM inT64 tprintf_suppressed() {
+  #ifdef _WIN32
+  return InterlockedCompareExchange(&suppressed_count, 0, 0);
+  #else
+  return __sync_fetch_and_add(&suppressed_count, 0);
+  #endif
+}
@@ -27,10 +27,44 @@ extern DLLSYM STRING_VAR_H(debug_file, "",
 extern DLLSYM BOOL_VAR_H(debug_window_on, TRUE,
                          "Send tprintf to window unless file set");
 
+extern DLLSYM INT_VAR_H(log_level, MAX_INT32,
+                        "Logging level: only tprintf_level messages below it are"
+                        " printed");
+
+// Messages of level TESS_MAX_LOG_LEVEL and above are compiled out of
+// tprintf_level.
+#ifndef TESS_MAX_LOG_LEVEL
+#define TESS_MAX_LOG_LEVEL MAX_INT32
+#endif
+
 // Main logging function.
 #define tprintf(...) tprintf_internal(__VA_ARGS__)
 
+// Logging function for messages of a given level, printed only if the level
+// is below both TESS_MAX_LOG_LEVEL and log_level. Messages at or above
+// TESS_MAX_LOG_LEVEL cost nothing. Messages filtered by log_level are not
+// formatted, and are counted by tprintf_suppressed.
+// Not to be confused with tlog in training/tlog.h, which is guarded by
+// FLAGS_tlog_level.
+#if TESS_MAX_LOG_LEVEL <= 0
+#define tprintf_level(level, ...) do {} while (0)
+#else
+#define tprintf_level(level, ...) do { \
+  if ((level) < TESS_MAX_LOG_LEVEL) { \
+    if ((level) < log_level) \
+      tprintf_internal(__VA_ARGS__); \
+    else \
+      tprintf_suppress(); \
+  } \
+} while (0)
+#endif
+
 extern TESS_API void tprintf_internal(  // Trace printf
     const char *format, ...);           // Message
 
+// Counts a message suppressed by tprintf_level.
+extern TESS_API void tprintf_suppress();
+// Returns the number of messages suppressed by tprintf_level so far.
+extern TESS_API inT64 tprintf_suppressed();
+
 #endif  // define TESSERACT_CCUTIL_TPRINTF_H
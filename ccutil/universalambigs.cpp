@@ -21367,4 +21367,8 @@ extern const char kUniversalAmbigsFile[] = {
 
 extern const int ksizeofUniversalAmbigsFile = sizeof(kUniversalAmbigsFile);
 
+// FNV-1a hash of all the bytes of kUniversalAmbigsFile, so the text does not
+// have to be hashed at run time. Must be regenerated along with the data.
+extern const unsigned int kUniversalAmbigsHash = 0x61850b28u;
+
 }  // namespace tesseract
@@ -22,5 +22,6 @@ namespace tesseract {
 
 extern const char kUniversalAmbigsFile[];
 extern const int ksizeofUniversalAmbigsFile;
+extern const unsigned int kUniversalAmbigsHash;
 
 }  // namespace tesseract
@@ -29,6 +29,7 @@
 #include <assert.h>
 #endif
 #include <stdio.h>
+#include <string.h>
 
 /*----------------------------------------------------------------------------
               Public Code
@@ -360,7 +361,8 @@ namespace tesseract {
  * a ptr to the templates.
  *
  * @param File  open text file to read adapted templates from
- * @return Ptr to adapted templates read from File.
+ * @return Ptr to adapted templates read from File, or NULL if the
+ * integer templates in File are invalid.
  *
  * @note Globals: none
  * @note Exceptions: none
@@ -374,8 +376,13 @@ ADAPT_TEMPLATES Classify::ReadAdaptedTemplates(FILE *File) {
   Templates = (ADAPT_TEMPLATES) Emalloc (sizeof (ADAPT_TEMPLATES_STRUCT));
   fread ((char *) Templates, sizeof (ADAPT_TEMPLATES_STRUCT), 1, File);
 
-  /* then read in the basic integer templates */
+  /* then read in the basic integer templates, which must be able to grow */
   Templates->Templates = ReadIntTemplates (File);
+  if (Templates->Templates == NULL) {
+    Efree(Templates);
+    return NULL;
+  }
+  UnpackIntTemplates(Templates->Templates);
 
   /* then read in the adaptive info for each class */
   for (i = 0; i < (Templates->Templates)->NumClasses; i++) {
@@ -517,6 +524,332 @@ void Classify::WriteAdaptedTemplates(FILE *File, ADAPT_TEMPLATES Templates) {
       Templates->Templates->Class[i]->NumConfigs);
   }
 }                                /* WriteAdaptedTemplates */
+
+// Identifies a buffer made by SerializeAdaptedTemplates.
+const inT32 kAdaptedTemplatesMagic = 0x41545332;  // "ATS2"
+
+// Appends size bytes from src to the end of data.
+static void AppendToBuffer(const void *src, int size,
+                           GenericVector<char> *data) {
+  const char *bytes = static_cast<const char *>(src);
+  data->reserve(data->size() + size);
+  for (int i = 0; i < size; i++)
+    data->push_back(bytes[i]);
+}
+
+// Reads a buffer made by SerializeAdaptedTemplates, failing instead of
+// reading past the end.
+class TemplatesReader {
+ public:
+  explicit TemplatesReader(const GenericVector<char> &data)
+    : data_(data), offset_(0) {}
+
+  // Copies size bytes to dest, or returns false if there are not enough.
+  bool Read(void *dest, int size) {
+    if (size < 0 || size > data_.size() - offset_)
+      return false;
+    if (size > 0)
+      memcpy(dest, &data_[offset_], size);
+    offset_ += size;
+    return true;
+  }
+  bool AtEnd() const {
+    return offset_ == data_.size();
+  }
+
+ private:
+  const GenericVector<char> &data_;
+  int offset_;
+};
+
+// Writes the nonzero words of a class pruner, which is almost empty in a
+// set of adapted templates, as index, value pairs.
+static void WriteSparseClassPruner(const CLASS_PRUNER_STRUCT *Pruner,
+                                   GenericVector<char> *data) {
+  const uinT32 *words = &Pruner->p[0][0][0][0];
+  inT32 NumWords = sizeof(*Pruner) / sizeof(*words);
+  inT32 NumSet = 0;
+  for (int i = 0; i < NumWords; i++)
+    if (words[i] != 0) ++NumSet;
+  AppendToBuffer(&NumSet, sizeof(NumSet), data);
+  for (inT32 i = 0; i < NumWords; i++) {
+    if (words[i] != 0) {
+      AppendToBuffer(&i, sizeof(i), data);
+      AppendToBuffer(&words[i], sizeof(words[i]), data);
+    }
+  }
+}
+
+// Reads a class pruner written by WriteSparseClassPruner.
+static bool ReadSparseClassPruner(TemplatesReader *reader,
+                                  CLASS_PRUNER_STRUCT *Pruner) {
+  uinT32 *words = &Pruner->p[0][0][0][0];
+  inT32 NumWords = sizeof(*Pruner) / sizeof(*words);
+  memset(Pruner, 0, sizeof(*Pruner));
+  inT32 NumSet;
+  if (!reader->Read(&NumSet, sizeof(NumSet)) ||
+      NumSet < 0 || NumSet > NumWords)
+    return false;
+  for (int i = 0; i < NumSet; i++) {
+    inT32 index;
+    if (!reader->Read(&index, sizeof(index)) ||
+        index < 0 || index >= NumWords ||
+        !reader->Read(&words[index], sizeof(words[index])))
+      return false;
+  }
+  return true;
+}
+
+// Writes the protos and configs of an adapted integer class that are in
+// use, leaving out the empty tail of the proto sets.
+static void WriteCompactIntClass(INT_CLASS Class, GenericVector<char> *data) {
+  AppendToBuffer(&Class->NumProtos, sizeof(Class->NumProtos), data);
+  AppendToBuffer(&Class->NumProtoSets, sizeof(Class->NumProtoSets), data);
+  AppendToBuffer(&Class->NumConfigs, sizeof(Class->NumConfigs), data);
+  AppendToBuffer(Class->ConfigLengths,
+                 sizeof(Class->ConfigLengths[0]) * Class->NumConfigs, data);
+  AppendToBuffer(Class->ProtoLengths,
+                 sizeof(Class->ProtoLengths[0]) * Class->NumProtos, data);
+  int NumUsedSets =
+    (Class->NumProtos + PROTOS_PER_PROTO_SET - 1) / PROTOS_PER_PROTO_SET;
+  for (int i = 0; i < NumUsedSets; i++)
+    AppendToBuffer(Class->ProtoSets[i], sizeof(PROTO_SET_STRUCT), data);
+}
+
+// Reads an integer class written by WriteCompactIntClass, or returns NULL
+// if the class is invalid.
+static INT_CLASS ReadCompactIntClass(TemplatesReader *reader) {
+  uinT16 NumProtos;
+  uinT8 NumProtoSets;
+  uinT8 NumConfigs;
+  if (!reader->Read(&NumProtos, sizeof(NumProtos)) ||
+      !reader->Read(&NumProtoSets, sizeof(NumProtoSets)) ||
+      !reader->Read(&NumConfigs, sizeof(NumConfigs)) ||
+      NumProtoSets > MAX_NUM_PROTO_SETS || NumConfigs > MAX_NUM_CONFIGS ||
+      NumProtos > NumProtoSets * PROTOS_PER_PROTO_SET)
+    return NULL;
+  INT_CLASS Class = NewIntClass(NumProtoSets * PROTOS_PER_PROTO_SET,
+                                NumConfigs);
+  Class->NumProtos = NumProtos;
+  Class->NumConfigs = NumConfigs;
+  int NumUsedSets = (NumProtos + PROTOS_PER_PROTO_SET - 1) /
+      PROTOS_PER_PROTO_SET;
+  bool ok = reader->Read(Class->ConfigLengths,
+                         sizeof(Class->ConfigLengths[0]) * NumConfigs) &&
+            reader->Read(Class->ProtoLengths,
+                         sizeof(Class->ProtoLengths[0]) * NumProtos);
+  for (int i = 0; ok && i < NumUsedSets; i++)
+    ok = reader->Read(Class->ProtoSets[i], sizeof(PROTO_SET_STRUCT));
+  if (!ok) {
+    free_int_class(Class);
+    return NULL;
+  }
+  return Class;
+}
+
+// Writes the adaptive part of a class field by field, so that none of its
+// pointers end up in the buffer.
+static void WriteCompactAdaptedClass(ADAPT_CLASS Class, int NumConfigs,
+                                     GenericVector<char> *data) {
+  AppendToBuffer(&Class->NumPermConfigs, sizeof(Class->NumPermConfigs), data);
+  AppendToBuffer(&Class->MaxNumTimesSeen, sizeof(Class->MaxNumTimesSeen),
+                 data);
+  AppendToBuffer(Class->PermProtos,
+                 sizeof(uinT32) * WordsInVectorOfSize(MAX_NUM_PROTOS), data);
+  AppendToBuffer(Class->PermConfigs,
+                 sizeof(uinT32) * WordsInVectorOfSize(MAX_NUM_CONFIGS), data);
+  inT32 NumTempProtos = count(Class->TempProtos);
+  AppendToBuffer(&NumTempProtos, sizeof(NumTempProtos), data);
+  LIST TempProtos = Class->TempProtos;
+  iterate(TempProtos) {
+    AppendToBuffer(first_node(TempProtos), sizeof(TEMP_PROTO_STRUCT), data);
+  }
+  for (int i = 0; i < NumConfigs; i++) {
+    if (ConfigIsPermanent(Class, i)) {
+      PERM_CONFIG Config = PermConfigFor(Class, i);
+      uinT8 NumAmbigs = 0;
+      while (Config->Ambigs[NumAmbigs] > 0) ++NumAmbigs;
+      AppendToBuffer(&NumAmbigs, sizeof(NumAmbigs), data);
+      AppendToBuffer(Config->Ambigs, sizeof(UNICHAR_ID) * NumAmbigs, data);
+      AppendToBuffer(&Config->FontinfoId, sizeof(Config->FontinfoId), data);
+    } else {
+      TEMP_CONFIG Config = TempConfigFor(Class, i);
+      inT32 MaxProtoId = Config->MaxProtoId;
+      AppendToBuffer(&Config->NumTimesSeen, sizeof(Config->NumTimesSeen),
+                     data);
+      AppendToBuffer(&MaxProtoId, sizeof(MaxProtoId), data);
+      AppendToBuffer(&Config->FontinfoId, sizeof(Config->FontinfoId), data);
+      AppendToBuffer(Config->Protos, sizeof(uinT32) * Config->ProtoVectorSize,
+                     data);
+    }
+  }
+}
+
+// Reads the adaptive part of a class written by WriteCompactAdaptedClass,
+// which must have NumConfigs configs, or returns NULL if the class is
+// invalid.
+static ADAPT_CLASS ReadCompactAdaptedClass(TemplatesReader *reader,
+                                           int NumConfigs) {
+  ADAPT_CLASS Class = NewAdaptedClass();
+  inT32 NumTempProtos;
+  bool ok =
+    reader->Read(&Class->NumPermConfigs, sizeof(Class->NumPermConfigs)) &&
+    reader->Read(&Class->MaxNumTimesSeen, sizeof(Class->MaxNumTimesSeen)) &&
+    reader->Read(Class->PermProtos,
+                 sizeof(uinT32) * WordsInVectorOfSize(MAX_NUM_PROTOS)) &&
+    reader->Read(Class->PermConfigs,
+                 sizeof(uinT32) * WordsInVectorOfSize(MAX_NUM_CONFIGS)) &&
+    reader->Read(&NumTempProtos, sizeof(NumTempProtos)) &&
+    NumTempProtos >= 0 && NumTempProtos <= MAX_NUM_PROTOS &&
+    NumConfigs <= MAX_NUM_CONFIGS;
+  for (int i = 0; ok && i < NumTempProtos; i++) {
+    TEMP_PROTO TempProto = NewTempProto();
+    ok = reader->Read(TempProto, sizeof(*TempProto)) &&
+        TempProto->ProtoId < MAX_NUM_PROTOS;
+    if (ok)
+      Class->TempProtos = push_last(Class->TempProtos, TempProto);
+    else
+      FreeTempProto(TempProto);
+  }
+  for (int i = 0; ok && i < NumConfigs; i++) {
+    if (ConfigIsPermanent(Class, i)) {
+      uinT8 NumAmbigs;
+      ok = reader->Read(&NumAmbigs, sizeof(NumAmbigs));
+      if (!ok)
+        break;
+      PERM_CONFIG Config =
+        (PERM_CONFIG) alloc_struct(sizeof(PERM_CONFIG_STRUCT),
+                                   "PERM_CONFIG_STRUCT");
+      Config->Ambigs = new UNICHAR_ID[NumAmbigs + 1];
+      Config->Ambigs[NumAmbigs] = -1;
+      PermConfigFor(Class, i) = Config;
+      ok = reader->Read(Config->Ambigs, sizeof(UNICHAR_ID) * NumAmbigs) &&
+          reader->Read(&Config->FontinfoId, sizeof(Config->FontinfoId));
+    } else {
+      uinT8 NumTimesSeen;
+      inT32 MaxProtoId;
+      int FontinfoId;
+      ok = reader->Read(&NumTimesSeen, sizeof(NumTimesSeen)) &&
+          reader->Read(&MaxProtoId, sizeof(MaxProtoId)) &&
+          reader->Read(&FontinfoId, sizeof(FontinfoId)) &&
+          MaxProtoId >= 0 && MaxProtoId < MAX_NUM_PROTOS;
+      if (!ok)
+        break;
+      TEMP_CONFIG Config = NewTempConfig(MaxProtoId, FontinfoId);
+      Config->NumTimesSeen = NumTimesSeen;
+      TempConfigFor(Class, i) = Config;
+      ok = reader->Read(Config->Protos,
+                        sizeof(uinT32) * Config->ProtoVectorSize);
+    }
+  }
+  if (!ok) {
+    free_adapted_class(Class);
+    return NULL;
+  }
+  return Class;
+}
+
+/**
+ * This routine saves Templates to a memory buffer, so that the state of
+ * the adaptive classifier can be restored later, or by another instance
+ * with the same unicharset, with DeSerializeAdaptedTemplates.
+ * Only the classes that have been adapted are saved in full, and the
+ * class pruners are saved sparsely, so the buffer is much smaller than the
+ * output of WriteAdaptedTemplates.
+ *
+ * @param Templates set of adapted templates to save
+ * @param data    buffer to hold the result
+ * @return false if the buffer could not be made.
+ */
+bool Classify::SerializeAdaptedTemplates(ADAPT_TEMPLATES Templates,
+                                         GenericVector<char> *data) {
+  data->truncate(0);
+  if (Templates == NULL)
+    return false;
+  INT_TEMPLATES IntTemplates = Templates->Templates;
+  inT32 header[5];
+  header[0] = kAdaptedTemplatesMagic;
+  header[1] = IntTemplates->NumClasses;
+  header[2] = IntTemplates->NumClassPruners;
+  header[3] = Templates->NumNonEmptyClasses;
+  header[4] = Templates->NumPermClasses;
+  AppendToBuffer(header, sizeof(header), data);
+  for (int i = 0; i < IntTemplates->NumClassPruners; i++)
+    WriteSparseClassPruner(IntTemplates->ClassPruners[i], data);
+  for (int i = 0; i < IntTemplates->NumClasses; i++) {
+    INT_CLASS IntClass = IntTemplates->Class[i];
+    ADAPT_CLASS Class = Templates->Class[i];
+    uinT8 adapted = IntClass->NumConfigs > 0 || IntClass->NumProtos > 0 ||
+        !IsEmptyAdaptedClass(Class);
+    AppendToBuffer(&adapted, sizeof(adapted), data);
+    if (adapted) {
+      WriteCompactIntClass(IntClass, data);
+      WriteCompactAdaptedClass(Class, IntClass->NumConfigs, data);
+    }
+  }
+  return true;
+}
+
+/**
+ * Reads a set of adapted templates from a buffer made by
+ * SerializeAdaptedTemplates. Every count in the buffer is checked against
+ * the limits of the template structures, as the buffer may come from
+ * another instance.
+ *
+ * @param data    buffer to read the templates from
+ * @return Ptr to the new adapted templates, or NULL if the buffer is not
+ * a valid set of adapted templates for the current unicharset.
+ */
+ADAPT_TEMPLATES Classify::DeSerializeAdaptedTemplates(
+    const GenericVector<char> &data) {
+  TemplatesReader reader(data);
+  inT32 header[5];
+  if (!reader.Read(header, sizeof(header)) ||
+      header[0] != kAdaptedTemplatesMagic ||
+      header[1] != unicharset.size() || header[1] > MAX_NUM_CLASSES ||
+      header[2] != (header[1] + CLASSES_PER_CP - 1) / CLASSES_PER_CP ||
+      header[4] < 0 || header[4] > MAX_UINT8)
+    return NULL;
+
+  ADAPT_TEMPLATES Templates = NewAdaptedTemplates(false);
+  Templates->NumNonEmptyClasses = header[3];
+  Templates->NumPermClasses = header[4];
+  INT_TEMPLATES IntTemplates = Templates->Templates;
+  bool ok = true;
+  for (int i = 0; ok && i < header[2]; i++) {
+    IntTemplates->ClassPruners[i] = new CLASS_PRUNER_STRUCT;
+    IntTemplates->NumClassPruners++;
+    ok = ReadSparseClassPruner(&reader, IntTemplates->ClassPruners[i]);
+  }
+  for (int i = 0; ok && i < header[1]; i++) {
+    uinT8 adapted;
+    if (!reader.Read(&adapted, sizeof(adapted)))
+      break;
+    INT_CLASS IntClass = NULL;
+    ADAPT_CLASS Class = NULL;
+    if (adapted) {
+      IntClass = ReadCompactIntClass(&reader);
+      if (IntClass != NULL)
+        Class = ReadCompactAdaptedClass(&reader, IntClass->NumConfigs);
+    } else {
+      IntClass = NewIntClass(1, 1);
+      Class = NewAdaptedClass();
+    }
+    if (Class == NULL) {
+      if (IntClass != NULL)
+        free_int_class(IntClass);
+      break;
+    }
+    IntTemplates->Class[i] = IntClass;
+    Templates->Class[i] = Class;
+    IntTemplates->NumClasses++;
+  }
+  if (!ok || IntTemplates->NumClasses != header[1] || !reader.AtEnd()) {
+    free_adapted_templates(Templates);
+    return NULL;
+  }
+  return Templates;
+}                                /* DeSerializeAdaptedTemplates */
 }  // namespace tesseract
 
 
@@ -236,8 +236,8 @@ void Classify::LearnWord(const char* filename, WERD_RES *word) {
       return;  // Can't or won't adapt.
 
     if (classify_learning_debug_level >= 1)
-      tprintf("\n\nAdapting to word = %s\n",
-              word->best_choice->debug_string().string());
+      tprintf_level(1, "\n\nAdapting to word = %s\n",
+                    word->best_choice->debug_string().string());
     thresholds = new float[word_len];
     word->ComputeAdaptionThresholds(certainty_scale,
                                     matcher_perfect_threshold,
@@ -262,7 +262,7 @@ void Classify::LearnWord(const char* filename, WERD_RES *word) {
 
   for (int ch = 0; ch < word_len; ++ch) {
     if (classify_debug_character_fragments) {
-      tprintf("\nLearning %s\n",  word->correct_text[ch].string());
+      tprintf_level(1, "\nLearning %s\n",  word->correct_text[ch].string());
     }
     if (word->correct_text[ch].length() > 0) {
       float threshold = thresholds != NULL ? thresholds[ch] : 0.0f;
@@ -401,13 +401,13 @@ void Classify::LearnPieces(const char* filename, int start, int length,
                 ? fontinfo_table_.get_id(*word->fontinfo)
                 : 0;
     if (classify_learning_debug_level >= 1)
-      tprintf("Adapting to char = %s, thr= %g font_id= %d\n",
-              unicharset.id_to_unichar(class_id), threshold, font_id);
+      tprintf_level(1, "Adapting to char = %s, thr= %g font_id= %d\n",
+                    unicharset.id_to_unichar(class_id), threshold, font_id);
     // If filename is not NULL we are doing recognition
     // (as opposed to training), so we must have already set word fonts.
     AdaptToChar(rotated_blob, class_id, font_id, threshold);
   } else if (classify_debug_level >= 1) {
-    tprintf("Can't adapt to %s not in unicharset\n", correct_text);
+    tprintf_level(1, "Can't adapt to %s not in unicharset\n", correct_text);
   }
   if (rotated_blob != blob) {
     delete rotated_blob;
@@ -455,6 +455,14 @@ void Classify::EndAdaptiveClassifier() {
     AdaptedTemplates = NULL;
   }
 
+  if (static_model_ != NULL) {
+    // The static model is shared, so it is released rather than freed.
+    GlobalStaticModelCache()->Free(static_model_);
+    static_model_ = NULL;
+    PreTrainedTemplates = NULL;
+    NormProtos = NULL;
+    shape_table_ = NULL;
+  }
   if (PreTrainedTemplates != NULL) {
     free_int_templates(PreTrainedTemplates);
     PreTrainedTemplates = NULL;
@@ -508,35 +516,27 @@ void Classify::InitAdaptiveClassifier(bool load_pre_trained_templates) {
   // adaptive only.
   if (language_data_path_prefix.length() > 0 &&
       load_pre_trained_templates) {
+    // The static model is loaded only by the first instance to need it, and
+    // then shared by all the instances that load the same traineddata.
+    STRING model_id = language_data_path_prefix;
+    model_id += kTrainedDataSuffix;
+    model_id.add_str_int(":", unicharset.size());
+    static_model_ = GlobalStaticModelCache()->Get(
+        model_id, NewTessCallback(this, &Classify::LoadStaticModel));
+    ASSERT_HOST(static_model_ != NULL);
+    PreTrainedTemplates = static_model_->templates;
+    shape_table_ = static_model_->shape_table;
+    NormProtos = static_model_->norm_protos;
+    shapetable_cutoffs_ = static_model_->shapetable_cutoffs;
+    for (int i = 0; i < MAX_NUM_CLASSES; i++)
+      CharNormCutoffs[i] = static_model_->char_norm_cutoffs[i];
+
+    // The font tables belong to each instance.
     ASSERT_HOST(tessdata_manager.SeekToStart(TESSDATA_INTTEMP));
-    PreTrainedTemplates =
-      ReadIntTemplates(tessdata_manager.GetDataFilePtr());
-    if (tessdata_manager.DebugLevel() > 0) tprintf("Loaded inttemp\n");
-
-    if (tessdata_manager.SeekToStart(TESSDATA_SHAPE_TABLE)) {
-      shape_table_ = new ShapeTable(unicharset);
-      if (!shape_table_->DeSerialize(tessdata_manager.swap(),
-                                     tessdata_manager.GetDataFilePtr())) {
-        tprintf("Error loading shape table!\n");
-        delete shape_table_;
-        shape_table_ = NULL;
-      } else if (tessdata_manager.DebugLevel() > 0) {
-        tprintf("Successfully loaded shape table!\n");
-      }
-    }
-
-    ASSERT_HOST(tessdata_manager.SeekToStart(TESSDATA_PFFMTABLE));
-    ReadNewCutoffs(tessdata_manager.GetDataFilePtr(),
-                   tessdata_manager.swap(),
-                   tessdata_manager.GetEndOffset(TESSDATA_PFFMTABLE),
-                   CharNormCutoffs);
-    if (tessdata_manager.DebugLevel() > 0) tprintf("Loaded pffmtable\n");
-
-    ASSERT_HOST(tessdata_manager.SeekToStart(TESSDATA_NORMPROTO));
-    NormProtos =
-      ReadNormProtos(tessdata_manager.GetDataFilePtr(),
-                     tessdata_manager.GetEndOffset(TESSDATA_NORMPROTO));
-    if (tessdata_manager.DebugLevel() > 0) tprintf("Loaded normproto\n");
+    FILE *fp = tessdata_manager.GetDataFilePtr();
+    fseek(fp, static_model_->font_tables_offset, SEEK_CUR);
+    ReadFontTables(fp, static_model_->inttemp_version,
+                   static_model_->inttemp_swap);
     static_classifier_ = new TessClassifier(false, this);
   }
 
@@ -571,6 +571,8 @@ void Classify::InitAdaptiveClassifier(bool load_pre_trained_templates) {
       AdaptedTemplates = ReadAdaptedTemplates(File);
       cprintf("\n");
       fclose(File);
+      if (AdaptedTemplates == NULL)
+        AdaptedTemplates = NewAdaptedTemplates(true);
       PrintAdaptedTemplates(stdout, AdaptedTemplates);
 
       for (int i = 0; i < AdaptedTemplates->Templates->NumClasses; i++) {
@@ -584,16 +586,88 @@ void Classify::InitAdaptiveClassifier(bool load_pre_trained_templates) {
   }
 }                                /* InitAdaptiveClassifier */
 
+// Loads the static classifier model from the traineddata, for
+// GlobalStaticModelCache() when no other instance has it loaded.
+StaticClassifierModel* Classify::LoadStaticModel() {
+  StaticClassifierModel* model = new StaticClassifierModel;
+  model->unicharset.CopyFrom(unicharset);
+  ASSERT_HOST(tessdata_manager.SeekToStart(TESSDATA_INTTEMP));
+  FILE *fp = tessdata_manager.GetDataFilePtr();
+  inT64 start = ftell(fp);
+  model->templates = ReadIntTemplateClasses(fp, &model->inttemp_version,
+                                            &model->inttemp_swap);
+  if (model->templates == NULL) {
+    tprintf("Error loading inttemp!\n");
+    delete model;
+    return NULL;
+  }
+  model->font_tables_offset = ftell(fp) - start;
+  if (tessdata_manager.DebugLevel() > 0) tprintf("Loaded inttemp\n");
+
+  if (tessdata_manager.SeekToStart(TESSDATA_SHAPE_TABLE)) {
+    model->shape_table = new ShapeTable(model->unicharset);
+    if (!model->shape_table->DeSerialize(tessdata_manager.swap(),
+                                         tessdata_manager.GetDataFilePtr())) {
+      tprintf("Error loading shape table!\n");
+      delete model->shape_table;
+      model->shape_table = NULL;
+    } else if (tessdata_manager.DebugLevel() > 0) {
+      tprintf("Successfully loaded shape table!\n");
+    }
+  }
+
+  // ReadNewCutoffs reads the shape table cutoffs only if there is a shape
+  // table, and reads into this instance, so the results are copied.
+  shape_table_ = model->shape_table;
+  ASSERT_HOST(tessdata_manager.SeekToStart(TESSDATA_PFFMTABLE));
+  ReadNewCutoffs(tessdata_manager.GetDataFilePtr(),
+                 tessdata_manager.swap(),
+                 tessdata_manager.GetEndOffset(TESSDATA_PFFMTABLE),
+                 CharNormCutoffs);
+  model->shapetable_cutoffs = shapetable_cutoffs_;
+  model->char_norm_cutoffs.reserve(MAX_NUM_CLASSES);
+  for (int i = 0; i < MAX_NUM_CLASSES; i++)
+    model->char_norm_cutoffs.push_back(CharNormCutoffs[i]);
+  if (tessdata_manager.DebugLevel() > 0) tprintf("Loaded pffmtable\n");
+
+  ASSERT_HOST(tessdata_manager.SeekToStart(TESSDATA_NORMPROTO));
+  model->norm_protos =
+    ReadNormProtos(tessdata_manager.GetDataFilePtr(),
+                   tessdata_manager.GetEndOffset(TESSDATA_NORMPROTO));
+  if (tessdata_manager.DebugLevel() > 0) tprintf("Loaded normproto\n");
+  return model;
+}
+
 void Classify::ResetAdaptiveClassifierInternal() {
   if (classify_learning_debug_level > 0) {
-    tprintf("Resetting adaptive classifier (NumAdaptationsFailed=%d)\n",
-            NumAdaptationsFailed);
+    tprintf_level(1,
+                  "Resetting adaptive classifier (NumAdaptationsFailed=%d)\n",
+                  NumAdaptationsFailed);
   }
   free_adapted_templates(AdaptedTemplates);
   AdaptedTemplates = NewAdaptedTemplates(true);
   NumAdaptationsFailed = 0;
 }
 
+// Saves the state of the adaptive classifier to the given buffer, so that it
+// can be put back with RestoreAdaptiveClassifierInternal, by this instance
+// or any other using the same traineddata. Returns false on failure.
+bool Classify::SaveAdaptiveClassifierInternal(GenericVector<char>* data) {
+  return SerializeAdaptedTemplates(AdaptedTemplates, data);
+}
+
+// Replaces the state of the adaptive classifier with templates read by
+// DeSerializeAdaptedTemplates from a buffer made by
+// SaveAdaptiveClassifierInternal. Takes ownership of templates.
+void Classify::RestoreAdaptiveClassifierInternal(ADAPT_TEMPLATES templates) {
+  free_adapted_templates(AdaptedTemplates);
+  AdaptedTemplates = templates;
+  for (int i = 0; i < AdaptedTemplates->Templates->NumClasses; i++) {
+    BaselineCutoffs[i] = CharNormCutoffs[i];
+  }
+  NumAdaptationsFailed = 0;
+}
+
 
 
 /*---------------------------------------------------------------------------*/
@@ -1066,7 +1140,7 @@ void Classify::AmbigClassifier(
                                            CharNormArray);
   bool debug = matcher_debug_level >= 2 || classify_debug_level > 1;
   if (debug)
-    tprintf("AM Matches =  ");
+    tprintf_level(1, "AM Matches =  ");
 
   int top = blob->bounding_box().top();
   int bottom = blob->bounding_box().bottom();
@@ -1214,8 +1288,8 @@ double Classify::ComputeCorrectedRating(bool debug, int unichar_id,
     unicharset.get_top_bottom(unichar_id, &min_bottom, &max_bottom,
                               &min_top, &max_top);
     if (debug) {
-      tprintf("top=%d, vs [%d, %d], bottom=%d, vs [%d, %d]\n",
-              top, min_top, max_top, bottom, min_bottom, max_bottom);
+      tprintf_level(1, "top=%d, vs [%d, %d], bottom=%d, vs [%d, %d]\n",
+                    top, min_top, max_top, bottom, min_bottom, max_bottom);
     }
     if (top < min_top || top > max_top ||
         bottom < min_bottom || bottom > max_bottom) {
@@ -1226,15 +1300,11 @@ double Classify::ComputeCorrectedRating(bool debug, int unichar_id,
   if (result > WORST_POSSIBLE_RATING)
     result = WORST_POSSIBLE_RATING;
   if (debug) {
-    tprintf("%s: %2.1f(CP%2.1f, IM%2.1f + CN%.2f(%d) + MP%2.1f + VP%2.1f)\n",
-            unicharset.id_to_unichar(unichar_id),
-            result * 100.0,
-            cp_rating * 100.0,
-            im_rating * 100.0,
-            (cn_corrected - im_rating) * 100.0,
-            cn_factors[unichar_id],
-            miss_penalty * 100.0,
-            vertical_penalty * 100.0);
+    tprintf_level(1,
+        "%s: %2.1f(CP%2.1f, IM%2.1f + CN%.2f(%d) + MP%2.1f + VP%2.1f)\n",
+        unicharset.id_to_unichar(unichar_id), result * 100.0, cp_rating * 100.0,
+        im_rating * 100.0, (cn_corrected - im_rating) * 100.0,
+        cn_factors[unichar_id], miss_penalty * 100.0, vertical_penalty * 100.0);
   }
   return result;
 }
@@ -1314,8 +1384,19 @@ int Classify::CharNormClassifier(TBLOB *blob,
   adapt_results->BlobLength =
       IntCastRounded(sample.outline_length() / kStandardFeatureLength);
   GenericVector<UnicharRating> unichar_results;
-  static_classifier_->UnicharClassifySample(sample, blob->denorm().pix(), 0,
-                                            -1, &unichar_results);
+  // The static templates do not change within a page, so a sample that has
+  // been seen before, typically in pass 1, gets the same results as before.
+  if (classify_static_cache_size > 0 &&
+      static_result_cache_.Lookup(sample, &unichar_results)) {
+    page_stats.Increment(PAGE_COUNTER_STATIC_CACHE_HITS);
+  } else {
+    static_classifier_->UnicharClassifySample(sample, blob->denorm().pix(), 0,
+                                              -1, &unichar_results);
+    if (classify_static_cache_size > 0) {
+      static_result_cache_.Insert(sample, unichar_results,
+                                  classify_static_cache_size);
+    }
+  }
   // Convert results to the format used internally by AdaptiveClassifier.
   for (int r = 0; r < unichar_results.size(); ++r) {
     int unichar_id = unichar_results[r].unichar_id;
@@ -2321,9 +2402,9 @@ int Classify::ShapeIDToClassID(int shape_id) const {
 bool Classify::TempConfigReliable(CLASS_ID class_id,
                                   const TEMP_CONFIG &config) {
   if (classify_learning_debug_level >= 1) {
-    tprintf("NumTimesSeen for config of %s is %d\n",
-            getDict().getUnicharset().debug_str(class_id).string(),
-            config->NumTimesSeen);
+    tprintf_level(1, "NumTimesSeen for config of %s is %d\n",
+                  getDict().getUnicharset().debug_str(class_id).string(),
+                  config->NumTimesSeen);
   }
   if (config->NumTimesSeen >= matcher_sufficient_examples_for_prototyping) {
     return true;
@@ -2342,11 +2423,11 @@ bool Classify::TempConfigReliable(CLASS_ID class_id,
           ambig_class->MaxNumTimesSeen <
           matcher_min_examples_for_prototyping) {
         if (classify_learning_debug_level >= 1) {
-          tprintf("Ambig %s has not been seen enough times,"
-                  " not making config for %s permanent\n",
-                  getDict().getUnicharset().debug_str(
-                      (*ambigs)[ambig]).string(),
-                  getDict().getUnicharset().debug_str(class_id).string());
+          tprintf_level(1, "Ambig %s has not been seen enough times,"
+                        " not making config for %s permanent\n",
+                        getDict().getUnicharset().debug_str(
+                            (*ambigs)[ambig]).string(),
+                        getDict().getUnicharset().debug_str(class_id).string());
         }
         return false;
       }
@@ -2360,8 +2441,9 @@ void Classify::UpdateAmbigsGroup(CLASS_ID class_id, TBLOB *Blob) {
     getDict().getUnicharAmbigs().ReverseAmbigsForAdaption(class_id);
   int ambigs_size = (ambigs == NULL) ? 0 : ambigs->size();
   if (classify_learning_debug_level >= 1) {
-    tprintf("Running UpdateAmbigsGroup for %s class_id=%d\n",
-            getDict().getUnicharset().debug_str(class_id).string(), class_id);
+    tprintf_level(1, "Running UpdateAmbigsGroup for %s class_id=%d\n",
+                  getDict().getUnicharset().debug_str(class_id).string(),
+                  class_id);
   }
   for (int ambig = 0; ambig < ambigs_size; ++ambig) {
     CLASS_ID ambig_class_id = (*ambigs)[ambig];
@@ -2372,9 +2454,9 @@ void Classify::UpdateAmbigsGroup(CLASS_ID class_id, TBLOB *Blob) {
         TempConfigFor(AdaptedTemplates->Class[ambig_class_id], cfg);
       if (config != NULL && TempConfigReliable(ambig_class_id, config)) {
         if (classify_learning_debug_level >= 1) {
-          tprintf("Making config %d of %s permanent\n", cfg,
-                  getDict().getUnicharset().debug_str(
-                      ambig_class_id).string());
+          tprintf_level(1, "Making config %d of %s permanent\n", cfg,
+                        getDict().getUnicharset().debug_str(
+                            ambig_class_id).string());
         }
         MakePermanent(AdaptedTemplates, ambig_class_id, cfg, Blob);
       }
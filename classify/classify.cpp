@@ -142,6 +142,9 @@ Classify::Classify()
                "Class Pruner CutoffStrength:         ", this->params()),
     INT_MEMBER(classify_integer_matcher_multiplier, 10,
                "Integer Matcher Multiplier  0-255:   ", this->params()),
+    INT_MEMBER(classify_static_cache_size, 10000,
+               "Max number of static classifier results remembered within"
+               " a page, or 0 to disable", this->params()),
     EnableLearning(true),
     INT_MEMBER(il1_adaption_test, 0, "Dont adapt to i/I at beginning of word",
                this->params()),
@@ -153,7 +156,8 @@ Classify::Classify()
                   "Penalty to add to worst rating for noise", this->params()),
     shape_table_(NULL),
     dict_(this),
-    static_classifier_(NULL) {
+    static_classifier_(NULL),
+    static_model_(NULL) {
   fontinfo_table_.set_compare_callback(
       NewPermanentTessCallback(CompareFontInfo));
   fontinfo_table_.set_clear_callback(
@@ -197,6 +201,15 @@ void Classify::SetStaticClassifier(ShapeClassifier* static_classifier) {
   static_classifier_ = static_classifier;
 }
 
+// Returns the cache of static classifier models, which shares the models
+// between all the instances in the process that load the same traineddata.
+ObjectCache<StaticClassifierModel>* Classify::GlobalStaticModelCache() {
+  // Allocated like Dict::GlobalDawgCache, so it outlives every instance.
+  static ObjectCache<StaticClassifierModel>* cache =
+      new ObjectCache<StaticClassifierModel>();
+  return cache;
+}
+
 // Moved from speckle.cpp
 // Adds a noise classification result that is a bit worse than the worst
 // current result, or the worst possible result if no current results.
@@ -28,8 +28,11 @@
 #include "intfx.h"
 #include "intmatcher.h"
 #include "normalis.h"
+#include "object_cache.h"
 #include "ratngs.h"
 #include "ocrfeatures.h"
+#include "resultcache.h"
+#include "staticmodel.h"
 #include "unicity_table.h"
 
 class ScrollView;
@@ -73,6 +76,10 @@ class Classify : public CCStruct {
   // to CharNormClassifier.
   void SetStaticClassifier(ShapeClassifier* static_classifier);
 
+  // Returns the cache of static classifier models, which shares the models
+  // between all the instances in the process that load the same traineddata.
+  static ObjectCache<StaticClassifierModel>* GlobalStaticModelCache();
+
   // Adds a noise classification result that is a bit worse than the worst
   // current result, or the worst possible result if no current results.
   void AddLargeSpeckleTo(int blob_length, BLOB_CHOICE_LIST *choices);
@@ -108,6 +115,12 @@ class Classify : public CCStruct {
   void PrintAdaptedTemplates(FILE *File, ADAPT_TEMPLATES Templates);
   void WriteAdaptedTemplates(FILE *File, ADAPT_TEMPLATES Templates);
   ADAPT_TEMPLATES ReadAdaptedTemplates(FILE *File);
+  // Saves the templates to a memory buffer for DeSerializeAdaptedTemplates.
+  bool SerializeAdaptedTemplates(ADAPT_TEMPLATES Templates,
+                                 GenericVector<char> *data);
+  // Returns the templates saved in the buffer, or NULL if they are invalid
+  // or were made with a different unicharset.
+  ADAPT_TEMPLATES DeSerializeAdaptedTemplates(const GenericVector<char> &data);
   /* normmatch.cpp ************************************************************/
   FLOAT32 ComputeNormMatch(CLASS_ID ClassId,
                            const FEATURE_STRUCT& feature, BOOL8 DebugMatch);
@@ -272,6 +285,18 @@ class Classify : public CCStruct {
   void AdaptiveClassifier(TBLOB *Blob, BLOB_CHOICE_LIST *Choices);
   void ClassifyAsNoise(ADAPT_RESULTS *Results);
   void ResetAdaptiveClassifierInternal();
+  // Forgets the static classifier results remembered for the current page.
+  void ClearStaticResultCache() {
+    static_result_cache_.Clear();
+  }
+  // Saves the state of the adaptive classifier to the given buffer, so that
+  // it can be put back with RestoreAdaptiveClassifierInternal, by this
+  // instance or any other using the same traineddata.
+  bool SaveAdaptiveClassifierInternal(GenericVector<char>* data);
+  // Replaces the state of the adaptive classifier with templates read by
+  // DeSerializeAdaptedTemplates from a buffer made by
+  // SaveAdaptiveClassifierInternal. Takes ownership of templates.
+  void RestoreAdaptiveClassifierInternal(ADAPT_TEMPLATES templates);
 
   int GetCharNormFeature(const INT_FX_RESULT_STRUCT& fx_info,
                          INT_TEMPLATES templates,
@@ -340,6 +365,13 @@ class Classify : public CCStruct {
   void ComputeIntFeatures(FEATURE_SET Features, INT_FEATURE_ARRAY IntFeatures);
   /* intproto.cpp *************************************************************/
   INT_TEMPLATES ReadIntTemplates(FILE *File);
+  // Reads the templates without the font tables that follow them, and
+  // returns the format version and whether the file is byte swapped.
+  // Returns NULL if the templates are invalid.
+  INT_TEMPLATES ReadIntTemplateClasses(FILE *File, int *version,
+                                       bool *swapped);
+  // Reads the font tables that follow the templates of the given version.
+  void ReadFontTables(FILE *File, int version_id, bool swap);
   void WriteIntTemplates(FILE *File, INT_TEMPLATES Templates,
                          const UNICHARSET& target_unicharset);
   CLASS_ID GetClassToDebug(const char *Prompt, bool* adaptive_on,
@@ -450,6 +482,9 @@ class Classify : public CCStruct {
             "Class Pruner CutoffStrength:         ");
   INT_VAR_H(classify_integer_matcher_multiplier, 10,
             "Integer Matcher Multiplier  0-255:   ");
+  INT_VAR_H(classify_static_cache_size, 10000,
+            "Max number of static classifier results remembered within"
+            " a page, or 0 to disable");
 
   // Use class variables to hold onto built-in templates and adapted templates.
   INT_TEMPLATES PreTrainedTemplates;
@@ -494,6 +529,16 @@ class Classify : public CCStruct {
   Dict dict_;
   // The currently active static classifier.
   ShapeClassifier* static_classifier_;
+  // Results of static_classifier_ for the samples seen in the current page.
+  ClassifierResultCache static_result_cache_;
+
+  // Loads the static classifier model from the traineddata, for
+  // GlobalStaticModelCache() when no other instance has it loaded.
+  StaticClassifierModel* LoadStaticModel();
+
+  // The shared model that PreTrainedTemplates, shape_table_ and NormProtos
+  // belong to, or NULL if they are not loaded.
+  StaticClassifierModel* static_model_;
 
   /* variables used to hold performance statistics */
   int NumAdaptationsFailed;
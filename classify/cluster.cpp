@@ -25,7 +25,11 @@
 #include "tprintf.h"
 #include "danerror.h"
 #include "freelist.h"
+#include "ccutil.h"
 #include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #define HOTELLING 1  // If true use Hotelling's test to decide where to split.
 #define FTABLE_X 10  // Size of FTable.
@@ -184,6 +188,7 @@ struct BUCKETS {
   uinT16 Bucket[BUCKETTABLESIZE];// mapping to histogram buckets
   uinT32 *Count;                 // frequency of occurence histogram
   FLOAT32 *ExpectedCount;        // expected histogram
+  FLOAT64 *Probability;          // probability of falling in each bucket
 };
 
 struct CHISTRUCT{
@@ -192,6 +197,14 @@ struct CHISTRUCT{
   FLOAT64 ChiSquared;
 };
 
+// A cluster tested by ComputePrototypes, with the prototype made from it,
+// or the index of its Left sub-cluster (Right follows it) if it failed.
+struct PROTO_CANDIDATE {
+  CLUSTER *Cluster;
+  PROTOTYPE *Prototype;
+  int Left;
+};
+
 // For use with KDWalk / MakePotentialClusters
 struct ClusteringContext {
   ClusterHeap *heap;  // heap used to hold temp clusters, "best" on top
@@ -317,6 +330,10 @@ BUCKETS *GetBuckets(CLUSTERER* clusterer,
                     uinT32 SampleCount,
                     FLOAT64 Confidence);
 
+void ClearBucketCache(CLUSTERER *Clusterer);
+
+void FreeBucketCache(CLUSTERER *Clusterer);
+
 BUCKETS *MakeBuckets(DISTRIBUTION Distribution,
                      uinT32 SampleCount,
                      FLOAT64 Confidence);
@@ -428,10 +445,7 @@ MakeClusterer (inT16 SampleSize, const PARAM_DESC ParamDesc[]) {
   Clusterer->KDTree = MakeKDTree (SampleSize, ParamDesc);
 
   // Initialize cache of histogram buckets to minimize recomputing them.
-  for (int d = 0; d < DISTRIBUTION_COUNT; ++d) {
-    for (int c = 0; c < MAXBUCKETS + 1 - MINBUCKETS; ++c)
-      Clusterer->bucket_cache[d][c] = NULL;
-  }
+  ClearBucketCache(Clusterer);
 
   return Clusterer;
 }                                // MakeClusterer
@@ -541,11 +555,7 @@ void FreeClusterer(CLUSTERER *Clusterer) {
     if (Clusterer->Root != NULL)
       FreeCluster (Clusterer->Root);
     // Free up all used buckets structures.
-    for (int d = 0; d < DISTRIBUTION_COUNT; ++d) {
-      for (int c = 0; c < MAXBUCKETS + 1 - MINBUCKETS; ++c)
-        if (Clusterer->bucket_cache[d][c] != NULL)
-          FreeBuckets(Clusterer->bucket_cache[d][c]);
-    }
+    FreeBucketCache(Clusterer);
 
     memfree(Clusterer);
   }
@@ -709,6 +719,25 @@ void CreateClusterTree(CLUSTERER *Clusterer) {
   context.heap = new ClusterHeap(Clusterer->NumberOfSamples);
   KDWalk(context.tree, (void_proc)MakePotentialClusters, &context);
 
+  // the nearest neighbor searches only read the kd-tree, so they can all
+  // run at once. The heap is then filled in walk order so that ties are
+  // broken exactly as they would be by a serial walk.
+  FLOAT32 *distances = (FLOAT32 *) Emalloc(context.next * sizeof(FLOAT32));
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (int i = 0; i < context.next; ++i) {
+    context.candidates[i].Neighbor =
+        FindNearestNeighbor(context.tree, context.candidates[i].Cluster,
+                            &distances[i]);
+  }
+  for (int i = 0; i < context.next; ++i) {
+    if (context.candidates[i].Neighbor != NULL) {
+      HeapEntry.key = distances[i];
+      HeapEntry.data = &(context.candidates[i]);
+      context.heap->Push(&HeapEntry);
+    }
+  }
+  memfree(distances);
+
   // form potential clusters into actual clusters - always do "best" first
   while (context.heap->Pop(&HeapEntry)) {
     PotentialCluster = HeapEntry.data;
@@ -762,23 +791,16 @@ void CreateClusterTree(CLUSTERER *Clusterer) {
   Operation:
       This routine is designed to be used in concert with the
       KDWalk routine.  It will create a potential cluster for
-      each sample in the kd-tree that is being walked.  This
-      potential cluster will then be pushed on the heap.
+      each sample in the kd-tree that is being walked.  The
+      nearest neighbor of each potential cluster is found later
+      by CreateClusterTree, which then pushes it on the heap.
 ******************************************************************************/
 void MakePotentialClusters(ClusteringContext *context,
                            CLUSTER *Cluster, inT32 Level) {
-  ClusterPair HeapEntry;
   int next = context->next;
   context->candidates[next].Cluster = Cluster;
-  HeapEntry.data = &(context->candidates[next]);
-  context->candidates[next].Neighbor =
-      FindNearestNeighbor(context->tree,
-                          context->candidates[next].Cluster,
-                          &HeapEntry.key);
-  if (context->candidates[next].Neighbor != NULL) {
-    context->heap->Push(&HeapEntry);
-    context->next++;
-  }
+  context->candidates[next].Neighbor = NULL;
+  context->next++;
 }                                // MakePotentialClusters
 
 
@@ -929,29 +951,82 @@ Exceptions:	None
 History:	5/30/89, DSJ, Created.
 *******************************************************************************/
 void ComputePrototypes(CLUSTERER *Clusterer, CLUSTERCONFIG *Config) {
+  GenericVector<PROTO_CANDIDATE> candidates;
+  PROTO_CANDIDATE candidate;
   LIST ClusterStack = NIL_LIST;
-  CLUSTER *Cluster;
-  PROTOTYPE *Prototype;
+  int level_start, level_end;
+  int i;
 
-  // use a stack to keep track of clusters waiting to be processed
-  // initially the only cluster on the stack is the root cluster
-  if (Clusterer->Root != NULL)
-    ClusterStack = push (NIL_LIST, Clusterer->Root);
+  if (Clusterer->Root == NULL)
+    return;
+
+  // The clusters are tested one level of the cluster tree at a time.  All
+  // of the clusters in a level are independent of each other, so they can
+  // be tested at the same time, each thread using its own bucket cache.
+  // The children of every cluster that fails to make a prototype make up
+  // the next level.
+  // Inside another parallel region, the if clause on the loop below keeps it
+  // on the calling thread, which is all the single clusterer can serve.
+  int num_threads = 1;
+#ifdef _OPENMP
+  if (!omp_in_parallel())
+    num_threads = omp_get_max_threads();
+#endif
+  CLUSTERER **thread_clusterers = (CLUSTERER **)
+    Emalloc(num_threads * sizeof(CLUSTERER *));
+  thread_clusterers[0] = Clusterer;
+  for (i = 1; i < num_threads; i++) {
+    thread_clusterers[i] = (CLUSTERER *) Emalloc(sizeof(CLUSTERER));
+    *thread_clusterers[i] = *Clusterer;
+    ClearBucketCache(thread_clusterers[i]);
+  }
+  candidate.Cluster = Clusterer->Root;
+  candidate.Prototype = NULL;
+  candidate.Left = -1;
+  candidates.push_back(candidate);
+  for (level_start = 0; level_start < candidates.size();
+       level_start = level_end) {
+    level_end = candidates.size();
+    #pragma omp parallel for schedule(dynamic) if (num_threads > 1) \
+        num_threads(num_threads)
+    for (int c = level_start; c < level_end; ++c) {
+      int thread_id = 0;
+#ifdef _OPENMP
+      thread_id = omp_get_thread_num();
+#endif
+      candidates[c].Prototype = MakePrototype(thread_clusterers[thread_id],
+                                              Config, candidates[c].Cluster);
+    }
+    for (i = level_start; i < level_end; i++) {
+      if (candidates[i].Prototype == NULL) {
+        CLUSTER *Cluster = candidates[i].Cluster;
+        candidates[i].Left = candidates.size();
+        candidate.Cluster = Cluster->Left;
+        candidates.push_back(candidate);
+        candidate.Cluster = Cluster->Right;
+        candidates.push_back(candidate);
+      }
+    }
+  }
+  // Thread 0 used the Clusterer itself, so only the other copies and their
+  // bucket caches need to be freed.
+  for (i = 1; i < num_threads; i++) {
+    FreeBucketCache(thread_clusterers[i]);
+    memfree(thread_clusterers[i]);
+  }
+  memfree(thread_clusterers);
 
-  // loop until we have analyzed all clusters which are potential prototypes
+  // Build the proto list in the same depth-first order that a serial
+  // search of the tree would have produced it.
+  ClusterStack = push(NIL_LIST, (void *) &candidates[0]);
   while (ClusterStack != NIL_LIST) {
-    // remove the next cluster to be analyzed from the stack
-    // try to make a prototype from the cluster
-    // if successful, put it on the proto list, else split the cluster
-    Cluster = (CLUSTER *) first_node (ClusterStack);
-    ClusterStack = pop (ClusterStack);
-    Prototype = MakePrototype(Clusterer, Config, Cluster);
-    if (Prototype != NULL) {
-      Clusterer->ProtoList = push (Clusterer->ProtoList, Prototype);
-    }
-    else {
-      ClusterStack = push (ClusterStack, Cluster->Right);
-      ClusterStack = push (ClusterStack, Cluster->Left);
+    PROTO_CANDIDATE *next = (PROTO_CANDIDATE *) first_node(ClusterStack);
+    ClusterStack = pop(ClusterStack);
+    if (next->Prototype != NULL) {
+      Clusterer->ProtoList = push(Clusterer->ProtoList, next->Prototype);
+    } else {
+      ClusterStack = push(ClusterStack, &candidates[next->Left + 1]);
+      ClusterStack = push(ClusterStack, &candidates[next->Left]);
     }
   }
 }                                // ComputePrototypes
@@ -1736,6 +1811,27 @@ BUCKETS *GetBuckets(CLUSTERER* clusterer,
 }                                // GetBuckets
 
 
+// Empties the bucket_cache of the Clusterer without freeing anything.
+void ClearBucketCache(CLUSTERER *Clusterer) {
+  for (int d = 0; d < DISTRIBUTION_COUNT; ++d) {
+    for (int c = 0; c < MAXBUCKETS + 1 - MINBUCKETS; ++c)
+      Clusterer->bucket_cache[d][c] = NULL;
+  }
+}                                // ClearBucketCache
+
+
+// Frees all the buckets held in the bucket_cache of the Clusterer.
+void FreeBucketCache(CLUSTERER *Clusterer) {
+  for (int d = 0; d < DISTRIBUTION_COUNT; ++d) {
+    for (int c = 0; c < MAXBUCKETS + 1 - MINBUCKETS; ++c) {
+      if (Clusterer->bucket_cache[d][c] != NULL)
+        FreeBuckets(Clusterer->bucket_cache[d][c]);
+      Clusterer->bucket_cache[d][c] = NULL;
+    }
+  }
+}                                // FreeBucketCache
+
+
 /** Makebuckets *************************************************************
 Parameters:
       Distribution	type of probability distribution to test for
@@ -1781,12 +1877,15 @@ BUCKETS *MakeBuckets(DISTRIBUTION Distribution,
       Emalloc(Buckets->NumberOfBuckets * sizeof(uinT32)));
   Buckets->ExpectedCount = reinterpret_cast<FLOAT32*>(
       Emalloc(Buckets->NumberOfBuckets * sizeof(FLOAT32)));
+  Buckets->Probability = reinterpret_cast<FLOAT64*>(
+      Emalloc(Buckets->NumberOfBuckets * sizeof(FLOAT64)));
 
   // initialize simple fields
   Buckets->Distribution = Distribution;
   for (i = 0; i < Buckets->NumberOfBuckets; i++) {
     Buckets->Count[i] = 0;
     Buckets->ExpectedCount[i] = 0.0;
+    Buckets->Probability[i] = 0.0;
   }
 
   // all currently defined distributions are symmetrical
@@ -1818,22 +1917,27 @@ BUCKETS *MakeBuckets(DISTRIBUTION Distribution,
         NextBucketBoundary += BucketProbability;
       }
       Buckets->Bucket[i] = CurrentBucket;
-      Buckets->ExpectedCount[CurrentBucket] +=
-        (FLOAT32) (ProbabilityDelta * SampleCount);
+      Buckets->Probability[CurrentBucket] += ProbabilityDelta;
       LastProbDensity = ProbDensity;
     }
     // place any leftover probability into the last bucket
-    Buckets->ExpectedCount[CurrentBucket] +=
-      (FLOAT32) ((0.5 - Probability) * SampleCount);
+    Buckets->Probability[CurrentBucket] += 0.5 - Probability;
 
     // copy upper half of distribution to lower half
     for (i = 0, j = BUCKETTABLESIZE - 1; i < j; i++, j--)
       Buckets->Bucket[i] =
         Mirror(Buckets->Bucket[j], Buckets->NumberOfBuckets);
 
-    // copy upper half of expected counts to lower half
+    // copy upper half of probabilities to lower half
     for (i = 0, j = Buckets->NumberOfBuckets - 1; i <= j; i++, j--)
-      Buckets->ExpectedCount[i] += Buckets->ExpectedCount[j];
+      Buckets->Probability[i] += Buckets->Probability[j];
+
+    // the expected counts are always derived from the probabilities, so
+    // they do not depend on which sample counts the buckets were used for
+    // before (see AdjustBuckets).
+    for (i = 0; i < Buckets->NumberOfBuckets; i++)
+      Buckets->ExpectedCount[i] =
+        (FLOAT32) (Buckets->Probability[i] * SampleCount);
   }
   return Buckets;
 }                                // MakeBuckets
@@ -1906,6 +2010,7 @@ ComputeChiSquared (uinT16 DegreesOfFreedom, FLOAT64 Alpha)
 #define MINALPHA  (1e-200)
 {
   static LIST ChiWith[MAXDEGREESOFFREEDOM + 1];
+  static tesseract::CCUtilMutex ChiWithMutex;
 
   CHISTRUCT *OldChiSquared;
   CHISTRUCT SearchKey;
@@ -1920,6 +2025,7 @@ ComputeChiSquared (uinT16 DegreesOfFreedom, FLOAT64 Alpha)
      for the specified number of degrees of freedom.  Search the list for
      the desired chi-squared. */
   SearchKey.Alpha = Alpha;
+  ChiWithMutex.Lock();
   OldChiSquared = (CHISTRUCT *) first_node (search (ChiWith[DegreesOfFreedom],
     &SearchKey, AlphaMatch));
 
@@ -1934,8 +2040,10 @@ ComputeChiSquared (uinT16 DegreesOfFreedom, FLOAT64 Alpha)
   else {
     // further optimization might move OldChiSquared to front of list
   }
+  FLOAT64 ChiSquared = OldChiSquared->ChiSquared;
+  ChiWithMutex.Unlock();
 
-  return (OldChiSquared->ChiSquared);
+  return (ChiSquared);
 
 }                                // ComputeChiSquared
 
@@ -2258,6 +2366,7 @@ void FreeBuckets(BUCKETS *buckets) {
  */
   Efree(buckets->Count);
   Efree(buckets->ExpectedCount);
+  Efree(buckets->Probability);
   Efree(buckets);
 }                                // FreeBuckets
 
@@ -2364,21 +2473,18 @@ void AdjustBuckets(BUCKETS *Buckets, uinT32 NewSampleCount) {
  **		Buckets		histogram data structure to adjust
  **		NewSampleCount	new sample count to adjust to
  **	Operation:
- **		This routine multiplies each ExpectedCount histogram entry
- **		by NewSampleCount/OldSampleCount so that the histogram
+ **		This routine recomputes each ExpectedCount histogram entry
+ **		from the bucket probabilities so that the histogram
  **		is now adjusted to the new sample count.
  **	Return: none
  **	Exceptions: none
  **	History: Thu Aug  3 14:31:14 1989, DSJ, Created.
  */
   int i;
-  FLOAT64 AdjustFactor;
-
-  AdjustFactor = (((FLOAT64) NewSampleCount) /
-    ((FLOAT64) Buckets->SampleCount));
 
   for (i = 0; i < Buckets->NumberOfBuckets; i++) {
-    Buckets->ExpectedCount[i] *= AdjustFactor;
+    Buckets->ExpectedCount[i] =
+      (FLOAT32) (Buckets->Probability[i] * NewSampleCount);
   }
 
   Buckets->SampleCount = NewSampleCount;
@@ -2598,8 +2704,8 @@ CLUSTER * Cluster, FLOAT32 MaxIllegal)
  */
 #define ILLEGAL_CHAR    2
 {
-  static BOOL8 *CharFlags = NULL;
-  static inT32 NumFlags = 0;
+  BOOL8 *CharFlags;
+  inT32 NumFlags;
   int i;
   LIST SearchState;
   SAMPLE *Sample;
@@ -2612,12 +2718,9 @@ CLUSTER * Cluster, FLOAT32 MaxIllegal)
   NumCharInCluster = Cluster->SampleCount;
   NumIllegalInCluster = 0;
 
-  if (Clusterer->NumChar > NumFlags) {
-    if (CharFlags != NULL)
-      memfree(CharFlags);
-    NumFlags = Clusterer->NumChar;
-    CharFlags = (BOOL8 *) Emalloc (NumFlags * sizeof (BOOL8));
-  }
+  // the flags are local so that clusters can be tested on several threads
+  NumFlags = Clusterer->NumChar;
+  CharFlags = (BOOL8 *) Emalloc (NumFlags * sizeof (BOOL8));
 
   for (i = 0; i < NumFlags; i++)
     CharFlags[i] = FALSE;
@@ -2638,10 +2741,12 @@ CLUSTER * Cluster, FLOAT32 MaxIllegal)
       PercentIllegal = (FLOAT32) NumIllegalInCluster / NumCharInCluster;
       if (PercentIllegal > MaxIllegal) {
         destroy(SearchState);
+        memfree(CharFlags);
         return (TRUE);
       }
     }
   }
+  memfree(CharFlags);
   return (FALSE);
 
 }                                // MultipleCharSamples
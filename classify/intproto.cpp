@@ -109,6 +109,21 @@ typedef struct
 
 FILL_SPEC;
 
+/** fixed size record of each class in an inttemp file of version 6 or
+    later, in which the class records, class pruners, proto sets and proto
+    lengths are each written as one contiguous block */
+typedef struct
+{
+  uinT16 NumProtos;
+  uinT8 NumProtoSets;
+  uinT8 NumConfigs;
+  inT32 font_set_id;
+  uinT16 ConfigLengths[MAX_NUM_CONFIGS];
+}
+
+
+INT_CLASS_HEADER;
+
 
 /* constants for conversion from old inttemp format */
 #define OLD_MAX_NUM_CONFIGS      32
@@ -173,6 +188,10 @@ void RenderIntProto(ScrollView *window,
 
 int TruncateParam(FLOAT32 Param, int Min, int Max, char *Id);
 
+bool ReadIntTemplateBlocks(FILE *File, bool swap, INT_TEMPLATES Templates);
+
+void WriteIntTemplateBlocks(FILE *File, INT_TEMPLATES Templates);
+
 /*-----------------------------------------------------------------------------
         Global Data Definitions and Declarations
 -----------------------------------------------------------------------------*/
@@ -779,6 +798,10 @@ INT_TEMPLATES NewIntTemplates() {
   T = (INT_TEMPLATES) Emalloc (sizeof (INT_TEMPLATES_STRUCT));
   T->NumClasses = 0;
   T->NumClassPruners = 0;
+  T->ClassBlock = NULL;
+  T->ClassPrunerBlock = NULL;
+  T->ProtoSetBlock = NULL;
+  T->ProtoLengthBlock = NULL;
 
   for (i = 0; i < MAX_NUM_CLASSES; i++)
     ClassForClassId (T, i) = NULL;
@@ -791,14 +814,67 @@ INT_TEMPLATES NewIntTemplates() {
 void free_int_templates(INT_TEMPLATES templates) {
   int i;
 
-  for (i = 0; i < templates->NumClasses; i++)
-    free_int_class(templates->Class[i]);
-  for (i = 0; i < templates->NumClassPruners; i++)
-    delete templates->ClassPruners[i];
+  if (templates->ClassBlock != NULL) {
+    delete [] templates->ClassBlock;
+    delete [] templates->ClassPrunerBlock;
+    delete [] templates->ProtoSetBlock;
+    delete [] templates->ProtoLengthBlock;
+  } else {
+    for (i = 0; i < templates->NumClasses; i++)
+      free_int_class(templates->Class[i]);
+    for (i = 0; i < templates->NumClassPruners; i++)
+      delete templates->ClassPruners[i];
+  }
   Efree(templates);
 }
 
 
+/*---------------------------------------------------------------------------*/
+void UnpackIntTemplates(INT_TEMPLATES templates) {
+/*
+ ** Parameters:
+ **   templates  templates to unpack
+ ** Globals: none
+ ** Operation: If the templates were read in blocks, this routine copies
+ **   each class, proto set and class pruner to its own memory and frees
+ **   the blocks, so that classes and protos can be added to the templates
+ **   as they are for adapted templates.
+ ** Return: none
+ ** Exceptions: none
+ */
+  if (templates->ClassBlock == NULL)
+    return;
+  for (int i = 0; i < templates->NumClasses; i++) {
+    INT_CLASS Class = (INT_CLASS) Emalloc(sizeof(INT_CLASS_STRUCT));
+    *Class = *templates->Class[i];
+    for (int j = 0; j < Class->NumProtoSets; j++) {
+      PROTO_SET ProtoSet = (PROTO_SET) Emalloc(sizeof(PROTO_SET_STRUCT));
+      *ProtoSet = *Class->ProtoSets[j];
+      Class->ProtoSets[j] = ProtoSet;
+    }
+    if (Class->ProtoLengths != NULL) {
+      uinT8 *Lengths = (uinT8 *) Emalloc(MaxNumIntProtosIn(Class));
+      memcpy(Lengths, Class->ProtoLengths, MaxNumIntProtosIn(Class));
+      Class->ProtoLengths = Lengths;
+    }
+    templates->Class[i] = Class;
+  }
+  for (int i = 0; i < templates->NumClassPruners; i++) {
+    CLASS_PRUNER_STRUCT* Pruner = new CLASS_PRUNER_STRUCT;
+    *Pruner = *templates->ClassPruners[i];
+    templates->ClassPruners[i] = Pruner;
+  }
+  delete [] templates->ClassBlock;
+  delete [] templates->ClassPrunerBlock;
+  delete [] templates->ProtoSetBlock;
+  delete [] templates->ProtoLengthBlock;
+  templates->ClassBlock = NULL;
+  templates->ClassPrunerBlock = NULL;
+  templates->ProtoSetBlock = NULL;
+  templates->ProtoLengthBlock = NULL;
+}
+
+
 namespace tesseract {
 INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
 /*
@@ -806,11 +882,37 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
  **   File    open file to read templates from
  ** Globals: none
  ** Operation: This routine reads a set of integer templates from
- **   File.  File must already be open and must be in the
- **   correct binary format.
- ** Return: Pointer to integer templates read from File.
+ **   File, followed by the font tables.  File must already be open
+ **   and must be in the correct binary format.
+ ** Return: Pointer to integer templates read from File, or NULL if
+ **   the templates are invalid.
  ** Exceptions: none
  ** History: Wed Feb 27 11:48:46 1991, DSJ, Created.
+ */
+  int version_id;
+  bool swap;
+  INT_TEMPLATES Templates = ReadIntTemplateClasses(File, &version_id, &swap);
+  if (Templates != NULL)
+    ReadFontTables(File, version_id, swap);
+  return Templates;
+}                                /* ReadIntTemplates */
+
+
+/*---------------------------------------------------------------------------*/
+INT_TEMPLATES Classify::ReadIntTemplateClasses(FILE *File, int *version,
+                                               bool *swapped) {
+/*
+ ** Parameters:
+ **   File    open file to read templates from
+ **   version returns the version of the templates format
+ **   swapped returns true if the file has the opposite endianness
+ ** Globals: none
+ ** Operation: This routine reads a set of integer templates from
+ **   File, stopping at the font tables, which can then be read with
+ **   ReadFontTables, here or by any other instance reading the same file.
+ ** Return: Pointer to integer templates read from File, or NULL if
+ **   the templates are invalid.
+ ** Exceptions: none
  */
   int i, j, w, x, y, z;
   BOOL8 swap;
@@ -864,6 +966,22 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
       Reverse32(&Templates->NumClasses);
   }
 
+  if (version_id >= 6) {
+    // The classes, class pruners and proto sets are stored in blocks that
+    // are read in one go each.
+    delete[] IndexFor;
+    delete[] ClassIdFor;
+    delete[] TempClassPruner;
+    if (!ReadIntTemplateBlocks(File, swap, Templates)) {
+      cprintf("Bad read of inttemp!\n");
+      free_int_templates(Templates);
+      return NULL;
+    }
+    *version = version_id;
+    *swapped = swap;
+    return Templates;
+  }
+
   if (version_id < 3) {
     MaxNumConfigs = OLD_MAX_NUM_CONFIGS;
     WerdsPerConfigVec = OLD_WERDS_PER_CONFIG_VEC;
@@ -1089,6 +1207,31 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
       }
     }
   }
+
+  // Clean up.
+  delete[] IndexFor;
+  delete[] ClassIdFor;
+  delete[] TempClassPruner;
+
+  *version = version_id;
+  *swapped = swap;
+  return (Templates);
+}                                /* ReadIntTemplateClasses */
+
+
+/*---------------------------------------------------------------------------*/
+void Classify::ReadFontTables(FILE *File, int version_id, bool swap) {
+/*
+ ** Parameters:
+ **   File    open file positioned at the font tables
+ **   version_id  version of the templates format
+ **   swap    true if the file has the opposite endianness
+ ** Globals: none
+ ** Operation: This routine reads the font info and font set tables that
+ **   follow the integer templates, if the version has them.
+ ** Return: none
+ ** Exceptions: none
+ */
   if (version_id >= 4) {
     this->fontinfo_table_.read(File, NewPermanentTessCallback(read_info), swap);
     if (version_id >= 5) {
@@ -1098,14 +1241,7 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
     }
     this->fontset_table_.read(File, NewPermanentTessCallback(read_set), swap);
   }
-
-  // Clean up.
-  delete[] IndexFor;
-  delete[] ClassIdFor;
-  delete[] TempClassPruner;
-
-  return (Templates);
-}                                /* ReadIntTemplates */
+}                                /* ReadFontTables */
 
 
 /*---------------------------------------------------------------------------*/
@@ -1183,16 +1319,20 @@ void Classify::WriteIntTemplates(FILE *File, INT_TEMPLATES Templates,
  ** Exceptions: none
  ** History: Wed Feb 27 11:48:46 1991, DSJ, Created.
  */
-  int i, j;
-  INT_CLASS Class;
+  int i;
   int unicharset_size = target_unicharset.size();
-  int version_id = -5;  // When negated by the reader -1 becomes +1 etc.
+  int version_id = -6;  // When negated by the reader -1 becomes +1 etc.
 
   if (Templates->NumClasses != unicharset_size) {
     cprintf("Warning: executing WriteIntTemplates() with %d classes in"
             " Templates, while target_unicharset size is %d\n",
             Templates->NumClasses, unicharset_size);
   }
+  for (i = 0; i < Templates->NumClasses; i++) {
+    INT_CLASS Class = Templates->Class[i];
+    ASSERT_HOST(Class->NumConfigs ==
+                this->fontset_table_.get(Class->font_set_id).size);
+  }
 
   /* first write the high level template struct */
   fwrite(&unicharset_size, sizeof(unicharset_size), 1, File);
@@ -1201,38 +1341,8 @@ void Classify::WriteIntTemplates(FILE *File, INT_TEMPLATES Templates,
          1, File);
   fwrite(&Templates->NumClasses, sizeof(Templates->NumClasses), 1, File);
 
-  /* then write out the class pruners */
-  for (i = 0; i < Templates->NumClassPruners; i++)
-    fwrite(Templates->ClassPruners[i],
-           sizeof(CLASS_PRUNER_STRUCT), 1, File);
-
-  /* then write out each class */
-  for (i = 0; i < Templates->NumClasses; i++) {
-    Class = Templates->Class[i];
-
-    /* first write out the high level struct for the class */
-    fwrite(&Class->NumProtos, sizeof(Class->NumProtos), 1, File);
-    fwrite(&Class->NumProtoSets, sizeof(Class->NumProtoSets), 1, File);
-    ASSERT_HOST(Class->NumConfigs == this->fontset_table_.get(Class->font_set_id).size);
-    fwrite(&Class->NumConfigs, sizeof(Class->NumConfigs), 1, File);
-    for (j = 0; j < Class->NumConfigs; ++j) {
-      fwrite(&Class->ConfigLengths[j], sizeof(uinT16), 1, File);
-    }
-
-    /* then write out the proto lengths */
-    if (MaxNumIntProtosIn (Class) > 0) {
-      fwrite ((char *) (Class->ProtoLengths), sizeof (uinT8),
-              MaxNumIntProtosIn (Class), File);
-    }
-
-    /* then write out the proto sets */
-    for (j = 0; j < Class->NumProtoSets; j++)
-      fwrite ((char *) Class->ProtoSets[j],
-              sizeof (PROTO_SET_STRUCT), 1, File);
-
-    /* then write the fonts info */
-    fwrite(&Class->font_set_id, sizeof(int), 1, File);
-  }
+  /* then write out the classes, class pruners and proto sets */
+  WriteIntTemplateBlocks(File, Templates);
 
   /* Write the fonts info tables */
   this->fontinfo_table_.write(File, NewPermanentTessCallback(write_info));
@@ -2008,3 +2118,157 @@ ScrollView* CreateFeatureSpaceWindow(const char* name, int xpos, int ypos) {
   return new ScrollView(name, xpos, ypos, 520, 520, 260, 260, true);
 }
 #endif  // GRAPHICS_DISABLED
+
+
+/*---------------------------------------------------------------------------*/
+bool ReadIntTemplateBlocks(FILE *File, bool swap, INT_TEMPLATES Templates) {
+/*
+ ** Parameters:
+ **   File    open file to read the blocks from
+ **   swap    true if the file has the opposite endianness
+ **   Templates  templates to read the classes and class pruners into,
+ **              which have NumClasses and NumClassPruners set
+ ** Globals: none
+ ** Operation: This routine reads the classes, class pruners, proto sets
+ **   and proto lengths written by WriteIntTemplateBlocks, with one read
+ **   for each. The parts of all the classes are kept in the blocks owned
+ **   by Templates, so they are contiguous in memory.
+ ** Return: false if the read fails or the blocks are inconsistent.
+ ** Exceptions: none
+ */
+  int NumClasses = Templates->NumClasses;
+  int NumClassPruners = Templates->NumClassPruners;
+  inT32 NumProtoSets;
+  // The counts are set again as the parts are filled in, so the templates
+  // can be freed whatever happens.
+  Templates->NumClasses = 0;
+  Templates->NumClassPruners = 0;
+  if (NumClasses < 0 || NumClasses > MAX_NUM_CLASSES ||
+      NumClassPruners < 0 || NumClassPruners > MAX_NUM_CLASS_PRUNERS ||
+      fread(&NumProtoSets, sizeof(NumProtoSets), 1, File) != 1)
+    return false;
+  if (swap)
+    Reverse32(&NumProtoSets);
+  if (NumProtoSets < 0 || NumProtoSets > NumClasses * MAX_NUM_PROTO_SETS)
+    return false;
+  INT_CLASS_HEADER *Headers = new INT_CLASS_HEADER[NumClasses + 1];
+  Templates->ClassBlock = new INT_CLASS_STRUCT[NumClasses + 1];
+  Templates->ClassPrunerBlock = new CLASS_PRUNER_STRUCT[NumClassPruners + 1];
+  Templates->ProtoSetBlock = new PROTO_SET_STRUCT[NumProtoSets + 1];
+  Templates->ProtoLengthBlock =
+      new uinT8[NumProtoSets * PROTOS_PER_PROTO_SET + 1];
+  size_t NumProtoLengths = NumProtoSets * PROTOS_PER_PROTO_SET;
+  if (fread(Headers, sizeof(*Headers), NumClasses, File) !=
+          static_cast<size_t>(NumClasses) ||
+      fread(Templates->ClassPrunerBlock, sizeof(CLASS_PRUNER_STRUCT),
+            NumClassPruners, File) != static_cast<size_t>(NumClassPruners) ||
+      fread(Templates->ProtoSetBlock, sizeof(PROTO_SET_STRUCT),
+            NumProtoSets, File) != static_cast<size_t>(NumProtoSets) ||
+      fread(Templates->ProtoLengthBlock, sizeof(uinT8),
+            NumProtoLengths, File) != NumProtoLengths) {
+    delete [] Headers;
+    return false;
+  }
+  if (swap) {
+    uinT32 *Words = &Templates->ClassPrunerBlock[0].p[0][0][0][0];
+    for (int i = 0; i < NumClassPruners * WERDS_PER_CP; ++i)
+      Reverse32(&Words[i]);
+    for (int i = 0; i < NumProtoSets; ++i) {
+      PROTO_SET ProtoSet = &Templates->ProtoSetBlock[i];
+      uinT32 *Pruner = &ProtoSet->ProtoPruner[0][0][0];
+      for (int w = 0; w < WERDS_PER_PP; ++w)
+        Reverse32(&Pruner[w]);
+      for (int p = 0; p < PROTOS_PER_PROTO_SET; ++p)
+        for (int w = 0; w < WERDS_PER_CONFIG_VEC; ++w)
+          Reverse32(&ProtoSet->Protos[p].Configs[w]);
+    }
+  }
+  for (int i = 0; i < NumClassPruners; ++i)
+    Templates->ClassPruners[i] = &Templates->ClassPrunerBlock[i];
+  Templates->NumClassPruners = NumClassPruners;
+  int ProtoSetIndex = 0;
+  bool ok = true;
+  for (int i = 0; i < NumClasses && ok; ++i) {
+    INT_CLASS_HEADER *Header = &Headers[i];
+    if (swap) {
+      Reverse16(&Header->NumProtos);
+      Reverse32(&Header->font_set_id);
+      for (int j = 0; j < MAX_NUM_CONFIGS; ++j)
+        Reverse16(&Header->ConfigLengths[j]);
+    }
+    if (Header->NumProtoSets > MAX_NUM_PROTO_SETS ||
+        Header->NumProtos > Header->NumProtoSets * PROTOS_PER_PROTO_SET ||
+        Header->NumConfigs > MAX_NUM_CONFIGS ||
+        ProtoSetIndex + Header->NumProtoSets > NumProtoSets) {
+      ok = false;
+      break;
+    }
+    INT_CLASS Class = &Templates->ClassBlock[i];
+    Class->NumProtos = Header->NumProtos;
+    Class->NumProtoSets = Header->NumProtoSets;
+    Class->NumConfigs = Header->NumConfigs;
+    Class->font_set_id = Header->font_set_id;
+    memcpy(Class->ConfigLengths, Header->ConfigLengths,
+           sizeof(Class->ConfigLengths));
+    for (int j = 0; j < Class->NumProtoSets; ++j)
+      Class->ProtoSets[j] = &Templates->ProtoSetBlock[ProtoSetIndex + j];
+    Class->ProtoLengths = NULL;
+    if (MaxNumIntProtosIn(Class) > 0) {
+      Class->ProtoLengths = &Templates->ProtoLengthBlock[
+          ProtoSetIndex * PROTOS_PER_PROTO_SET];
+    }
+    ProtoSetIndex += Class->NumProtoSets;
+    Templates->Class[i] = Class;
+    Templates->NumClasses = i + 1;
+  }
+  delete [] Headers;
+  return ok && ProtoSetIndex == NumProtoSets;
+}
+
+
+/*---------------------------------------------------------------------------*/
+void WriteIntTemplateBlocks(FILE *File, INT_TEMPLATES Templates) {
+/*
+ ** Parameters:
+ **   File    open file to write the blocks to
+ **   Templates  templates to write the classes and class pruners of
+ ** Globals: none
+ ** Operation: This routine writes the total number of proto sets, and then
+ **   the fixed size records of the classes, the class pruners, the proto
+ **   sets and the proto lengths of all the classes, each as one block.
+ ** Return: none
+ ** Exceptions: none
+ */
+  int i, j;
+  inT32 NumProtoSets = 0;
+  for (i = 0; i < Templates->NumClasses; i++)
+    NumProtoSets += Templates->Class[i]->NumProtoSets;
+  fwrite(&NumProtoSets, sizeof(NumProtoSets), 1, File);
+
+  for (i = 0; i < Templates->NumClasses; i++) {
+    INT_CLASS Class = Templates->Class[i];
+    INT_CLASS_HEADER Header;
+    memset(&Header, 0, sizeof(Header));
+    Header.NumProtos = Class->NumProtos;
+    Header.NumProtoSets = Class->NumProtoSets;
+    Header.NumConfigs = Class->NumConfigs;
+    Header.font_set_id = Class->font_set_id;
+    for (j = 0; j < Class->NumConfigs; ++j)
+      Header.ConfigLengths[j] = Class->ConfigLengths[j];
+    fwrite(&Header, sizeof(Header), 1, File);
+  }
+  for (i = 0; i < Templates->NumClassPruners; i++)
+    fwrite(Templates->ClassPruners[i], sizeof(CLASS_PRUNER_STRUCT), 1, File);
+  for (i = 0; i < Templates->NumClasses; i++) {
+    INT_CLASS Class = Templates->Class[i];
+    for (j = 0; j < Class->NumProtoSets; j++)
+      fwrite(Class->ProtoSets[j], sizeof(PROTO_SET_STRUCT), 1, File);
+  }
+  for (i = 0; i < Templates->NumClasses; i++) {
+    INT_CLASS Class = Templates->Class[i];
+    if (MaxNumIntProtosIn(Class) > 0) {
+      fwrite(Class->ProtoLengths, sizeof(uinT8), MaxNumIntProtosIn(Class),
+             File);
+    }
+  }
+}
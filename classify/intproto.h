@@ -123,6 +123,13 @@ typedef struct
   int NumClassPruners;
   INT_CLASS Class[MAX_NUM_CLASSES];
   CLASS_PRUNER_STRUCT* ClassPruners[MAX_NUM_CLASS_PRUNERS];
+  // If the templates were read in blocks, the classes, pruners, proto sets
+  // and proto lengths point into these, which own the memory, and the
+  // classes must not grow. NULL if each part is allocated separately.
+  INT_CLASS_STRUCT* ClassBlock;
+  CLASS_PRUNER_STRUCT* ClassPrunerBlock;
+  PROTO_SET_STRUCT* ProtoSetBlock;
+  uinT8* ProtoLengthBlock;
 }
 
 
@@ -232,10 +239,14 @@ void DisplayIntProto(INT_CLASS Class, PROTO_ID ProtoId, FLOAT32 Evidence);
 
 INT_CLASS NewIntClass(int MaxNumProtos, int MaxNumConfigs);
 
+void free_int_class(INT_CLASS int_class);
+
 INT_TEMPLATES NewIntTemplates();
 
 void free_int_templates(INT_TEMPLATES templates);
 
+void UnpackIntTemplates(INT_TEMPLATES templates);
+
 void ShowMatchDisplay();
 
 namespace tesseract {
@@ -33,6 +33,7 @@
 #include "efio.h"
 #include "errorcounter.h"
 #include "featdefs.h"
+#include "genericheap.h"
 #include "sampleiterator.h"
 #include "shapeclassifier.h"
 #include "shapetable.h"
@@ -265,6 +266,19 @@ void MasterTrainer::PreTrainingSetup() {
 void MasterTrainer::SetupMasterShapes() {
   tprintf("Building master shape table\n");
   int num_fonts = samples_.NumFonts();
+  // Compute all the font distances within each class in parallel up front,
+  // as the per-class clustering below is too small to parallelize well.
+  GenericVector<FontClassPair> font_pairs;
+  for (int c = 0; c < samples_.charsetsize(); ++c) {
+    for (int f1 = 0; f1 < num_fonts; ++f1) {
+      if (samples_.NumClassSamples(f1, c, true) == 0) continue;
+      for (int f2 = f1 + 1; f2 < num_fonts; ++f2) {
+        if (samples_.NumClassSamples(f2, c, true) > 0)
+          font_pairs.push_back(FontClassPair(f1, c, f2, c));
+      }
+    }
+  }
+  samples_.PrecomputeClusterDistances(font_pairs, feature_map_);
 
   ShapeTable char_shapes_begin_fragment(samples_.unicharset());
   ShapeTable char_shapes_end_fragment(samples_.unicharset());
@@ -655,6 +669,15 @@ void MasterTrainer::DebugCanonical(const char* unichar_str1,
   }
   int num_fonts = samples_.NumFonts();
   const IntFeatureMap& feature_map = feature_map_;
+  GenericVector<FontClassPair> font_pairs;
+  for (int f1 = 0; f1 < num_fonts; ++f1) {
+    if (samples_.NumClassSamples(f1, class_id1, false) == 0) continue;
+    for (int f2 = 0; f2 < num_fonts; ++f2) {
+      if (samples_.NumClassSamples(f2, class_id2, false) > 0)
+        font_pairs.push_back(FontClassPair(f1, class_id1, f2, class_id2));
+    }
+  }
+  samples_.PrecomputeClusterDistances(font_pairs, feature_map);
   // Iterate the fonts to get the similarity with other fonst of the same
   // class.
   tprintf("      ");
@@ -903,75 +926,144 @@ void MasterTrainer::ReplaceFragmentedSamples() {
   fragments_ = NULL;
 }
 
+const float kInfiniteDist = 999.0f;
+
+// Returns the minimum of the given row of the shape distance table, with ties
+// going to the lowest shape2. Returns kInfiniteDist if the row has no finite
+// distances left.
+static ShapeDist RowMinimum(int s1, const GenericVector<ShapeDist>& row) {
+  ShapeDist best(s1, s1, kInfiniteDist);
+  for (int i = 0; i < row.size(); ++i) {
+    if (row[i].distance < best.distance)
+      best = row[i];
+  }
+  return best;
+}
+
+// Recomputes the distances between the given pairs of shapes in parallel,
+// storing the results in the shape_dists table.
+void MasterTrainer::ComputeShapeDistances(
+    const ShapeTable& shapes, const GenericVector<ShapeDist>& pairs,
+    GenericVector<ShapeDist>* shape_dists) {
+  int num_pairs = pairs.size();
+  #pragma omp parallel for schedule(dynamic)
+  for (int p = 0; p < num_pairs; ++p) {
+    int s1 = pairs[p].shape1;
+    int s2 = pairs[p].shape2;
+    shape_dists[s1][s2 - s1 - 1].distance = ShapeDistance(shapes, s1, s2);
+  }
+}
+
 // Runs a hierarchical agglomerative clustering to merge shapes in the given
 // shape_table, while satisfying the given constraints:
 // * End with at least min_shapes left in shape_table,
 // * No shape shall have more than max_shape_unichars in it,
 // * Don't merge shapes where the distance between them exceeds max_dist.
-const float kInfiniteDist = 999.0f;
+// The initial distance table is computed in parallel. The minimum of each row
+// of the table is kept in a heap, so that finding the next merge only
+// requires rescanning the rows whose minimum was changed by the last merge.
+// Stale heap entries are discarded lazily when they reach the top.
+// The result is identical to repeatedly picking the first minimum of the
+// whole table in row-major order.
 void MasterTrainer::ClusterShapes(int min_shapes,  int max_shape_unichars,
                                   float max_dist, ShapeTable* shapes) {
   int num_shapes = shapes->NumShapes();
   int max_merges = num_shapes - min_shapes;
   GenericVector<ShapeDist>* shape_dists =
       new GenericVector<ShapeDist>[num_shapes];
-  float min_dist = kInfiniteDist;
-  int min_s1 = 0;
-  int min_s2 = 0;
   tprintf("Computing shape distances...");
   for (int s1 = 0; s1 < num_shapes; ++s1) {
-    for (int s2 = s1 + 1; s2 < num_shapes; ++s2) {
-      ShapeDist dist(s1, s2, ShapeDistance(*shapes, s1, s2));
-      shape_dists[s1].push_back(dist);
-      if (dist.distance < min_dist) {
-        min_dist = dist.distance;
-        min_s1 = s1;
-        min_s2 = s2;
-      }
-    }
-    tprintf(" %d", s1);
+    shape_dists[s1].reserve(num_shapes - s1 - 1);
+    for (int s2 = s1 + 1; s2 < num_shapes; ++s2)
+      shape_dists[s1].push_back(ShapeDist(s1, s2, kInfiniteDist));
   }
-  tprintf("\n");
+  #pragma omp parallel for schedule(dynamic)
+  for (int s1 = 0; s1 < num_shapes; ++s1) {
+    GenericVector<ShapeDist>& row = shape_dists[s1];
+    for (int i = 0; i < row.size(); ++i)
+      row[i].distance = ShapeDistance(*shapes, s1, row[i].shape2);
+  }
+  tprintf(" done\n");
+  // Current minimum of each row, and a heap of row minima, some of which may
+  // be stale.
+  GenericVector<ShapeDist> row_mins;
+  GenericHeap<ShapeDist> heap;
+  for (int s1 = 0; s1 < num_shapes; ++s1) {
+    row_mins.push_back(RowMinimum(s1, shape_dists[s1]));
+    if (row_mins[s1].distance < kInfiniteDist)
+      heap.Push(&row_mins[s1]);
+  }
+  GenericVector<ShapeDist> pairs;
+  GenericVector<int> changed_rows;
+  float min_dist = kInfiniteDist;
   int num_merged = 0;
-  while (num_merged < max_merges && min_dist < max_dist) {
+  while (num_merged < max_merges) {
+    // Discard stale entries to find the true minimum.
+    ShapeDist best;
+    min_dist = kInfiniteDist;
+    while (heap.Pop(&best)) {
+      const ShapeDist& row_min = row_mins[best.shape1];
+      if (row_min.shape2 == best.shape2 && row_min.distance == best.distance) {
+        min_dist = best.distance;
+        break;
+      }
+    }
+    if (min_dist >= max_dist) break;
+    int min_s1 = best.shape1;
+    int min_s2 = best.shape2;
     tprintf("Distance = %f: ", min_dist);
     int num_unichars = shapes->MergedUnicharCount(min_s1, min_s2);
     shape_dists[min_s1][min_s2 - min_s1 - 1].distance = kInfiniteDist;
+    changed_rows.truncate(0);
+    changed_rows.push_back(min_s1);
     if (num_unichars > max_shape_unichars) {
       tprintf("Merge of %d and %d with %d would exceed max of %d unichars\n",
               min_s1, min_s2, num_unichars, max_shape_unichars);
     } else {
       shapes->MergeShapes(min_s1, min_s2);
       shape_dists[min_s2].clear();
+      row_mins[min_s2].distance = kInfiniteDist;
       ++num_merged;
 
+      pairs.truncate(0);
       for (int s = 0; s < min_s1; ++s) {
         if (!shape_dists[s].empty()) {
-          shape_dists[s][min_s1 - s - 1].distance =
-              ShapeDistance(*shapes, s, min_s1);
+          pairs.push_back(ShapeDist(s, min_s1, kInfiniteDist));
           shape_dists[s][min_s2 - s -1].distance = kInfiniteDist;
+          changed_rows.push_back(s);
         }
       }
       for (int s2 = min_s1 + 1; s2 < num_shapes; ++s2) {
         if (shape_dists[min_s1][s2 - min_s1 - 1].distance < kInfiniteDist)
-          shape_dists[min_s1][s2 - min_s1 - 1].distance =
-              ShapeDistance(*shapes, min_s1, s2);
+          pairs.push_back(ShapeDist(min_s1, s2, kInfiniteDist));
       }
       for (int s = min_s1 + 1; s < min_s2; ++s) {
         if (!shape_dists[s].empty()) {
           shape_dists[s][min_s2 - s - 1].distance = kInfiniteDist;
+          if (row_mins[s].shape2 == min_s2)
+            changed_rows.push_back(s);
         }
       }
+      ComputeShapeDistances(*shapes, pairs, shape_dists);
     }
-    min_dist = kInfiniteDist;
-    for (int s1 = 0; s1 < num_shapes; ++s1) {
-      for (int i = 0; i < shape_dists[s1].size(); ++i) {
-        if (shape_dists[s1][i].distance < min_dist) {
-          min_dist = shape_dists[s1][i].distance;
-          min_s1 = s1;
-          min_s2 = s1 + 1 + i;
-        }
+    // Update the minima of the rows that were touched, rescanning a row only
+    // if its minimum may have increased.
+    for (int i = 0; i < changed_rows.size(); ++i) {
+      int s = changed_rows[i];
+      ShapeDist& row_min = row_mins[s];
+      if (s == min_s1 || row_min.shape2 == min_s1 || row_min.shape2 == min_s2) {
+        row_min = RowMinimum(s, shape_dists[s]);
+      } else {
+        const ShapeDist& merged = shape_dists[s][min_s1 - s - 1];
+        if (merged.distance < row_min.distance ||
+            (merged.distance == row_min.distance &&
+             merged.shape2 < row_min.shape2))
+          row_min = merged;
+        else
+          continue;  // Unchanged, so nothing to push.
       }
+      if (row_min.distance < kInfiniteDist)
+        heap.Push(&row_min);
     }
   }
   tprintf("Stopped with %d merged, min dist %f\n", num_merged, min_dist);
@@ -985,5 +1077,4 @@ void MasterTrainer::ClusterShapes(int min_shapes,  int max_shape_unichars,
   }
 }
 
-
 }  // namespace tesseract.
@@ -52,9 +52,12 @@ struct ShapeDist {
   ShapeDist(int s1, int s2, float dist)
     : shape1(s1), shape2(s2), distance(dist) {}
 
-  // Sort operator to sort in ascending order of distance.
+  // Sort operator to sort in ascending order of distance, with ties broken
+  // by ascending shape1, then shape2, so the order is deterministic.
   bool operator<(const ShapeDist& other) const {
-    return distance < other.distance;
+    if (distance != other.distance) return distance < other.distance;
+    if (shape1 != other.shape1) return shape1 < other.shape1;
+    return shape2 < other.shape2;
   }
 
   int shape1;
@@ -262,6 +265,11 @@ class MasterTrainer {
   // * Don't merge shapes where the distance between them exceeds max_dist.
   void ClusterShapes(int min_shapes, int max_shape_unichars,
                      float max_dist, ShapeTable* shape_table);
+  // Recomputes the distances between the given pairs of shapes in parallel,
+  // storing the results in the shape_dists table used by ClusterShapes.
+  void ComputeShapeDistances(const ShapeTable& shapes,
+                             const GenericVector<ShapeDist>& pairs,
+                             GenericVector<ShapeDist>* shape_dists);
 
  private:
   NormalizationMode norm_mode_;
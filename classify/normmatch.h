@@ -25,6 +25,8 @@
 #include "ocrfeatures.h"
 #include "params.h"
 
+struct NORM_PROTOS;
+
 /**----------------------------------------------------------------------------
         Variables
 ----------------------------------------------------------------------------**/
@@ -34,4 +36,9 @@ extern double_VAR_H(classify_norm_adj_midpoint, 32.0,
                     "Norm adjust midpoint ...");
 extern double_VAR_H(classify_norm_adj_curl, 2.0, "Norm adjust curl ...");
 
+/**----------------------------------------------------------------------------
+          Public Function Prototypes
+----------------------------------------------------------------------------**/
+void free_norm_protos(NORM_PROTOS *norm_protos);
+
 #endif
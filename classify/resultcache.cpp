@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////
+// File:        resultcache.cpp
+// Description: Cache of static classifier results within a page.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "resultcache.h"
+
+#include "trainingsample.h"
+
+namespace tesseract {
+
+// Number of hash buckets. Pages rarely need more than a few thousand
+// entries, so the chains stay short without any rehashing.
+const int kNumCacheBuckets = 4096;
+
+// Appends the bytes of the given object to the key.
+static void AppendBytes(const void* data, int size, GenericVector<char>* key) {
+  const char* bytes = static_cast<const char*>(data);
+  for (int i = 0; i < size; ++i)
+    key->push_back(bytes[i]);
+}
+
+ClassifierResultCache::ClassifierResultCache() {
+  buckets_.init_to_size(kNumCacheBuckets, GenericVector<int>());
+}
+
+// Copies the results cached for the given sample to results and returns
+// true, or returns false if the sample has not been seen.
+bool ClassifierResultCache::Lookup(
+    const TrainingSample& sample,
+    GenericVector<UnicharRating>* results) const {
+  GenericVector<char> key;
+  MakeKey(sample, &key);
+  uinT32 hash = HashKey(key);
+  mutex_.Lock();
+  int index = FindEntry(key, hash);
+  if (index >= 0)
+    *results = entries_[index]->results;
+  mutex_.Unlock();
+  return index >= 0;
+}
+
+// Caches the results for the given sample, unless max_size samples are
+// already cached.
+void ClassifierResultCache::Insert(const TrainingSample& sample,
+                                   const GenericVector<UnicharRating>& results,
+                                   int max_size) {
+  Entry* entry = new Entry;
+  MakeKey(sample, &entry->key);
+  entry->hash = HashKey(entry->key);
+  entry->results = results;
+  mutex_.Lock();
+  if (entries_.size() < max_size && FindEntry(entry->key, entry->hash) < 0) {
+    buckets_[entry->hash % kNumCacheBuckets].push_back(entries_.size());
+    entries_.push_back(entry);
+    entry = NULL;
+  }
+  mutex_.Unlock();
+  delete entry;
+}
+
+// Forgets all the cached results.
+void ClassifierResultCache::Clear() {
+  mutex_.Lock();
+  for (int b = 0; b < buckets_.size(); ++b)
+    buckets_[b].truncate(0);
+  entries_.clear();
+  mutex_.Unlock();
+}
+
+// Fills key with the features of the sample used by the static classifier.
+void ClassifierResultCache::MakeKey(const TrainingSample& sample,
+                                    GenericVector<char>* key) {
+  int num_features = sample.num_features();
+  key->reserve(sizeof(int) * (GeoCount + 1) + sizeof(float) * kNumCNParams +
+               sizeof(INT_FEATURE_STRUCT) * num_features);
+  AppendBytes(&num_features, sizeof(num_features), key);
+  for (int g = 0; g < GeoCount; ++g) {
+    int geo = sample.geo_feature(g);
+    AppendBytes(&geo, sizeof(geo), key);
+  }
+  for (int p = 0; p < kNumCNParams; ++p) {
+    float param = sample.cn_feature(p);
+    AppendBytes(&param, sizeof(param), key);
+  }
+  const INT_FEATURE_STRUCT* features = sample.features();
+  for (int f = 0; f < num_features; ++f) {
+    // The fields are copied one by one as the struct may have padding.
+    char feature[4] = {
+      static_cast<char>(features[f].X), static_cast<char>(features[f].Y),
+      static_cast<char>(features[f].Theta),
+      static_cast<char>(features[f].CP_misses)
+    };
+    AppendBytes(feature, sizeof(feature), key);
+  }
+}
+
+// Returns the hash of the given key.
+uinT32 ClassifierResultCache::HashKey(const GenericVector<char>& key) {
+  // FNV-1a.
+  uinT32 hash = 2166136261u;
+  for (int i = 0; i < key.size(); ++i) {
+    hash ^= static_cast<uinT8>(key[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Returns the index in entries_ of the given key, or -1 if it is not there.
+int ClassifierResultCache::FindEntry(const GenericVector<char>& key,
+                                     uinT32 hash) const {
+  const GenericVector<int>& bucket = buckets_[hash % kNumCacheBuckets];
+  for (int i = 0; i < bucket.size(); ++i) {
+    const Entry* entry = entries_[bucket[i]];
+    if (entry->hash != hash || entry->key.size() != key.size())
+      continue;
+    int b = 0;
+    while (b < key.size() && entry->key[b] == key[b]) ++b;
+    if (b == key.size())
+      return bucket[i];
+  }
+  return -1;
+}
+
+}  // namespace tesseract.
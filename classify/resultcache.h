@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////
+// File:        resultcache.h
+// Description: Cache of static classifier results within a page.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CLASSIFY_RESULTCACHE_H_
+#define TESSERACT_CLASSIFY_RESULTCACHE_H_
+
+#include "ccutil.h"
+#include "genericvector.h"
+#include "shapetable.h"
+
+namespace tesseract {
+
+class TrainingSample;
+
+// Remembers the results of the static classifier for each distinct sample
+// seen within a page, so that a blob that is classified again, in pass 2
+// or in another segmentation search over the same word, does not go
+// through the class pruner and integer matcher a second time.
+// The static templates do not change during a page, so the cached results
+// are exactly those that would be computed again. Results from the adapted
+// templates are not cached, as those change as the page is recognized.
+// Samples are identified by all of their features used by the static
+// classifier, not just a hash, so a hit is never a different blob.
+// Lookup and Insert may be called from several threads at once.
+class ClassifierResultCache {
+ public:
+  ClassifierResultCache();
+
+  // Copies the results cached for the given sample to results and returns
+  // true, or returns false if the sample has not been seen.
+  bool Lookup(const TrainingSample& sample,
+              GenericVector<UnicharRating>* results) const;
+  // Caches the results for the given sample, unless max_size samples are
+  // already cached.
+  void Insert(const TrainingSample& sample,
+              const GenericVector<UnicharRating>& results, int max_size);
+  // Forgets all the cached results.
+  void Clear();
+
+  int size() const {
+    return entries_.size();
+  }
+
+ private:
+  struct Entry {
+    uinT32 hash;
+    GenericVector<char> key;
+    GenericVector<UnicharRating> results;
+  };
+
+  // Fills key with the features of the sample used by the static classifier.
+  static void MakeKey(const TrainingSample& sample, GenericVector<char>* key);
+  // Returns the hash of the given key.
+  static uinT32 HashKey(const GenericVector<char>& key);
+  // Returns the index in entries_ of the given key, or -1 if it is not there.
+  int FindEntry(const GenericVector<char>& key, uinT32 hash) const;
+
+  // Indices into entries_, by hash modulo the number of buckets.
+  GenericVector<GenericVector<int> > buckets_;
+  PointerVector<Entry> entries_;
+  mutable CCUtilMutex mutex_;
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_CLASSIFY_RESULTCACHE_H_
@@ -0,0 +1,38 @@
+///////////////////////////////////////////////////////////////////////
+// File:        staticmodel.cpp
+// Description: The parts of the static classifier that are loaded from a
+//              traineddata file and shared by all instances that load it.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "staticmodel.h"
+
+#include "normmatch.h"
+#include "shapetable.h"
+
+namespace tesseract {
+
+StaticClassifierModel::StaticClassifierModel()
+  : templates(NULL), shape_table(NULL), norm_protos(NULL),
+    font_tables_offset(0), inttemp_version(0), inttemp_swap(false) {
+}
+
+StaticClassifierModel::~StaticClassifierModel() {
+  if (templates != NULL)
+    free_int_templates(templates);
+  delete shape_table;
+  if (norm_protos != NULL)
+    free_norm_protos(norm_protos);
+}
+
+}  // namespace tesseract.
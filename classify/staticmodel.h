@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////
+// File:        staticmodel.h
+// Description: The parts of the static classifier that are loaded from a
+//              traineddata file and shared by all instances that load it.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CLASSIFY_STATICMODEL_H_
+#define TESSERACT_CLASSIFY_STATICMODEL_H_
+
+#include "genericvector.h"
+#include "host.h"
+#include "intproto.h"
+#include "unicharset.h"
+
+struct NORM_PROTOS;
+
+namespace tesseract {
+
+class ShapeTable;
+
+// The templates, shape table, cutoffs and norm protos of the static
+// classifier, which are never changed once they are loaded. Classify
+// instances that load the same traineddata share a single copy through
+// Classify::GlobalStaticModelCache(), so a pool of engines neither loads
+// nor holds the model more than once.
+// The font tables that follow the templates are not shared, as each
+// instance assigns its own universal font ids. Each instance reads them
+// from its own copy of the file, at font_tables_offset.
+struct StaticClassifierModel {
+  StaticClassifierModel();
+  ~StaticClassifierModel();
+
+  INT_TEMPLATES templates;
+  // NULL if the traineddata has no shape table.
+  ShapeTable* shape_table;
+  // The shape table refers to this copy of the unicharset, so the model
+  // does not depend on the instance that loaded it.
+  UNICHARSET unicharset;
+  // Expected number of features for each shape and for each class.
+  GenericVector<uinT16> shapetable_cutoffs;
+  GenericVector<uinT16> char_norm_cutoffs;
+  NORM_PROTOS* norm_protos;
+  // Offset of the font tables from the start of the inttemp component, the
+  // version of its format and whether it is byte swapped.
+  inT64 font_tables_offset;
+  int inttemp_version;
+  bool inttemp_swap;
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_CLASSIFY_STATICMODEL_H_
@@ -67,6 +67,129 @@ bool TrainingSampleSet::FontClassInfo::DeSerialize(bool swap, FILE* fp) {
   return true;
 }
 
+ClusterDistanceCache::ClusterDistanceCache() {
+}
+
+// Deletes all cached distances.
+void ClusterDistanceCache::Clear() {
+  for (int s = 0; s < kNumShards; ++s) {
+    Shard& shard = shards_[s];
+    shard.mutex.Lock();
+    shard.table.clear();
+    shard.num_used = 0;
+    shard.mutex.Unlock();
+  }
+}
+
+// Returns the number of cached distances.
+int ClusterDistanceCache::size() const {
+  int total = 0;
+  for (int s = 0; s < kNumShards; ++s) {
+    shards_[s].mutex.Lock();
+    total += shards_[s].num_used;
+    shards_[s].mutex.Unlock();
+  }
+  return total;
+}
+
+// Returns true and the cached distance in *distance, or false if the
+// distance between the given pair is not cached.
+bool ClusterDistanceCache::Lookup(const FontClassPair& pair,
+                                  float* distance) const {
+  uinT64 key = PackKey(pair);
+  uinT64 hash = HashKey(key);
+  const Shard& shard = shards_[hash >> (64 - kShardBits)];
+  bool found = false;
+  shard.mutex.Lock();
+  if (!shard.table.empty()) {
+    const Entry& entry = shard.table[shard.FindSlot(key, hash)];
+    if (entry.key == key) {
+      *distance = entry.distance;
+      found = true;
+    }
+  }
+  shard.mutex.Unlock();
+  return found;
+}
+
+// Caches the distance for the given pair (and its symmetric counterpart).
+void ClusterDistanceCache::Store(const FontClassPair& pair, float distance) {
+  uinT64 key = PackKey(pair);
+  uinT64 hash = HashKey(key);
+  Shard& shard = shards_[hash >> (64 - kShardBits)];
+  shard.mutex.Lock();
+  // Keep the load factor below 1/2.
+  if (2 * (shard.num_used + 1) > shard.table.size())
+    shard.Grow();
+  Entry& entry = shard.table[shard.FindSlot(key, hash)];
+  if (entry.key != key) {
+    entry.key = key;
+    ++shard.num_used;
+  }
+  entry.distance = distance;
+  shard.mutex.Unlock();
+}
+
+// Returns the index in table of key, or of the empty slot it belongs in.
+int ClusterDistanceCache::Shard::FindSlot(uinT64 key, uinT64 hash) const {
+  int mask = table.size() - 1;
+  int index = static_cast<int>(hash) & mask;
+  while (table[index].key != key && table[index].key != kEmptyKey)
+    index = (index + 1) & mask;
+  return index;
+}
+
+// Doubles the size of the table, rehashing all the entries.
+void ClusterDistanceCache::Shard::Grow() {
+  const int kInitialSize = 64;
+  GenericVector<Entry> old_table(table);
+  table.clear();
+  Entry empty = { kEmptyKey, 0.0f };
+  table.init_to_size(MAX(kInitialSize, old_table.size() * 2), empty);
+  for (int i = 0; i < old_table.size(); ++i) {
+    if (old_table[i].key != kEmptyKey)
+      table[FindSlot(old_table[i].key, HashKey(old_table[i].key))] =
+          old_table[i];
+  }
+}
+
+// Returns the packed symmetric key for the given pair. The lower of the two
+// font/class combinations goes in the top half, so (a, b) and (b, a) share
+// the same key.
+uinT64 ClusterDistanceCache::PackKey(const FontClassPair& pair) {
+  ASSERT_HOST(pair.font1 >= 0 && pair.font1 < 0xffff);
+  ASSERT_HOST(pair.font2 >= 0 && pair.font2 < 0xffff);
+  ASSERT_HOST(pair.class1 >= 0 && pair.class1 < 0xffff);
+  ASSERT_HOST(pair.class2 >= 0 && pair.class2 < 0xffff);
+  uinT64 fc1 = (static_cast<uinT64>(pair.font1) << 16) | pair.class1;
+  uinT64 fc2 = (static_cast<uinT64>(pair.font2) << 16) | pair.class2;
+  if (fc1 > fc2) {
+    uinT64 tmp = fc1;
+    fc1 = fc2;
+    fc2 = tmp;
+  }
+  return (fc1 << 32) | fc2;
+}
+
+// Returns the hash of the given key, which selects both shard and slot.
+// A plain multiplicative hash leaves the low bits, which select the slot,
+// depending only on the low bits of the key, so the key is fully mixed with
+// the 64 bit finalizer of MurmurHash3, making every bit of the hash depend on
+// every bit of the key. The high bits select the shard and the low bits the
+// slot.
+uinT64 ClusterDistanceCache::HashKey(uinT64 key) {
+  const uinT64 kMultiplier1 = (static_cast<uinT64>(0xff51afd7) << 32) |
+      0xed558ccd;
+  const uinT64 kMultiplier2 = (static_cast<uinT64>(0xc4ceb9fe) << 32) |
+      0x1a85ec53;
+  key ^= key >> 33;
+  key *= kMultiplier1;
+  key ^= key >> 33;
+  key *= kMultiplier2;
+  key ^= key >> 33;
+  return key;
+}
+
 TrainingSampleSet::TrainingSampleSet(const FontInfoTable& font_table)
   : num_raw_samples_(0), unicharset_size_(0),
     font_class_array_(NULL), fontinfo_table_(font_table) {
@@ -107,6 +230,7 @@ bool TrainingSampleSet::DeSerialize(bool swap, FILE* fp) {
     font_class_array_ = new GENERIC_2D_ARRAY<FontClassInfo >(1, 1 , empty);
     if (!font_class_array_->DeSerializeClasses(swap, fp)) return false;
   }
+  distance_cache_.Clear();
   unicharset_size_ = unicharset_.size();
   return true;
 }
@@ -295,6 +419,8 @@ float TrainingSampleSet::UnicharDistance(const UnicharAndFonts& uf1,
 // Returns the distance between the given pair of font/class pairs.
 // Finds in cache or computes and caches.
 // OrganizeByFontAndClass must have been already called.
+// Thread-safe: the distance is computed outside of any lock, so several
+// threads may compute distances at the same time.
 float TrainingSampleSet::ClusterDistance(int font_id1, int class_id1,
                                          int font_id2, int class_id2,
                                          const IntFeatureMap& feature_map) {
@@ -303,66 +429,31 @@ float TrainingSampleSet::ClusterDistance(int font_id1, int class_id1,
   int font_index2 = font_id_map_.SparseToCompact(font_id2);
   if (font_index1 < 0 || font_index2 < 0)
     return 0.0f;
-  FontClassInfo& fc_info = (*font_class_array_)(font_index1, class_id1);
-  if (font_id1 == font_id2) {
-    // Special case cache for speed.
-    if (fc_info.unichar_distance_cache.size() == 0)
-      fc_info.unichar_distance_cache.init_to_size(unicharset_size_, -1.0f);
-    if (fc_info.unichar_distance_cache[class_id2] < 0) {
-      // Distance has to be calculated.
-      float result = ComputeClusterDistance(font_id1, class_id1,
-                                            font_id2, class_id2,
-                                            feature_map);
-      fc_info.unichar_distance_cache[class_id2] = result;
-      // Copy to the symmetric cache entry.
-      FontClassInfo& fc_info2 = (*font_class_array_)(font_index2, class_id2);
-      if (fc_info2.unichar_distance_cache.size() == 0)
-        fc_info2.unichar_distance_cache.init_to_size(unicharset_size_, -1.0f);
-      fc_info2.unichar_distance_cache[class_id1] = result;
-    }
-    return fc_info.unichar_distance_cache[class_id2];
-  } else if (class_id1 == class_id2) {
-    // Another special-case cache for equal class-id.
-    if (fc_info.font_distance_cache.size() == 0)
-      fc_info.font_distance_cache.init_to_size(font_id_map_.CompactSize(),
-                                               -1.0f);
-    if (fc_info.font_distance_cache[font_index2] < 0) {
-      // Distance has to be calculated.
-      float result = ComputeClusterDistance(font_id1, class_id1,
-                                            font_id2, class_id2,
-                                            feature_map);
-      fc_info.font_distance_cache[font_index2] = result;
-      // Copy to the symmetric cache entry.
-      FontClassInfo& fc_info2 = (*font_class_array_)(font_index2, class_id2);
-      if (fc_info2.font_distance_cache.size() == 0)
-        fc_info2.font_distance_cache.init_to_size(font_id_map_.CompactSize(),
-                                                  -1.0f);
-      fc_info2.font_distance_cache[font_index1] = result;
-    }
-    return fc_info.font_distance_cache[font_index2];
-  }
-  // Both font and class are different. Linear search for class_id2/font_id2
-  // in what is a hopefully short list of distances.
-  int cache_index = 0;
-  while (cache_index < fc_info.distance_cache.size() &&
-         (fc_info.distance_cache[cache_index].unichar_id != class_id2 ||
-          fc_info.distance_cache[cache_index].font_id != font_id2))
-    ++cache_index;
-  if (cache_index == fc_info.distance_cache.size()) {
+  FontClassPair pair(font_index1, class_id1, font_index2, class_id2);
+  float result;
+  if (!distance_cache_.Lookup(pair, &result)) {
     // Distance has to be calculated.
-    float result = ComputeClusterDistance(font_id1, class_id1,
-                                          font_id2, class_id2,
-                                          feature_map);
-    FontClassDistance fc_dist = { class_id2, font_id2, result };
-    fc_info.distance_cache.push_back(fc_dist);
-    // Copy to the symmetric cache entry. We know it isn't there already, as
-    // we always copy to the symmetric entry.
-    FontClassInfo& fc_info2 = (*font_class_array_)(font_index2, class_id2);
-    fc_dist.unichar_id = class_id1;
-    fc_dist.font_id = font_id1;
-    fc_info2.distance_cache.push_back(fc_dist);
+    result = ComputeClusterDistance(font_id1, class_id1, font_id2, class_id2,
+                                    feature_map);
+    distance_cache_.Store(pair, result);
+  }
+  return result;
+}
+
+// Computes and caches the distances between all the given pairs of
+// font/class pairs, given by (real) font id, in parallel, so that later
+// calls to ClusterDistance and UnicharDistance are just cache lookups.
+// OrganizeByFontAndClass must have been already called.
+void TrainingSampleSet::PrecomputeClusterDistances(
+    const GenericVector<FontClassPair>& pairs,
+    const IntFeatureMap& feature_map) {
+  int num_pairs = pairs.size();
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (int p = 0; p < num_pairs; ++p) {
+    const FontClassPair& pair = pairs[p];
+    ClusterDistance(pair.font1, pair.class1, pair.font2, pair.class2,
+                    feature_map);
   }
-  return fc_info.distance_cache[cache_index].distance;
 }
 
 // Computes the distance between the given pair of font/class pairs.
@@ -612,6 +703,7 @@ void TrainingSampleSet::OrganizeByFontAndClass() {
   FontClassInfo empty;
   font_class_array_ = new GENERIC_2D_ARRAY<FontClassInfo>(
       compact_font_size, unicharset_size_, empty);
+  distance_cache_.Clear();
   for (int s = 0; s < samples_.size(); ++s) {
     int font_id = samples_[s]->font_id();
     int class_id = samples_[s]->class_id();
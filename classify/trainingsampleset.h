@@ -17,6 +17,7 @@
 #define TESSERACT_TRAINING_TRAININGSAMPLESET_H__
 
 #include "bitvector.h"
+#include "ccutil.h"
 #include "genericvector.h"
 #include "indexmapbidi.h"
 #include "matrix.h"
@@ -34,6 +35,74 @@ class IntFeatureSpace;
 class TrainingSample;
 struct UnicharAndFonts;
 
+// A pair of font/class combinations, used as the key to a distance between
+// them. Depending on context the fonts are either real font ids or compact
+// font indices.
+struct FontClassPair {
+  FontClassPair() : font1(0), class1(0), font2(0), class2(0) {}
+  FontClassPair(int f1, int c1, int f2, int c2)
+    : font1(f1), class1(c1), font2(f2), class2(c2) {}
+
+  int font1;
+  int class1;
+  int font2;
+  int class2;
+};
+
+// Thread-safe cache of the (symmetric) distances between pairs of font/class
+// combinations, keyed on (font1, class1, font2, class2), where the fonts are
+// compact font indices, limited, like the class ids, to 16 bits. The table is
+// split into shards, each with its own mutex, so that many threads can look up
+// and store distances concurrently with little contention.
+class ClusterDistanceCache {
+ public:
+  ClusterDistanceCache();
+
+  // Deletes all cached distances.
+  void Clear();
+  // Returns the number of cached distances.
+  int size() const;
+
+  // Returns true and the cached distance in *distance, or false if the
+  // distance between the given pair is not cached.
+  bool Lookup(const FontClassPair& pair, float* distance) const;
+  // Caches the distance for the given pair (and its symmetric counterpart).
+  void Store(const FontClassPair& pair, float distance);
+
+ private:
+  // Number of independently locked shards. Must be a power of 2.
+  static const int kNumShards = 64;
+  static const int kShardBits = 6;
+  // Key used to mark an empty slot. Can't clash with a real key, as the font
+  // and class indices are limited to 16 bits, and never all 0xffff.
+  static const uinT64 kEmptyKey = ~static_cast<uinT64>(0);
+
+  struct Entry {
+    uinT64 key;
+    float distance;
+  };
+  // One open-addressed (linear probing) hash table.
+  struct Shard {
+    Shard() : num_used(0) {}
+
+    // Returns the index in table of key, or of the empty slot it belongs in.
+    int FindSlot(uinT64 key, uinT64 hash) const;
+    // Doubles the size of the table, rehashing all the entries.
+    void Grow();
+
+    GenericVector<Entry> table;
+    int num_used;
+    mutable CCUtilMutex mutex;
+  };
+
+  // Returns the packed symmetric key for the given pair.
+  static uinT64 PackKey(const FontClassPair& pair);
+  // Returns the hash of the given key, which selects both shard and slot.
+  static uinT64 HashKey(uinT64 key);
+
+  Shard shards_[kNumShards];
+};
+
 // Collection of TrainingSample used for training or testing a classifier.
 // Provides several useful methods to operate on the collection as a whole,
 // including outlier detection and deletion, providing access by font and
@@ -121,10 +190,18 @@ class TrainingSampleSet {
   // Returns the distance between the given pair of font/class pairs.
   // Finds in cache or computes and caches.
   // OrganizeByFontAndClass must have been already called.
+  // May be called concurrently from multiple threads.
   float ClusterDistance(int font_id1, int class_id1,
                         int font_id2, int class_id2,
                         const IntFeatureMap& feature_map);
 
+  // Computes and caches the distances between all the given pairs of
+  // font/class pairs, given by (real) font id, in parallel, so that later
+  // calls to ClusterDistance and UnicharDistance are just cache lookups.
+  // OrganizeByFontAndClass must have been already called.
+  void PrecomputeClusterDistances(const GenericVector<FontClassPair>& pairs,
+                                  const IntFeatureMap& feature_map);
+
   // Computes the distance between the given pair of font/class pairs.
   float ComputeClusterDistance(int font_id1, int class_id1,
                                int font_id2, int class_id2,
@@ -225,12 +302,6 @@ class TrainingSampleSet {
                                  ScrollView* window) const;
 
  private:
-  // Struct to store a triplet of unichar, font, distance in the distance cache.
-  struct FontClassDistance {
-    int unichar_id;
-    int font_id;  // Real font id.
-    float distance;
-  };
   // Simple struct to store information related to each font/class combination.
   struct FontClassInfo {
     FontClassInfo();
@@ -255,16 +326,6 @@ class TrainingSampleSet {
     GenericVector<int> canonical_features;
     // The mapped features of all the samples.
     BitVector cloud_features;
-
-    // Caches for ClusterDistance.
-    // Caches for other fonts but matching this unichar. -1 indicates not set.
-    // Indexed by compact font index from font_id_map_.
-    GenericVector<float> font_distance_cache;
-    // Caches for other unichars but matching this font. -1 indicates not set.
-    GenericVector<float> unichar_distance_cache;
-    // Cache for the rest (non matching font and unichar.)
-    // A cache of distances computed by ReliablySeparable.
-    GenericVector<FontClassDistance> distance_cache;
   };
 
   PointerVector<TrainingSample> samples_;
@@ -281,6 +342,10 @@ class TrainingSampleSet {
   // A 2-d array of FontClassInfo holding information related to each
   // (font_id, class_id) pair.
   GENERIC_2D_ARRAY<FontClassInfo>* font_class_array_;
+  // Cache of distances computed by ComputeClusterDistance, indexed by the
+  // compact font index from font_id_map_ and class_id. Not serialized, and
+  // cleared whenever font_class_array_ is rebuilt.
+  ClusterDistanceCache distance_cache_;
 
   // Reference to the fontinfo_table_ in MasterTrainer. Provides names
   // for font_ids in the samples. Not serialized!
@@ -0,0 +1,113 @@
+#!/bin/bash
+# File:        runbenchmark.sh
+# Description: Script to time tesseract on a fixed set of images.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# Each image is recognized a number of times, and the median of each
+# measurement over the runs is reported, which is much more stable than any
+# single run. The measurements are the total wall time of the run, and the
+# wall time of each stage of recognition and the counts of work done, as
+# reported by tessedit_dump_page_stats.
+# The report goes to testing/reports/<name>.bench. If an old report is
+# given with -c, the new results are compared against it.
+
+runs=5
+oldreport=""
+while getopts "n:c:" opt
+do
+  case $opt in
+    n) runs=$OPTARG;;
+    c) oldreport=$OPTARG;;
+    *) echo "Usage:$0 [-n runs] [-c oldreport] name [image...]"; exit 1;;
+  esac
+done
+shift $((OPTIND - 1))
+if [ $# -lt 1 ]
+then
+  echo "Usage:$0 [-n runs] [-c oldreport] name [image...]"
+  exit 1
+fi
+if [ ! -d api ]
+then
+  echo "Run $0 from the tesseract-ocr root directory!"
+  exit 1
+fi
+if [ ! -r api/tesseract ]
+then
+  echo "Please build tesseract before running $0"
+  exit 1
+fi
+export TESSDATA_PREFIX=$PWD/
+name=$1
+shift
+images="$@"
+if [ -z "$images" ]
+then
+  images="testing/phototest.tif testing/eurotext.tif"
+fi
+
+mkdir -p testing/reports
+report=testing/reports/$name.bench
+tmpdir=$(mktemp -d)
+trap "rm -rf $tmpdir" EXIT
+
+# Prints the median of the numbers on stdin.
+median() {
+  sort -g | awk '{ v[NR] = $1 } END { if (NR > 0) print v[int((NR + 1) / 2)] }'
+}
+
+rm -f $report
+for image in $images
+do
+  page=${image##*/}
+  page=${page%.*}
+  echo "Timing $page for $runs runs"
+  rm -f $tmpdir/measurements
+  for ((run = 0; run < runs; ++run))
+  do
+    start=$(date +%s.%N)
+    api/tesseract $image $tmpdir/out -c tessedit_dump_page_stats=1 \
+        >/dev/null 2>$tmpdir/stderr
+    end=$(date +%s.%N)
+    awk -v s=$start -v e=$end 'BEGIN { print "total", e - s }' \
+      >>$tmpdir/measurements
+    # Pick the stage wall times and the counters out of the page stats JSON
+    # as name value pairs, summed over the pages of the image.
+    grep "^Page stats" $tmpdir/stderr | \
+      grep -o -e '"[a-z0-9_]*":{"wall":[0-9.]*' -e '"[a-z_]*":[0-9]*[,}]' | \
+      grep -v -e '^"wall"' -e '^"cpu"' | tr -d '"{},' | \
+      sed -e 's/:wall:/ /' -e 's/:/ /' | \
+      awk '{ sum[$1] += $2 } END { for (m in sum) print m, sum[m] }' \
+      >>$tmpdir/measurements
+  done
+  for measure in $(cut -d' ' -f1 $tmpdir/measurements | sort -u)
+  do
+    value=$(awk -v m=$measure '$1 == m { print $2 }' $tmpdir/measurements |
+            median)
+    echo "$page $measure $value" >>$report
+  done
+done
+
+# Sum the medians over all the images.
+awk '{ sum[$2] += $3 } END { for (m in sum) print "all", m, sum[m] }' \
+  $report | sort >>$report
+echo "Results in $report"
+grep "^all " $report
+
+if [ -n "$oldreport" ]
+then
+  echo "Comparison with $oldreport (new/old)"
+  join <(awk '{ print $1 ":" $2, $3 }' $oldreport | sort) \
+       <(awk '{ print $1 ":" $2, $3 }' $report | sort) | \
+    awk '{ printf "%-32s %12g %12g %8.3f\n", $1, $2, $3,
+           ($2 > 0) ? $3 / $2 : 0 }'
+fi
@@ -155,6 +155,13 @@ class IntGrid : public GridBase {
 // thereby making most of the ugly template notation go away.
 // The friend class GridSearch, with the same template arguments, is
 // used to search a grid efficiently in one of several search patterns.
+// A grid that is about to be searched many times without being changed can
+// be frozen, which packs a copy of every cell into one array of (box,
+// pointer) entries, so that searches scan contiguous memory and test the
+// copied boxes instead of following list links and calling bounding_box().
+// Any change to the grid thaws it again, so freezing is only an
+// optimization, but the boxes of the elements must not change while the
+// grid is frozen.
 template<class BBC, class BBC_CLIST, class BBC_C_IT> class BBGrid
   : public GridBase {
   friend class GridSearch<BBC, BBC_CLIST, BBC_C_IT>;
@@ -169,6 +176,16 @@ template<class BBC, class BBC_CLIST, class BBC_C_IT> class BBGrid
 
   // Empty all the lists but leave the grid itself intact.
   void Clear();
+  // Makes the packed copy of the cells used by searches until the next
+  // change to the grid. Call after filling the grid, before a read-only
+  // phase of many searches.
+  void Freeze();
+  // Discards the packed copy of the cells. Called by every function that
+  // changes the grid.
+  void Thaw();
+  bool frozen() const {
+    return !frozen_starts_.empty();
+  }
   // Deallocate the data in the lists but otherwise leave the lists and the grid
   // intact.
   void ClearGridData(void (*free_method)(BBC*));
@@ -221,6 +238,17 @@ template<class BBC, class BBC_CLIST, class BBC_C_IT> class BBGrid
   BBC_CLIST* grid_;  // 2-d array of CLISTS of BBC elements.
 
  private:
+  // An element of a frozen cell, with a copy of its bounding box.
+  struct FrozenEntry {
+    TBOX box;
+    BBC* bbox;
+  };
+
+  // When frozen, the entries of cell i are
+  // frozen_entries_[frozen_starts_[i]..frozen_starts_[i + 1]), in the same
+  // order as in grid_[i]. Both are empty when the grid is not frozen.
+  GenericVector<int> frozen_starts_;
+  GenericVector<FrozenEntry> frozen_entries_;
 };
 
 // Hash functor for generic pointers.
@@ -236,7 +264,8 @@ template<class BBC, class BBC_CLIST, class BBC_C_IT> class GridSearch {
  public:
   GridSearch(BBGrid<BBC, BBC_CLIST, BBC_C_IT>* grid)
       : grid_(grid), unique_mode_(false),
-        previous_return_(NULL), next_return_(NULL) {
+        previous_return_(NULL), next_return_(NULL),
+        frozen_(false), cell_index_(0), entry_index_(0), entry_end_(0) {
   }
 
   // Get the grid x, y coords of the most recently returned BBC.
@@ -343,6 +372,23 @@ template<class BBC, class BBC_CLIST, class BBC_C_IT> class GridSearch {
   // Factored out function to set the iterator to the current x_, y_
   // grid coords and mark the cycle pt.
   void SetIterator();
+  // Returns true if the current cell has no more elements to return.
+  bool CellDone() {
+    return frozen_ ? entry_index_ >= entry_end_ : it_.cycled_list();
+  }
+  // Returns the bounding box of previous_return_, from the frozen copy if
+  // there is one.
+  const TBOX& PreviousBox() const {
+    return frozen_ ? grid_->frozen_entries_[entry_index_ - 1].box
+                   : previous_return_->bounding_box();
+  }
+  // Moves a frozen search on to the first remaining element of the current
+  // cell that overlaps rect_, testing only the packed boxes. Returns false
+  // if there is none.
+  bool SkipToRectOverlap();
+  // Switches a frozen search over to the lists of the grid, at the current
+  // cell, for when the grid has been thawed or is about to be changed.
+  void UseGridLists();
 
  private:
   // The grid we are searching.
@@ -363,6 +409,15 @@ template<class BBC, class BBC_CLIST, class BBC_C_IT> class GridSearch {
   BBC* next_return_;  // Current value of it_.data() used for repositioning.
   // An iterator over the list at (x_, y_) in the grid_.
   BBC_C_IT it_;
+  // True if the current cell is read from the frozen entries of the grid
+  // instead of with it_.
+  bool frozen_;
+  // Index of the current cell in the grid.
+  int cell_index_;
+  // When frozen_, the next and end indices into the frozen entries of the
+  // current cell.
+  int entry_index_;
+  int entry_end_;
   // Set of unique returned elements used when unique_mode_ is true.
   unordered_set<BBC*, PtrHash<BBC> > returns_;
 };
@@ -447,6 +502,7 @@ template<class BBC, class BBC_CLIST, class BBC_C_IT>
 void BBGrid<BBC, BBC_CLIST, BBC_C_IT>::Init(int gridsize,
                                             const ICOORD& bleft,
                                             const ICOORD& tright) {
+  Thaw();
   GridBase::Init(gridsize, bleft, tright);
   if (grid_ != NULL)
     delete [] grid_;
@@ -456,11 +512,43 @@ void BBGrid<BBC, BBC_CLIST, BBC_C_IT>::Init(int gridsize,
 // Clear all lists, but leave the array of lists present.
 template<class BBC, class BBC_CLIST, class BBC_C_IT>
 void BBGrid<BBC, BBC_CLIST, BBC_C_IT>::Clear() {
+  Thaw();
   for (int i = 0; i < gridbuckets_; ++i) {
     grid_[i].shallow_clear();
   }
 }
 
+// Makes the packed copy of the cells used by searches until the next
+// change to the grid.
+template<class BBC, class BBC_CLIST, class BBC_C_IT>
+void BBGrid<BBC, BBC_CLIST, BBC_C_IT>::Freeze() {
+  Thaw();
+  if (grid_ == NULL) return;
+  int num_entries = 0;
+  for (int i = 0; i < gridbuckets_; ++i)
+    num_entries += grid_[i].length();
+  frozen_starts_.reserve(gridbuckets_ + 1);
+  frozen_entries_.reserve(num_entries);
+  FrozenEntry entry;
+  for (int i = 0; i < gridbuckets_; ++i) {
+    frozen_starts_.push_back(frozen_entries_.size());
+    BBC_C_IT it(&grid_[i]);
+    for (it.mark_cycle_pt(); !it.cycled_list(); it.forward()) {
+      entry.bbox = it.data();
+      entry.box = entry.bbox->bounding_box();
+      frozen_entries_.push_back(entry);
+    }
+  }
+  frozen_starts_.push_back(frozen_entries_.size());
+}
+
+// Discards the packed copy of the cells.
+template<class BBC, class BBC_CLIST, class BBC_C_IT>
+void BBGrid<BBC, BBC_CLIST, BBC_C_IT>::Thaw() {
+  frozen_starts_.clear();
+  frozen_entries_.clear();
+}
+
 // Deallocate the data in the lists but otherwise leave the lists and the grid
 // intact.
 template<class BBC, class BBC_CLIST, class BBC_C_IT>
@@ -488,6 +576,7 @@ void BBGrid<BBC, BBC_CLIST, BBC_C_IT>::ClearGridData(
 template<class BBC, class BBC_CLIST, class BBC_C_IT>
 void BBGrid<BBC, BBC_CLIST, BBC_C_IT>::InsertBBox(bool h_spread, bool v_spread,
                                                   BBC* bbox) {
+  Thaw();
   TBOX box = bbox->bounding_box();
   int start_x, start_y, end_x, end_y;
   GridCoords(box.left(), box.bottom(), &start_x, &start_y);
@@ -516,6 +605,7 @@ void BBGrid<BBC, BBC_CLIST, BBC_C_IT>::InsertBBox(bool h_spread, bool v_spread,
 template<class BBC, class BBC_CLIST, class BBC_C_IT>
 void BBGrid<BBC, BBC_CLIST, BBC_C_IT>::InsertPixPtBBox(int left, int bottom,
                                                        Pix* pix, BBC* bbox) {
+  Thaw();
   int width = pixGetWidth(pix);
   int height = pixGetHeight(pix);
   for (int y = 0; y < height; ++y) {
@@ -534,6 +624,7 @@ void BBGrid<BBC, BBC_CLIST, BBC_C_IT>::InsertPixPtBBox(int left, int bottom,
 // If a GridSearch is operating, call GridSearch::RemoveBBox() instead.
 template<class BBC, class BBC_CLIST, class BBC_C_IT>
 void BBGrid<BBC, BBC_CLIST, BBC_C_IT>::RemoveBBox(BBC* bbox) {
+  Thaw();
   TBOX box = bbox->bounding_box();
   int start_x, start_y, end_x, end_y;
   GridCoords(box.left(), box.bottom(), &start_x, &start_y);
@@ -679,7 +770,7 @@ BBC* GridSearch<BBC, BBC_CLIST, BBC_C_IT>::NextFullSearch() {
   int x;
   int y;
   do {
-    while (it_.cycled_list()) {
+    while (CellDone()) {
       ++x_;
       if (x_ >= grid_->gridwidth_) {
         --y_;
@@ -690,7 +781,7 @@ BBC* GridSearch<BBC, BBC_CLIST, BBC_C_IT>::NextFullSearch() {
       SetIterator();
     }
     CommonNext();
-    TBOX box = previous_return_->bounding_box();
+    const TBOX& box = PreviousBox();
     grid_->GridCoords(box.left(), box.bottom(), &x, &y);
   } while (x != x_ || y != y_);
   return previous_return_;
@@ -715,7 +806,7 @@ void GridSearch<BBC, BBC_CLIST, BBC_C_IT>::StartRadSearch(int x, int y,
 template<class BBC, class BBC_CLIST, class BBC_C_IT>
 BBC* GridSearch<BBC, BBC_CLIST, BBC_C_IT>::NextRadSearch() {
   do {
-    while (it_.cycled_list()) {
+    while (CellDone()) {
       ++rad_index_;
       if (rad_index_ >= radius_) {
         ++rad_dir_;
@@ -763,7 +854,7 @@ void GridSearch<BBC, BBC_CLIST, BBC_C_IT>::StartSideSearch(int x,
 template<class BBC, class BBC_CLIST, class BBC_C_IT>
 BBC* GridSearch<BBC, BBC_CLIST, BBC_C_IT>::NextSideSearch(bool right_to_left) {
   do {
-    while (it_.cycled_list()) {
+    while (CellDone()) {
       ++rad_index_;
       if (rad_index_ > radius_) {
         if (right_to_left)
@@ -805,7 +896,7 @@ template<class BBC, class BBC_CLIST, class BBC_C_IT>
 BBC* GridSearch<BBC, BBC_CLIST, BBC_C_IT>::NextVerticalSearch(
     bool top_to_bottom) {
   do {
-    while (it_.cycled_list()) {
+    while (CellDone()) {
       ++rad_index_;
       if (rad_index_ > radius_) {
         if (top_to_bottom)
@@ -844,7 +935,7 @@ void GridSearch<BBC, BBC_CLIST, BBC_C_IT>::StartRectSearch(const TBOX& rect) {
 template<class BBC, class BBC_CLIST, class BBC_C_IT>
 BBC* GridSearch<BBC, BBC_CLIST, BBC_C_IT>::NextRectSearch() {
   do {
-    while (it_.cycled_list()) {
+    while (CellDone() || (frozen_ && !SkipToRectOverlap())) {
       ++x_;
       if (x_ > max_radius_) {
         --y_;
@@ -855,7 +946,7 @@ BBC* GridSearch<BBC, BBC_CLIST, BBC_C_IT>::NextRectSearch() {
       SetIterator();
     }
     CommonNext();
-  } while (!rect_.overlap(previous_return_->bounding_box()) ||
+  } while (!rect_.overlap(PreviousBox()) ||
            (unique_mode_ && returns_.find(previous_return_) != returns_.end()));
   if (unique_mode_)
     returns_.insert(previous_return_);
@@ -868,6 +959,9 @@ BBC* GridSearch<BBC, BBC_CLIST, BBC_C_IT>::NextRectSearch() {
 template<class BBC, class BBC_CLIST, class BBC_C_IT>
 void GridSearch<BBC, BBC_CLIST, BBC_C_IT>::RemoveBBox() {
   if (previous_return_ != NULL) {
+    // The removal thaws the grid, so carry on with its lists.
+    if (frozen_)
+      UseGridLists();
     // Remove all instances of previous_return_ from the list, so the iterator
     // remains valid after removal from the rest of the grid cells.
     // if previous_return_ is not on the list, then it has been removed already.
@@ -896,6 +990,28 @@ void GridSearch<BBC, BBC_CLIST, BBC_C_IT>::RepositionIterator() {
   // Something was deleted, so we have little choice but to clear the
   // returns list.
   returns_.clear();
+  if (frozen_) {
+    if (grid_->frozen()) {
+      // The grid may have been changed and frozen again, so find the
+      // position in the current cell afresh.
+      entry_end_ = grid_->frozen_starts_[cell_index_ + 1];
+      for (int i = grid_->frozen_starts_[cell_index_]; i < entry_end_; ++i) {
+        BBC* bbox = grid_->frozen_entries_[i].bbox;
+        if (bbox == previous_return_ || bbox == next_return_) {
+          entry_index_ = bbox == previous_return_ ? i + 1 : i;
+          next_return_ = CellDone() ? NULL
+                                    : grid_->frozen_entries_[entry_index_].bbox;
+          return;
+        }
+      }
+      // We ran off the end of the cell. Move to a new cell next time.
+      entry_index_ = entry_end_;
+      previous_return_ = NULL;
+      next_return_ = NULL;
+      return;
+    }
+    UseGridLists();
+  }
   // Reset the iterator back to one past the previous return.
   // If the previous_return_ is no longer in the list, then
   // next_return_ serves as a backup.
@@ -927,13 +1043,24 @@ void GridSearch<BBC, BBC_CLIST, BBC_C_IT>::CommonStart(int x, int y) {
   y_ = y_origin_;
   SetIterator();
   previous_return_ = NULL;
-  next_return_ = it_.empty() ? NULL : it_.data();
+  if (frozen_) {
+    next_return_ = CellDone() ? NULL
+                              : grid_->frozen_entries_[entry_index_].bbox;
+  } else {
+    next_return_ = it_.empty() ? NULL : it_.data();
+  }
   returns_.clear();
 }
 
 // Factored out helper to complete a next search.
 template<class BBC, class BBC_CLIST, class BBC_C_IT>
 BBC* GridSearch<BBC, BBC_CLIST, BBC_C_IT>::CommonNext() {
+  if (frozen_) {
+    previous_return_ = grid_->frozen_entries_[entry_index_++].bbox;
+    next_return_ = CellDone() ? NULL
+                              : grid_->frozen_entries_[entry_index_].bbox;
+    return previous_return_;
+  }
   previous_return_ = it_.data();
   it_.forward();
   next_return_ = it_.cycled_list() ? NULL : it_.data();
@@ -952,7 +1079,41 @@ BBC* GridSearch<BBC, BBC_CLIST, BBC_C_IT>::CommonEnd() {
 // grid coords and mark the cycle pt.
 template<class BBC, class BBC_CLIST, class BBC_C_IT>
 void GridSearch<BBC, BBC_CLIST, BBC_C_IT>::SetIterator() {
-  it_= &(grid_->grid_[y_ * grid_->gridwidth_ + x_]);
+  cell_index_ = y_ * grid_->gridwidth_ + x_;
+  frozen_ = grid_->frozen();
+  if (frozen_) {
+    entry_index_ = grid_->frozen_starts_[cell_index_];
+    entry_end_ = grid_->frozen_starts_[cell_index_ + 1];
+  } else {
+    it_= &(grid_->grid_[cell_index_]);
+    it_.mark_cycle_pt();
+  }
+}
+
+// Moves a frozen search on to the first remaining element of the current
+// cell that overlaps rect_, testing only the packed boxes. Returns false
+// if there is none.
+template<class BBC, class BBC_CLIST, class BBC_C_IT>
+bool GridSearch<BBC, BBC_CLIST, BBC_C_IT>::SkipToRectOverlap() {
+  // Only called with entries remaining, so the vector is not empty.
+  const typename BBGrid<BBC, BBC_CLIST, BBC_C_IT>::FrozenEntry* entries =
+      &grid_->frozen_entries_[0];
+  while (entry_index_ < entry_end_ && !rect_.overlap(entries[entry_index_].box))
+    ++entry_index_;
+  if (entry_index_ >= entry_end_)
+    return false;
+  next_return_ = entries[entry_index_].bbox;
+  return true;
+}
+
+// Switches a frozen search over to the lists of the grid, at the current
+// cell, for when the grid has been thawed or is about to be changed.
+// The lists are in the same order as the frozen cells, so next_return_ and
+// previous_return_ still locate the position in the list.
+template<class BBC, class BBC_CLIST, class BBC_C_IT>
+void GridSearch<BBC, BBC_CLIST, BBC_C_IT>::UseGridLists() {
+  frozen_ = false;
+  it_ = &(grid_->grid_[cell_index_]);
   it_.mark_cycle_pt();
 }
 
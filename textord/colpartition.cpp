@@ -733,15 +733,15 @@ bool ColPartition::OKMergeOverlap(const ColPartition& merge1,
   // Vertical partitions are not allowed to be involved.
   if (IsVerticalType() || merge1.IsVerticalType() || merge2.IsVerticalType()) {
     if (debug)
-      tprintf("Vertical partition\n");
+      tprintf_level(1, "Vertical partition\n");
     return false;
   }
   // The merging partitions must strongly overlap each other.
   if (!merge1.VSignificantCoreOverlap(merge2)) {
     if (debug)
-      tprintf("Voverlap %d (%d)\n",
-              merge1.VCoreOverlap(merge2),
-              merge1.VSignificantCoreOverlap(merge2));
+      tprintf_level(1, "Voverlap %d (%d)\n",
+                    merge1.VCoreOverlap(merge2),
+                    merge1.VSignificantCoreOverlap(merge2));
     return false;
   }
   // The merged box must not overlap the median bounds of this.
@@ -751,7 +751,7 @@ bool ColPartition::OKMergeOverlap(const ColPartition& merge1,
       merged_box.bottom() < bounding_box_.top() - ok_box_overlap &&
       merged_box.top() > bounding_box_.bottom() + ok_box_overlap) {
     if (debug)
-      tprintf("Excessive box overlap\n");
+      tprintf_level(1, "Excessive box overlap\n");
     return false;
   }
   // Looks OK!
@@ -1097,9 +1097,9 @@ bool ColPartition::MarkAsLeaderIfMonospaced() {
   double min_width = MIN(median_gap, median_width);
   double gap_iqr = gap_stats.ile(0.75f) - gap_stats.ile(0.25f);
   if (textord_debug_tabfind >= 4) {
-    tprintf("gap iqr = %g, blob_count=%d, limits=%g,%g\n",
-            gap_iqr, blob_count, max_width * kMaxLeaderGapFractionOfMax,
-            min_width * kMaxLeaderGapFractionOfMin);
+    tprintf_level(4, "gap iqr = %g, blob_count=%d, limits=%g,%g\n",
+                  gap_iqr, blob_count, max_width * kMaxLeaderGapFractionOfMax,
+                  min_width * kMaxLeaderGapFractionOfMin);
   }
   if (gap_iqr < max_width * kMaxLeaderGapFractionOfMax &&
       gap_iqr < min_width * kMaxLeaderGapFractionOfMin &&
@@ -1464,12 +1464,12 @@ void ColPartition::LineSpacingBlocks(const ICOORD& bleft, const ICOORD& tright,
         // its matched size, otherwise it goes with the smallest spacing.
         ColPartition* third_part = it.at_last() ? NULL : it.data_relative(1);
         if (textord_debug_tabfind) {
-          tprintf("Spacings unequal: upper:%d/%d, lower:%d/%d,"
-                  " sizes %d %d %d\n",
-                  part->top_spacing(), part->bottom_spacing(),
-                  next_part->top_spacing(), next_part->bottom_spacing(),
-                  part->median_size(), next_part->median_size(),
-                  third_part != NULL ? third_part->median_size() : 0);
+          tprintf_level(1, "Spacings unequal: upper:%d/%d, lower:%d/%d,"
+                        " sizes %d %d %d\n",
+                        part->top_spacing(), part->bottom_spacing(),
+                        next_part->top_spacing(), next_part->bottom_spacing(),
+                        part->median_size(), next_part->median_size(),
+                        third_part != NULL ? third_part->median_size() : 0);
         }
         // We can only consider adding the next line to the block if the sizes
         // match and the lines are close enough for their size.
@@ -1491,7 +1491,7 @@ void ColPartition::LineSpacingBlocks(const ICOORD& bleft, const ICOORD& tright,
             sp_block_it.add_to_end(it.extract());
             it.forward();
             if (textord_debug_tabfind) {
-              tprintf("Added line to current block.\n");
+              tprintf_level(1, "Added line to current block.\n");
             }
           }
         }
@@ -1649,8 +1649,8 @@ TO_BLOCK* ColPartition::MakeBlock(const ICOORD& bleft, const ICOORD& tright,
     }
   } while (iteration < 2);
   if (textord_debug_tabfind)
-    tprintf("Making block at (%d,%d)->(%d,%d)\n",
-            min_x, min_y, max_x, max_y);
+    tprintf_level(1, "Making block at (%d,%d)->(%d,%d)\n",
+                  min_x, min_y, max_x, max_y);
   BLOCK* block = new BLOCK("", true, 0, 0, min_x, min_y, max_x, max_y);
   block->set_poly_block(new POLY_BLOCK(&vertices, type));
   return MoveBlobsToBlock(false, line_spacing, block, block_parts, used_parts);
@@ -2040,9 +2040,9 @@ void ColPartition::RefineTextPartnersByMerge(bool upper, bool desperate,
                                                        NULL, &overlap_increase);
     if (candidate != NULL && (overlap_increase <= 0 || desperate)) {
       if (debug) {
-        tprintf("Merging:hoverlap=%d, voverlap=%d, OLI=%d\n",
-                part->HCoreOverlap(*candidate), part->VCoreOverlap(*candidate),
-                overlap_increase);
+        tprintf_level(1, "Merging:hoverlap=%d, voverlap=%d, OLI=%d\n",
+                      part->HCoreOverlap(*candidate),
+                      part->VCoreOverlap(*candidate), overlap_increase);
       }
       // Remove before merge and re-insert to keep the integrity of the grid.
       grid->RemoveBBox(candidate);
@@ -974,20 +974,33 @@ void ColPartitionGrid::RecomputeBounds(int gridsize,
 // column set at each y-coordinate in the grid.
 // best_columns is usually the best_columns_ member of ColumnFinder.
 void ColPartitionGrid::GridFindMargins(ColPartitionSet** best_columns) {
-  // Iterate the ColPartitions in the grid.
+  // The margin searches only read the grid, so pack it for them.
+  Freeze();
+  // Collect the ColPartitions in the grid with their columns.
+  GenericVector<ColPartition*> parts;
+  GenericVector<ColPartitionSet*> part_columns;
   ColPartitionGridSearch gsearch(this);
   gsearch.StartFullSearch();
   ColPartition* part;
   while ((part = gsearch.NextFullSearch()) != NULL) {
     // Set up a rectangle search x-bounded by the column and y by the part.
-    ColPartitionSet* columns = best_columns != NULL
-                             ? best_columns[gsearch.GridY()]
-                             : NULL;
-    FindPartitionMargins(columns, part);
-    const TBOX& box = part->bounding_box();
+    parts.push_back(part);
+    part_columns.push_back(best_columns != NULL
+                           ? best_columns[gsearch.GridY()]
+                           : NULL);
+  }
+  // Each part only writes its own margins and only reads the boxes of the
+  // others, so they can be done in parallel with the same result.
+  int num_parts = parts.size();
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (int p = 0; p < num_parts; ++p) {
+    FindPartitionMargins(part_columns[p], parts[p]);
+  }
+  for (int p = 0; p < num_parts; ++p) {
+    const TBOX& box = parts[p]->bounding_box();
     if (AlignedBlob::WithinTestRegion(2, box.left(), box.bottom())) {
       tprintf("Computed margins for part:");
-      part->Print();
+      parts[p]->Print();
     }
   }
 }
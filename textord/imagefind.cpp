@@ -30,6 +30,7 @@
 #include "colpartitiongrid.h"
 #include "linlsq.h"
 #include "ndminx.h"
+#include "pixcount.h"
 #include "statistc.h"
 #include "params.h"
 
@@ -579,14 +580,12 @@ int ImageFind::CountPixelsInRotatedBox(TBOX box, const TBOX& im_box,
   box.rotate(rotation);
   TBOX rotated_im_box(im_box);
   rotated_im_box.rotate(rotation);
-  Pix* rect_pix = pixCreate(box.width(), box.height(), 1);
-  pixRasterop(rect_pix, 0, 0, box.width(), box.height(),
-              PIX_SRC, pix, box.left() - rotated_im_box.left(),
-              rotated_im_box.top() - box.top());
-  l_int32 result;
-  pixCountPixels(rect_pix, &result, NULL);
-  pixDestroy(&rect_pix);
-  return result;
+  // Count straight from the pix, instead of copying the box out first.
+  int left = box.left() - rotated_im_box.left();
+  int top = rotated_im_box.top() - box.top();
+  return PixelCountTable::CountPixelsInRect(pix, left, top,
+                                            left + box.width(),
+                                            top + box.height());
 }
 
 // The box given by slice contains some black pixels, but not necessarily
@@ -1370,8 +1370,9 @@ void Textord::compute_block_xheight(TO_BLOCK *block, float gradient) {
   block->xheight = xheight;
 
   if (textord_debug_xheights) {
-    tprintf("Block average xheight=%.4f, ascrise=%.4f, descdrop=%.4f\n",
-            xheight, ascrise, descdrop);
+    tprintf_level(1,
+                  "Block average xheight=%.4f, ascrise=%.4f, descdrop=%.4f\n",
+                  xheight, ascrise, descdrop);
   }
   // Correct xheight, ascrise, descdrop of rows based on block averages.
   for (row_it.mark_cycle_pt(); !row_it.cycled_list(); row_it.forward()) {
@@ -1464,7 +1465,7 @@ void fill_heights(TO_ROW *row, float gradient, int min_height,
              blob_it.data()->repeated_set() == repeated_set) {
         blob_it.forward();
         if (textord_debug_xheights)
-          tprintf("Skipping repeated char when computing xheight\n");
+          tprintf_level(1, "Skipping repeated char when computing xheight\n");
       }
     } else {
       blob_it.forward();
@@ -1535,8 +1536,8 @@ int compute_xheight_from_modes(
             best_count = modes_x_count;
           }
           if (textord_debug_xheights) {
-            tprintf("X=%d, asc=%d, count=%d, ratio=%g\n",
-                    modes[x], modes[asc]-modes[x], modes_x_count, ratio);
+            tprintf_level(1, "X=%d, asc=%d, count=%d, ratio=%g\n",
+                          modes[x], modes[asc]-modes[x], modes_x_count, ratio);
           }
           prev_size = modes[x];
           *xheight = static_cast<float>(modes[x]);
@@ -1565,9 +1566,10 @@ int compute_xheight_from_modes(
     *ascrise = 0.0f;
     best_count = heights->pile_count(blob_index);
     if (textord_debug_xheights)
-      tprintf("Single mode xheight set to %g\n", *xheight);
+      tprintf_level(1, "Single mode xheight set to %g\n", *xheight);
   } else if (textord_debug_xheights) {
-    tprintf("Multi-mode xheight set to %g, asc=%g\n", *xheight, *ascrise);
+    tprintf_level(1,
+                  "Multi-mode xheight set to %g, asc=%g\n", *xheight, *ascrise);
   }
   return best_count;
 }
@@ -1710,9 +1712,9 @@ void correct_row_xheight(TO_ROW *row, float xheight,
                          float ascrise, float descdrop) {
   ROW_CATEGORY row_category = get_row_category(row);
   if (textord_debug_xheights) {
-    tprintf("correcting row xheight: row->xheight %.4f"
-            ", row->acrise %.4f row->descdrop %.4f\n",
-            row->xheight, row->ascrise, row->descdrop);
+    tprintf_level(1, "correcting row xheight: row->xheight %.4f"
+                  ", row->acrise %.4f row->descdrop %.4f\n",
+                  row->xheight, row->ascrise, row->descdrop);
   }
   bool normal_xheight =
     within_error_margin(row->xheight, xheight, textord_xheight_error_margin);
@@ -1733,7 +1735,7 @@ void correct_row_xheight(TO_ROW *row, float xheight,
              (row_category == ROW_DESCENDERS_FOUND &&
               (normal_xheight || cap_xheight)) ||
               (row_category == ROW_UNKNOWN && normal_xheight)) {
-    if (textord_debug_xheights) tprintf("using average xheight\n");
+    if (textord_debug_xheights) tprintf_level(1, "using average xheight\n");
     row->xheight = xheight;
     row->ascrise = ascrise;
     row->descdrop = descdrop;
@@ -1742,7 +1744,8 @@ void correct_row_xheight(TO_ROW *row, float xheight,
     // is computed correctly (unfortunately there is no way to distinguish
     // this from the case when descenders are found, but the most common
     // height is capheight).
-    if (textord_debug_xheights) tprintf("lowercase, corrected ascrise\n");
+    if (textord_debug_xheights)
+      tprintf_level(1, "lowercase, corrected ascrise\n");
     row->ascrise = row->xheight * (ascrise / xheight);
   } else if (row_category == ROW_UNKNOWN) {
   // Otherwise assume this row is an all-caps or small-caps row
@@ -1750,7 +1753,7 @@ void correct_row_xheight(TO_ROW *row, float xheight,
 
     row->all_caps = true;
     if (cap_xheight) { // regular all caps
-      if (textord_debug_xheights) tprintf("all caps\n");
+      if (textord_debug_xheights) tprintf_level(1, "all caps\n");
       row->xheight = xheight;
       row->ascrise = ascrise;
       row->descdrop = descdrop;
@@ -1768,8 +1771,9 @@ void correct_row_xheight(TO_ROW *row, float xheight,
     }
   }
   if (textord_debug_xheights) {
-    tprintf("corrected row->xheight = %.4f, row->acrise = %.4f, row->descdrop"
-            " = %.4f\n", row->xheight, row->ascrise, row->descdrop);
+    tprintf_level(1, "corrected row->xheight = %.4f, row->acrise = %.4f,"
+                  " row->descdrop = %.4f\n",
+                  row->xheight, row->ascrise, row->descdrop);
   }
 }
 
@@ -153,10 +153,13 @@ StrokeWidth::~StrokeWidth() {
 void StrokeWidth::SetNeighboursOnMediumBlobs(TO_BLOCK* block) {
   // Run a preliminary strokewidth neighbour detection on the medium blobs.
   InsertBlobList(&block->blobs);
+  Freeze();
+  GenericVector<BLOBNBOX*> blobs;
   BLOBNBOX_IT blob_it(&block->blobs);
   for (blob_it.mark_cycle_pt(); !blob_it.cycled_list(); blob_it.forward()) {
-    SetNeighbours(false, false, blob_it.data());
+    blobs.push_back(blob_it.data());
   }
+  SetNeighboursInParallel(false, false, blobs);
   Clear();
 }
 
@@ -799,13 +802,18 @@ void StrokeWidth::AccumulateOverlaps(const BLOBNBOX* not_this, bool debug,
 // This function is called more than once if page orientation is uncertain,
 // so display_if_debugging is true on the final call to display the results.
 void StrokeWidth::FindTextlineFlowDirection(bool display_if_debugging) {
+  // Only the neighbours and flows of the blobs change from here on, so the
+  // grid can be packed for the many neighbour searches.
+  Freeze();
   BlobGridSearch gsearch(this);
   BLOBNBOX* bbox;
   // For every bbox in the grid, set its neighbours.
+  GenericVector<BLOBNBOX*> blobs;
   gsearch.StartFullSearch();
   while ((bbox = gsearch.NextFullSearch()) != NULL) {
-    SetNeighbours(false, display_if_debugging, bbox);
+    blobs.push_back(bbox);
   }
+  SetNeighboursInParallel(false, display_if_debugging, blobs);
   // Where vertical or horizontal wins by a big margin, clarify it.
   gsearch.StartFullSearch();
   while ((bbox = gsearch.NextFullSearch()) != NULL) {
@@ -860,6 +868,19 @@ void StrokeWidth::SetNeighbours(bool leaders, bool activate_line_trap,
   }
 }
 
+// Calls SetNeighbours on each of the given blobs, in parallel. The result
+// does not depend on the order, as each blob only writes its own
+// neighbours and region type, and only reads the boxes, rules and stroke
+// widths of the others.
+void StrokeWidth::SetNeighboursInParallel(
+    bool leaders, bool activate_line_trap,
+    const GenericVector<BLOBNBOX*>& blobs) {
+  int num_blobs = blobs.size();
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (int b = 0; b < num_blobs; ++b) {
+    SetNeighbours(leaders, activate_line_trap, blobs[b]);
+  }
+}
 
 // Sets the good_stroke_neighbours member of the blob if it has a
 // GoodNeighbour on the given side.
@@ -171,6 +171,12 @@ class StrokeWidth : public BlobGrid {
   // what makes a good neighbour.
   // If activate_line_trap, then line-like objects are found and isolated.
   void SetNeighbours(bool leaders, bool activate_line_trap, BLOBNBOX* blob);
+  // Calls SetNeighbours on each of the given blobs, in parallel. The result
+  // does not depend on the order, as each blob only writes its own
+  // neighbours and region type, and only reads the boxes, rules and stroke
+  // widths of the others.
+  void SetNeighboursInParallel(bool leaders, bool activate_line_trap,
+                               const GenericVector<BLOBNBOX*>& blobs);
 
   // Sets the good_stroke_neighbours member of the blob if it has a
   // GoodNeighbour on the given side.
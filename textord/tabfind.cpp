@@ -129,8 +129,8 @@ void TabFind::InsertBlobsToGrid(bool h_spread, bool v_spread,
     }
   }
   if (textord_debug_tabfind) {
-    tprintf("Inserted %d blobs into grid, %d rejected.\n",
-            b_count, reject_count);
+    tprintf_level(1, "Inserted %d blobs into grid, %d rejected.\n",
+                  b_count, reject_count);
   }
 }
 
@@ -246,7 +246,7 @@ void TabFind::GutterWidthAndNeighbourGap(int tab_x, int mean_height,
     *gutter_width += tab_gap;
   bool debug = WithinTestRegion(2, box.left(), box.bottom());
   if (debug)
-    tprintf("Looking in gutter\n");
+    tprintf_level(1, "Looking in gutter\n");
   // Find the nearest blob on the outside of the column.
   BLOBNBOX* gutter_bbox = AdjacentBlob(bbox, left,
                                        bbox->flow() == BTFT_TEXT_ON_IMAGE, 0.0,
@@ -277,7 +277,7 @@ void TabFind::GutterWidthAndNeighbourGap(int tab_x, int mean_height,
     *gutter_width = max_gutter;
   // Now look for a neighbour on the inside.
   if (debug)
-    tprintf("Looking for neighbour\n");
+    tprintf_level(1, "Looking for neighbour\n");
   BLOBNBOX* neighbour = AdjacentBlob(bbox, !left,
                                      bbox->flow() == BTFT_TEXT_ON_IMAGE, 0.0,
                                      *gutter_width, box.top(), box.bottom());
@@ -549,6 +549,8 @@ ScrollView* TabFind::FindInitialTabVectors(BLOBNBOX_LIST* image_blobs,
   if (image_blobs != NULL)
     InsertBlobsToGrid(true, false, image_blobs, this);
   InsertBlobsToGrid(true, false, &block->blobs, this);
+  // Finding the tabs searches the grid heavily without changing it.
+  Freeze();
   ScrollView* initial_win = FindTabBoxes(min_gutter_width);
   FindAllTabVectors(min_gutter_width);
 
@@ -630,9 +632,9 @@ bool TabFind::TestBoxForTabs(BLOBNBOX* bbox, int min_gutter_width) {
   int height = box.height();
   bool debug = WithinTestRegion(3, left_x, top_y);
   if (debug) {
-    tprintf("Column edges for blob at (%d,%d)->(%d,%d) are [%d, %d]\n",
-            left_x, top_y, right_x, bottom_y,
-            left_column_edge, right_column_edge);
+    tprintf_level(1, "Column edges for blob at (%d,%d)->(%d,%d) are [%d, %d]\n",
+                  left_x, top_y, right_x, bottom_y,
+                  left_column_edge, right_column_edge);
   }
   // Compute a search radius based on a multiple of the height.
   int radius = (height * kTabRadiusFactor + gridsize_ - 1) / gridsize_;
@@ -694,8 +696,8 @@ bool TabFind::TestBoxForTabs(BLOBNBOX* bbox, int min_gutter_width) {
     int n_left = nbox.left();
     int n_right = nbox.right();
     if (debug)
-      tprintf("Neighbour at (%d,%d)->(%d,%d)\n",
-              n_left, nbox.bottom(), n_right, nbox.top());
+      tprintf_level(1, "Neighbour at (%d,%d)->(%d,%d)\n",
+                    n_left, nbox.bottom(), n_right, nbox.top());
     // If the neighbouring blob is the wrong side of a separator line, then it
     // "doesn't exist" as far as we are concerned.
     if (n_right > right_column_edge || n_left < left_column_edge ||
@@ -705,7 +707,7 @@ bool TabFind::TestBoxForTabs(BLOBNBOX* bbox, int min_gutter_width) {
     int n_mid_y = (nbox.top() + nbox.bottom()) / 2;
     if (n_mid_x <= left_x && n_right >= target_right) {
       if (debug)
-        tprintf("Not a left tab\n");
+        tprintf_level(1, "Not a left tab\n");
       is_left_tab = false;
       if (n_mid_y < top_y)
         maybe_left_tab_down = -MAX_INT32;
@@ -713,7 +715,7 @@ bool TabFind::TestBoxForTabs(BLOBNBOX* bbox, int min_gutter_width) {
         maybe_left_tab_up = -MAX_INT32;
     } else if (NearlyEqual(left_x, n_left, alignment_tolerance)) {
       if (debug)
-        tprintf("Maybe a left tab\n");
+        tprintf_level(1, "Maybe a left tab\n");
       if (n_mid_y > top_y && maybe_left_tab_up > -MAX_INT32)
         ++maybe_left_tab_up;
       if (n_mid_y < bottom_y && maybe_left_tab_down > -MAX_INT32)
@@ -721,7 +723,7 @@ bool TabFind::TestBoxForTabs(BLOBNBOX* bbox, int min_gutter_width) {
     } else if (n_left < left_x && n_right >= left_x) {
       // Overlaps but not aligned so negative points on a maybe.
       if (debug)
-        tprintf("Maybe Not a left tab\n");
+        tprintf_level(1, "Maybe Not a left tab\n");
       if (n_mid_y > top_y && maybe_left_tab_up > -MAX_INT32)
         --maybe_left_tab_up;
       if (n_mid_y < bottom_y && maybe_left_tab_down > -MAX_INT32)
@@ -730,11 +732,11 @@ bool TabFind::TestBoxForTabs(BLOBNBOX* bbox, int min_gutter_width) {
     if (n_left < left_x && nbox.y_overlap(box) && n_right >= target_right) {
       maybe_ragged_left = false;
       if (debug)
-        tprintf("Not a ragged left\n");
+        tprintf_level(1, "Not a ragged left\n");
     }
     if (n_mid_x >= right_x && n_left <= target_left) {
       if (debug)
-        tprintf("Not a right tab\n");
+        tprintf_level(1, "Not a right tab\n");
       is_right_tab = false;
       if (n_mid_y < top_y)
         maybe_right_tab_down = -MAX_INT32;
@@ -742,7 +744,7 @@ bool TabFind::TestBoxForTabs(BLOBNBOX* bbox, int min_gutter_width) {
         maybe_right_tab_up = -MAX_INT32;
     } else if (NearlyEqual(right_x, n_right, alignment_tolerance)) {
       if (debug)
-        tprintf("Maybe a right tab\n");
+        tprintf_level(1, "Maybe a right tab\n");
       if (n_mid_y > top_y && maybe_right_tab_up > -MAX_INT32)
         ++maybe_right_tab_up;
       if (n_mid_y < bottom_y && maybe_right_tab_down > -MAX_INT32)
@@ -750,7 +752,7 @@ bool TabFind::TestBoxForTabs(BLOBNBOX* bbox, int min_gutter_width) {
     } else if (n_right > right_x && n_left <= right_x) {
       // Overlaps but not aligned so negative points on a maybe.
       if (debug)
-        tprintf("Maybe Not a right tab\n");
+        tprintf_level(1, "Maybe Not a right tab\n");
       if (n_mid_y > top_y && maybe_right_tab_up > -MAX_INT32)
         --maybe_right_tab_up;
       if (n_mid_y < bottom_y && maybe_right_tab_down > -MAX_INT32)
@@ -759,7 +761,7 @@ bool TabFind::TestBoxForTabs(BLOBNBOX* bbox, int min_gutter_width) {
     if (n_right > right_x && nbox.y_overlap(box) && n_left <= target_left) {
       maybe_ragged_right = false;
       if (debug)
-        tprintf("Not a ragged right\n");
+        tprintf_level(1, "Not a ragged right\n");
     }
     if (maybe_left_tab_down == -MAX_INT32 && maybe_left_tab_up == -MAX_INT32 &&
         maybe_right_tab_down == -MAX_INT32 && maybe_right_tab_up == -MAX_INT32)
@@ -781,11 +783,11 @@ bool TabFind::TestBoxForTabs(BLOBNBOX* bbox, int min_gutter_width) {
     bbox->set_right_tab_type(TT_NONE);
   }
   if (debug) {
-    tprintf("Left result = %s, Right result=%s\n",
-            bbox->left_tab_type() == TT_MAYBE_ALIGNED ? "Aligned" :
-            (bbox->left_tab_type() == TT_MAYBE_RAGGED ? "Ragged" : "None"),
-            bbox->right_tab_type() == TT_MAYBE_ALIGNED ? "Aligned" :
-            (bbox->right_tab_type() == TT_MAYBE_RAGGED ? "Ragged" : "None"));
+    tprintf_level(1, "Left result = %s, Right result=%s\n",
+        bbox->left_tab_type() == TT_MAYBE_ALIGNED ? "Aligned" :
+        (bbox->left_tab_type() == TT_MAYBE_RAGGED ? "Ragged" : "None"),
+        bbox->right_tab_type() == TT_MAYBE_ALIGNED ? "Aligned" :
+        (bbox->right_tab_type() == TT_MAYBE_RAGGED ? "Ragged" : "None"));
   }
   return bbox->left_tab_type() != TT_NONE || bbox->right_tab_type() != TT_NONE;
 }
@@ -857,8 +859,8 @@ void TabFind::FindAllTabVectors(int min_gutter_width) {
       bbox->set_right_tab_type(TT_MAYBE_ALIGNED);
   }
   if (textord_debug_tabfind) {
-    tprintf("Beginning real tab search with vertical = %d,%d...\n",
-            vertical_x, vertical_y);
+    tprintf_level(1, "Beginning real tab search with vertical = %d,%d...\n",
+                  vertical_x, vertical_y);
   }
   // Now do the real thing ,but keep the vectors in the dummy_vectors list
   // until they are all done, so we don't get the tab vectors confused with
@@ -931,8 +933,8 @@ void TabFind::SetVerticalSkewAndParellelize(int vertical_x, int vertical_y) {
   // Fit the vertical vector into an ICOORD, which is 16 bit.
   vertical_skew_.set_with_shrink(vertical_x, vertical_y);
   if (textord_debug_tabfind)
-    tprintf("Vertical skew vector=(%d,%d)\n",
-            vertical_skew_.x(), vertical_skew_.y());
+    tprintf_level(1, "Vertical skew vector=(%d,%d)\n",
+                  vertical_skew_.x(), vertical_skew_.y());
   v_it_.set_to_list(&vectors_);
   for (v_it_.mark_cycle_pt(); !v_it_.cycled_list(); v_it_.forward()) {
     TabVector* v = v_it_.data();
@@ -1055,9 +1057,9 @@ void TabFind::MakeColumnWidths(int col_widths_size, STATS* col_widths) {
       ICOORDELT* w = new ICOORDELT(width, col_count);
       w_it.add_after_then_move(w);
       if (textord_debug_tabfind)
-        tprintf("Column of width %d has %d = %.2f%% lines\n",
-              width * kColumnWidthFactor, col_count,
-              100.0 * col_count / total_col_count);
+        tprintf_level(1, "Column of width %d has %d = %.2f%% lines\n",
+                      width * kColumnWidthFactor, col_count,
+                      100.0 * col_count / total_col_count);
     }
   }
 }
@@ -1066,7 +1068,7 @@ void TabFind::MakeColumnWidths(int col_widths_size, STATS* col_widths) {
 // Returns true if the majority of the image is vertical text lines.
 void TabFind::MarkVerticalText() {
   if (textord_debug_tabfind)
-    tprintf("Checking for vertical lines\n");
+    tprintf_level(1, "Checking for vertical lines\n");
   BlobGridSearch gsearch(this);
   gsearch.StartFullSearch();
   BLOBNBOX* blob = NULL;
@@ -1096,8 +1098,8 @@ int TabFind::FindMedianGutterWidth(TabVector_LIST *lines) {
     prev_right = partner->startpt().x();
   }
   if (textord_debug_tabfind)
-    tprintf("TabGutter total %d  median_gap %.2f  median_hgt %.2f\n",
-            gaps.get_total(), gaps.median(), heights.median());
+    tprintf_level(1, "TabGutter total %d  median_gap %.2f  median_hgt %.2f\n",
+                  gaps.get_total(), gaps.median(), heights.median());
   if (gaps.get_total() < kMinLinesInColumn) return 0;
   return static_cast<int>(gaps.median());
 }
@@ -1145,8 +1147,8 @@ BLOBNBOX* TabFind::AdjacentBlob(const BLOBNBOX* bbox,
         if (h_gap > gap_limit) {
           // Hit a big gap before next tab so don't return anything.
           if (debug)
-            tprintf("Giving up due to big gap = %d vs %d\n",
-                    h_gap, gap_limit);
+            tprintf_level(1, "Giving up due to big gap = %d vs %d\n",
+                          h_gap, gap_limit);
           return result;
         }
         if (h_gap > 0 && (look_left ? neighbour->right_tab_type()
@@ -1154,17 +1156,17 @@ BLOBNBOX* TabFind::AdjacentBlob(const BLOBNBOX* bbox,
           // Hit a tab facing the wrong way. Stop in case we are crossing
           // the column boundary.
           if (debug)
-            tprintf("Collision with like tab of type %d at %d,%d\n",
-                    look_left ? neighbour->right_tab_type()
-                                  : neighbour->left_tab_type(),
-                    n_left, nbox.bottom());
+            tprintf_level(1, "Collision with like tab of type %d at %d,%d\n",
+                          look_left ? neighbour->right_tab_type()
+                                        : neighbour->left_tab_type(),
+                          n_left, nbox.bottom());
           return result;
         }
         // This is a good fit to the line. Continue with this
         // neighbour as the bbox if the best gap.
         if (result == NULL || h_gap < best_gap) {
           if (debug)
-            tprintf("Good result\n");
+            tprintf_level(1, "Good result\n");
           result = neighbour;
           best_gap = h_gap;
         } else {
@@ -1172,10 +1174,10 @@ BLOBNBOX* TabFind::AdjacentBlob(const BLOBNBOX* bbox,
           return result;
         }
       } else if (debug) {
-        tprintf("Wrong way\n");
+        tprintf_level(1, "Wrong way\n");
       }
     } else if (debug) {
-      tprintf("Insufficient overlap\n");
+      tprintf_level(1, "Insufficient overlap\n");
     }
   }
   if (WithinTestRegion(3, left, box.top()))
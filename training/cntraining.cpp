@@ -28,6 +28,7 @@
 #include "efio.h"
 #include "emalloc.h"
 #include "featdefs.h"
+#include "genericvector.h"
 #include "tessopt.h"
 #include "ocrfeatures.h"
 #include "clusttool.h"
@@ -147,10 +148,11 @@ int main(int  argc, char* argv[])
   FILE  *TrainingPage;
   LIST  CharList = NIL_LIST;
   CLUSTERER  *Clusterer = NULL;
-  LIST    ProtoList = NIL_LIST;
   LIST    NormProtoList = NIL_LIST;
   LIST pCharList;
-  LABELEDLIST CharSample;
+  GenericVector<LABELEDLIST> CharSamples;
+  GenericVector<CLUSTERER *> Clusterers;
+  GenericVector<LIST> ProtoLists;
   FEATURE_DEFS_STRUCT FeatureDefs;
   InitFeatureDefs(&FeatureDefs);
 
@@ -170,29 +172,46 @@ int main(int  argc, char* argv[])
   // Config.MinSamples = 0.5 / num_fonts;
   pCharList = CharList;
   iterate(pCharList) {
+    CharSamples.push_back((LABELEDLIST)first_node(pCharList));
+  }
+  // The characters are clustered independently of each other, so they can
+  // be done in parallel.  The results are added to NormProtoList in the
+  // original order afterwards.
+  int NumChars = CharSamples.size();
+  Clusterers.init_to_size(NumChars, NULL);
+  ProtoLists.init_to_size(NumChars, NIL_LIST);
+  #pragma omp parallel for schedule(dynamic)
+  for (int c = 0; c < NumChars; ++c) {
     //Cluster
-    CharSample = (LABELEDLIST)first_node(pCharList);
-    Clusterer =
+    LABELEDLIST CharSample = CharSamples[c];
+    CLUSTERER *CharClusterer =
       SetUpForClustering(FeatureDefs, CharSample, PROGRAM_FEATURE_TYPE);
-    float SavedMinSamples = Config.MinSamples;
+    // Each character gets its own copy of the global Config.
+    CLUSTERCONFIG CharConfig = Config;
     // To disable the tendency to produce a single cluster for all fonts,
     // make MagicSamples an impossible to achieve number:
-    // Config.MagicSamples = CharSample->SampleCount * 10;
-    Config.MagicSamples = CharSample->SampleCount;
-    while (Config.MinSamples > 0.001) {
-      ProtoList = ClusterSamples(Clusterer, &Config);
+    // CharConfig.MagicSamples = CharSample->SampleCount * 10;
+    CharConfig.MagicSamples = CharSample->SampleCount;
+    LIST ProtoList = NIL_LIST;
+    while (CharConfig.MinSamples > 0.001) {
+      ProtoList = ClusterSamples(CharClusterer, &CharConfig);
       if (NumberOfProtos(ProtoList, 1, 0) > 0) {
         break;
       } else {
-        Config.MinSamples *= 0.95;
+        CharConfig.MinSamples *= 0.95;
         printf("0 significant protos for %s."
                " Retrying clustering with MinSamples = %f%%\n",
-               CharSample->Label, Config.MinSamples);
+               CharSample->Label, CharConfig.MinSamples);
       }
     }
-    Config.MinSamples = SavedMinSamples;
-    AddToNormProtosList(&NormProtoList, ProtoList, CharSample->Label);
+    Clusterers[c] = CharClusterer;
+    ProtoLists[c] = ProtoList;
+  }
+  for (int c = 0; c < NumChars; ++c) {
+    AddToNormProtosList(&NormProtoList, ProtoLists[c], CharSamples[c]->Label);
   }
+  if (NumChars > 0)
+    Clusterer = Clusterers.back();
   FreeTrainingSamples(CharList);
   if (Clusterer == NULL) { // To avoid a SIGSEGV
     fprintf(stderr, "Error: NULL clusterer!\n");
@@ -200,8 +219,10 @@ int main(int  argc, char* argv[])
   }
   WriteNormProtos(FLAGS_D.c_str(), NormProtoList, Clusterer);
   FreeNormProtoList(NormProtoList);
-  FreeProtoList(&ProtoList);
-  FreeClusterer(Clusterer);
+  for (int c = 0; c < NumChars; ++c) {
+    FreeProtoList(&ProtoLists[c]);
+    FreeClusterer(Clusterers[c]);
+  }
   printf ("\n");
   return 0;
 }  // main
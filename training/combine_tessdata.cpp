@@ -18,7 +18,9 @@
 //
 ///////////////////////////////////////////////////////////////////////
 
+#include "ambigs.h"
 #include "tessdatamanager.h"
+#include "unicharset.h"
 
 // Main program to combine/extract/overwrite tessdata components
 // in [lang].traineddata files.
@@ -63,6 +65,18 @@
 // This will create  /home/$USER/temp/eng.* files with individual tessdata
 // components from tessdata/eng.traineddata.
 //
+// Specify option -a to compile the universal ambigs and the unichar ambigs of
+// a traineddata file for its unicharset, which saves parsing them every time
+// the language is loaded:
+//
+//   combine_tessdata -a tessdata/eng.traineddata
+//   /home/$USER/temp/eng.compiled-ambigs
+//   combine_tessdata -o tessdata/eng.traineddata
+//   /home/$USER/temp/eng.compiled-ambigs
+//
+// The compiled ambigs are ignored if the unicharset or the unichar ambigs are
+// later overwritten, so they must be compiled again after that.
+//
 int main(int argc, char **argv) {
   int i;
   if (argc == 2) {
@@ -84,7 +98,10 @@ int main(int argc, char **argv) {
                            strcmp(argv[1], "-u") == 0)) {
     // Initialize TessdataManager with the data in the given traineddata file.
     tesseract::TessdataManager tm;
-    tm.Init(argv[2], 0);
+    if (!tm.Init(argv[2], 0)) {
+      tprintf("Failed to read %s\n", argv[2]);
+      exit(1);
+    }
     printf("Extracting tessdata components from %s\n", argv[2]);
     if (strcmp(argv[1], "-e") == 0) {
       for (i = 3; i < argc; ++i) {
@@ -121,11 +138,46 @@ int main(int argc, char **argv) {
 
     // Initialize TessdataManager with the data in the given traineddata file.
     tesseract::TessdataManager tm;
-    tm.Init(traineddata_filename.string(), 0);
+    if (!tm.Init(traineddata_filename.string(), 0)) {
+      tprintf("Failed to read %s\n", traineddata_filename.string());
+      rename(traineddata_filename.string(), new_traineddata_filename);
+      exit(1);
+    }
 
     // Write the updated traineddata file.
     tm.OverwriteComponents(new_traineddata_filename, argv+3, argc-3);
     tm.End();
+  } else if (argc == 4 && strcmp(argv[1], "-a") == 0) {
+    tesseract::TessdataManager tm;
+    if (!tm.Init(argv[2], 0)) {
+      tprintf("Failed to read %s\n", argv[2]);
+      exit(1);
+    }
+    UNICHARSET unicharset;
+    if (!tm.SeekToStart(tesseract::TESSDATA_UNICHARSET) ||
+        !unicharset.load_from_file(tm.GetDataFilePtr())) {
+      tprintf("Failed to read the unicharset from %s\n", argv[2]);
+      exit(1);
+    }
+    tesseract::TFile ambigs_file;
+    bool have_ambigs = tm.SeekToStart(tesseract::TESSDATA_AMBIGS) &&
+        ambigs_file.Open(tm.GetDataFilePtr(),
+                         tm.GetEndOffset(tesseract::TESSDATA_AMBIGS) + 1);
+    tesseract::CompiledAmbigs universal_ambigs;
+    tesseract::CompiledAmbigs lang_ambigs;
+    tesseract::UnicharAmbigs::CompileUniversal(unicharset, &universal_ambigs);
+    tesseract::UnicharAmbigs::CompileUnicharAmbigs(
+        unicharset, have_ambigs ? &ambigs_file : NULL, 0, &lang_ambigs);
+    tm.End();
+    FILE* fp = fopen(argv[3], "wb");
+    if (fp == NULL || !universal_ambigs.Serialize(fp) ||
+        !lang_ambigs.Serialize(fp)) {
+      tprintf("Failed to write %s\n", argv[3]);
+      exit(1);
+    }
+    fclose(fp);
+    printf("Compiled %d universal and %d unichar ambigs into %s\n",
+           universal_ambigs.size(), lang_ambigs.size(), argv[3]);
   } else {
     printf("Usage for combining tessdata components:\n"
            "  %s language_data_path_prefix\n"
@@ -140,7 +192,11 @@ int main(int argc, char **argv) {
            argv[0], argv[0]);
     printf("Usage for unpacking all tessdata components:\n"
            "  %s -u traineddata_file output_path_prefix\n"
-           "  (e.g. %s -u eng.traineddata tmp/eng.)\n", argv[0], argv[0]);
+           "  (e.g. %s -u eng.traineddata tmp/eng.)\n\n", argv[0], argv[0]);
+    printf("Usage for compiling the ambigs of a traineddata file:\n"
+           "  %s -a traineddata_file output_component_file\n"
+           "  (e.g. %s -a eng.traineddata eng.compiled-ambigs)\n",
+           argv[0], argv[0]);
     return 1;
   }
 }
@@ -125,8 +125,8 @@ static void DisplayProtoList(const char* ch, LIST protolist) {
 
 // Helper to run clustering on a single config.
 // Mostly copied from the old mftraining, but with renamed variables.
+// Only reads the shared state, so it may be run on several configs at once.
 static LIST ClusterOneConfig(int shape_id, const char* class_label,
-                             LIST mf_classes,
                              const ShapeTable& shape_table,
                              MasterTrainer* trainer) {
   int num_samples;
@@ -134,22 +134,34 @@ static LIST ClusterOneConfig(int shape_id, const char* class_label,
                                                       feature_defs,
                                                       shape_id,
                                                       &num_samples);
-  Config.MagicSamples = num_samples;
-  LIST proto_list = ClusterSamples(clusterer, &Config);
+  // Each config gets its own copy of the global Config.
+  CLUSTERCONFIG config = Config;
+  config.MagicSamples = num_samples;
+  LIST proto_list = ClusterSamples(clusterer, &config);
   CleanUpUnusedData(proto_list);
 
   // Merge protos where reasonable to make more of them significant by
   // representing almost all samples of the class/font.
-  MergeInsignificantProtos(proto_list, class_label, clusterer, &Config);
+  MergeInsignificantProtos(proto_list, class_label, clusterer, &config);
   #ifndef GRAPHICS_DISABLED
-  if (strcmp(FLAGS_test_ch.c_str(), class_label) == 0)
+  if (strcmp(FLAGS_test_ch.c_str(), class_label) == 0) {
+    #pragma omp critical
     DisplayProtoList(FLAGS_test_ch.c_str(), proto_list);
+  }
   #endif  // GRAPHICS_DISABLED
   // Delete the protos that will not be used in the inttemp output file.
   proto_list = RemoveInsignificantProtos(proto_list, true,
                                          false,
                                          clusterer->SampleSize);
   FreeClusterer(clusterer);
+  return proto_list;
+}
+
+// Helper to merge the protos of a single config, as produced by
+// ClusterOneConfig, into the class that it belongs to in mf_classes.
+// Consumes proto_list.
+static LIST MergeOneConfig(int shape_id, const char* class_label,
+                           LIST proto_list, LIST mf_classes) {
   MERGE_CLASS merge_class = FindClass(mf_classes, class_label);
   if (merge_class == NULL) {
     merge_class = NewLabeledClass(class_label);
@@ -285,7 +297,7 @@ int main (int argc, char **argv) {
 
   // Now train each config separately.
   int num_configs = shape_table->NumShapes();
-  LIST mf_classes = NIL_LIST;
+  GenericVector<const char*> class_labels;
   for (int s = 0; s < num_configs; ++s) {
     int unichar_id, font_id;
     if (unicharset == &shape_set) {
@@ -295,9 +307,22 @@ int main (int argc, char **argv) {
       // Get the real unichar_id from the shape table/unicharset.
       shape_table->GetFirstUnicharAndFont(s, &unichar_id, &font_id);
     }
-    const char* class_label = unicharset->id_to_unichar(unichar_id);
-    mf_classes = ClusterOneConfig(s, class_label, mf_classes, *shape_table,
-                                  trainer);
+    class_labels.push_back(unicharset->id_to_unichar(unichar_id));
+  }
+  // The configs are clustered independently, so they can be done in
+  // parallel, but they are merged into the classes in order, so that the
+  // output does not depend on the number of threads.
+  GenericVector<LIST> proto_lists;
+  proto_lists.init_to_size(num_configs, NIL_LIST);
+  #pragma omp parallel for schedule(dynamic)
+  for (int s = 0; s < num_configs; ++s) {
+    proto_lists[s] = ClusterOneConfig(s, class_labels[s], *shape_table,
+                                      trainer);
+  }
+  LIST mf_classes = NIL_LIST;
+  for (int s = 0; s < num_configs; ++s) {
+    mf_classes = MergeOneConfig(s, class_labels[s], proto_lists[s],
+                                mf_classes);
   }
   STRING inttemp_file = file_prefix;
   inttemp_file += "inttemp";
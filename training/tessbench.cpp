@@ -0,0 +1,447 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//  Filename: tessbench.cpp
+//  Purpose:  Times the hot paths of recognition on a fixed corpus of
+//            synthetic pages, generated from seed images with a fixed
+//            random seed, so that runs on the same machine are comparable.
+//            Each benchmark is run a number of times and the median and
+//            minimum over the runs are reported.
+
+#include <stdio.h>
+#ifdef _WIN32
+#include "gettimeofday.h"
+#else
+#include <sys/time.h>
+#endif
+#include "allheaders.h"  // from leptonica
+#include "baseapi.h"
+#include "commandlineflags.h"
+#include "coutln.h"
+#include "dawg.h"
+#include "degradeimage.h"
+#include "dict.h"
+#include "genericvector.h"
+#include "helpers.h"
+#include "intfx.h"
+#include "intmatcher.h"
+#include "intproto.h"
+#include "matrix.h"
+#include "otsuthr.h"
+#include "pageres.h"
+#include "pagestats.h"
+#include "pdblock.h"
+#include "ratngs.h"
+#include "scanedg.h"
+#include "shapetable.h"
+#include "strngs.h"
+#include "tesseractclass.h"
+#include "thresholder.h"
+#include "trainingsample.h"
+
+STRING_PARAM_FLAG(lang, "eng", "Language to benchmark");
+STRING_PARAM_FLAG(tessdata_dir, "", "Directory of traineddata files");
+STRING_PARAM_FLAG(images, "testing/phototest.tif,testing/eurotext.tif",
+                  "Comma-separated seed images of the synthetic corpus");
+INT_PARAM_FLAG(pages, 4, "Number of synthetic pages in the corpus");
+INT_PARAM_FLAG(runs, 5, "Number of times to run each benchmark");
+INT_PARAM_FLAG(seed, 1, "Random seed used to generate the corpus");
+
+namespace tesseract {
+
+// Size of the synthetic pages: US letter at 300 dpi in two columns.
+const int kPageWidth = 2550;
+const int kPageHeight = 3300;
+const int kPageResolution = 300;
+const int kPageMargin = 150;
+const int kColumnGap = 150;
+const int kNumColumns = 2;
+// A seed image is not started in a column with less room left than this.
+const int kMinPieceHeight = 300;
+// Number of the best pruner classes that are given to the IntegerMatcher.
+const int kMatchClasses = 8;
+
+// Returns the current wall clock time in seconds.
+static double WallTime() {
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return now.tv_sec + now.tv_usec / 1000000.0;
+}
+
+// Prints a line of the report for a benchmark that did ops operations in
+// each of the runs, which took the given times in seconds.
+static void Report(const char* name, int ops, GenericVector<double>* times) {
+  if (times->empty()) return;
+  times->sort();
+  double median = (*times)[times->size() / 2];
+  printf("%-36s %10d %12.3f %12.3f %12.3f\n", name, ops, median * 1000.0,
+         (*times)[0] * 1000.0, ops > 0 ? median * 1000000.0 / ops : 0.0);
+}
+
+// Reads the comma-separated seed images and converts them to 8 bit grey.
+// Returns false if any of them could not be read.
+static bool ReadSeedImages(const char* names, GenericVector<Pix*>* seeds) {
+  GenericVector<STRING> filenames;
+  STRING(names).split(',', &filenames);
+  for (int i = 0; i < filenames.size(); ++i) {
+    Pix* pix = pixRead(filenames[i].string());
+    if (pix == NULL) {
+      tprintf("Can't read seed image %s\n", filenames[i].string());
+      return false;
+    }
+    Pix* grey = pixConvertTo8(pix, false);
+    pixDestroy(&pix);
+    if (grey == NULL) {
+      tprintf("Can't convert seed image %s to grey\n", filenames[i].string());
+      return false;
+    }
+    seeds->push_back(grey);
+  }
+  return !seeds->empty();
+}
+
+// Makes a synthetic page by filling the columns with the seed images,
+// starting at the given seed index, each scaled to the column width and
+// degraded as if photocopied with the given randomizer.
+static Pix* MakeSyntheticPage(const GenericVector<Pix*>& seeds,
+                              int seed_index, TRand* randomizer) {
+  Pix* page = pixCreate(kPageWidth, kPageHeight, 8);
+  pixSetAll(page);
+  pixSetResolution(page, kPageResolution, kPageResolution);
+  int column_width = (kPageWidth - 2 * kPageMargin -
+                      (kNumColumns - 1) * kColumnGap) / kNumColumns;
+  int bottom = kPageHeight - kPageMargin;
+  for (int col = 0; col < kNumColumns; ++col) {
+    int x = kPageMargin + col * (column_width + kColumnGap);
+    for (int y = kPageMargin; y + kMinPieceHeight <= bottom;) {
+      Pix* seed = seeds[seed_index++ % seeds.size()];
+      float scale = static_cast<float>(column_width) / pixGetWidth(seed);
+      Pix* piece = pixScale(seed, scale, scale);
+      int exposure = randomizer->IntRand() % 3 - 1;
+      piece = DegradeImage(piece, exposure, randomizer, NULL);
+      int width = MIN(pixGetWidth(piece), column_width);
+      int height = MIN(pixGetHeight(piece), bottom - y);
+      pixRasterop(page, x, y, width, height, PIX_SRC, piece, 0, 0);
+      pixDestroy(&piece);
+      y += height + kColumnGap;
+    }
+  }
+  return page;
+}
+
+// TessBaseAPI that gives access to the results of the last page.
+class BenchmarkAPI : public TessBaseAPI {
+ public:
+  const PAGE_RES* page_res() const {
+    return GetPageRes();
+  }
+};
+
+// ImageThresholder that keeps the Otsu thresholds of the whole image, so
+// the thresholding itself can be timed on its own.
+class BenchmarkThresholder : public ImageThresholder {
+ public:
+  BenchmarkThresholder()
+    : num_channels_(0), thresholds_(NULL), hi_values_(NULL) {}
+  virtual ~BenchmarkThresholder() {
+    delete [] thresholds_;
+    delete [] hi_values_;
+  }
+
+  // Computes the thresholds of the current image.
+  void ComputeThresholds() {
+    delete [] thresholds_;
+    delete [] hi_values_;
+    num_channels_ = OtsuThreshold(pix_, rect_left_, rect_top_, rect_width_,
+                                  rect_height_, &thresholds_, &hi_values_);
+  }
+  // Thresholds the current image with the computed thresholds. The result
+  // must be pixDestroyed.
+  Pix* Threshold() const {
+    Pix* binary = NULL;
+    ThresholdRectToPix(pix_, num_channels_, thresholds_, hi_values_, &binary);
+    return binary;
+  }
+
+ private:
+  int num_channels_;
+  int* thresholds_;
+  int* hi_values_;
+};
+
+// The inputs to the classifier and dictionary benchmarks, taken from the
+// results of recognizing the corpus.
+struct RecognizedCorpus {
+  // Features of every blob of the best segmentation of every word.
+  PointerVector<TrainingSample> samples;
+  // For each sample, the best classes of the pruner.
+  GenericVector<GenericVector<int> > pruner_classes;
+  // The unichar ids of the best choice of every word, with the index of the
+  // first of each word in word_starts.
+  GenericVector<UNICHAR_ID> ids;
+  GenericVector<int> word_starts;
+  // Copies of the classified cells of the ratings matrix of every word.
+  PointerVector<BLOB_CHOICE_LIST> choice_lists;
+};
+
+// Adds the words of the page just recognized by api to corpus.
+static void CollectWords(BenchmarkAPI* api, RecognizedCorpus* corpus) {
+  Tesseract* tess = api->tesseract();
+  PAGE_RES_IT page_res_it(const_cast<PAGE_RES*>(api->page_res()));
+  for (page_res_it.restart_page(); page_res_it.word() != NULL;
+       page_res_it.forward()) {
+    WERD_RES* word = page_res_it.word();
+    // Words recognized by another language don't fit the templates.
+    if (word->rebuild_word == NULL || word->best_choice == NULL ||
+        word->uch_set != &tess->unicharset)
+      continue;
+    for (int b = 0; b < word->rebuild_word->NumBlobs(); ++b) {
+      INT_FX_RESULT_STRUCT fx_info;
+      GenericVector<INT_FEATURE_STRUCT> bl_features;
+      TrainingSample* sample =
+          BlobToTrainingSample(*word->rebuild_word->blobs[b],
+                               tess->classify_nonlinear_norm, &fx_info,
+                               &bl_features);
+      if (sample != NULL)
+        corpus->samples.push_back(sample);
+    }
+    if (word->ratings != NULL) {
+      MATRIX* ratings = word->ratings;
+      for (int col = 0; col < ratings->dimension(); ++col) {
+        for (int row = col; row < col + ratings->bandwidth() &&
+             row < ratings->dimension(); ++row) {
+          BLOB_CHOICE_LIST* choices = ratings->get(col, row);
+          if (choices == NOT_CLASSIFIED || choices->empty()) continue;
+          BLOB_CHOICE_LIST* copy = new BLOB_CHOICE_LIST;
+          copy->deep_copy(choices, &BLOB_CHOICE::deep_copy);
+          corpus->choice_lists.push_back(copy);
+        }
+      }
+    }
+    if (word->best_choice->length() == 0)
+      continue;
+    corpus->word_starts.push_back(corpus->ids.size());
+    for (int i = 0; i < word->best_choice->length(); ++i)
+      corpus->ids.push_back(word->best_choice->unichar_id(i));
+  }
+}
+
+// Times the whole of the recognition of the corpus and, from the page
+// stats, the FindBlocks and SegSearch parts of it. The words of the last
+// run are added to corpus.
+static void BenchmarkPages(const GenericVector<Pix*>& pages,
+                           BenchmarkAPI* api, RecognizedCorpus* corpus) {
+  GenericVector<double> page_times, layout_times, segsearch_times;
+  for (int run = 0; run < FLAGS_runs; ++run) {
+    // Each run starts with no adaption, so all runs do the same work.
+    api->ClearAdaptiveClassifier();
+    double layout_time = 0.0, segsearch_time = 0.0;
+    double start = WallTime();
+    for (int p = 0; p < pages.size(); ++p) {
+      api->SetImage(pages[p]);
+      api->Recognize(NULL);
+      PageStats stats;
+      api->GetPageStats(&stats);
+      layout_time += stats.wall_time(PAGE_STAGE_LAYOUT);
+      segsearch_time += stats.wall_time(PAGE_STAGE_SEGSEARCH);
+      if (run + 1 == FLAGS_runs)
+        CollectWords(api, corpus);
+    }
+    page_times.push_back(WallTime() - start);
+    layout_times.push_back(layout_time);
+    segsearch_times.push_back(segsearch_time);
+  }
+  Report("Page (full recognition)", pages.size(), &page_times);
+  Report("FindBlocks", pages.size(), &layout_times);
+  Report("SegSearch", pages.size(), &segsearch_times);
+}
+
+// Times ThresholdRectToPix and block_edges on each page of the corpus.
+static void BenchmarkThresholding(const GenericVector<Pix*>& pages) {
+  GenericVector<double> threshold_times, edge_times;
+  for (int run = 0; run < FLAGS_runs; ++run) {
+    double threshold_time = 0.0, edge_time = 0.0;
+    for (int p = 0; p < pages.size(); ++p) {
+      BenchmarkThresholder thresholder;
+      thresholder.SetImage(pages[p]);
+      thresholder.ComputeThresholds();
+      double start = WallTime();
+      Pix* binary = thresholder.Threshold();
+      threshold_time += WallTime() - start;
+      PDBLK block(0, 0, pixGetWidth(binary), pixGetHeight(binary));
+      C_OUTLINE_LIST outlines;
+      C_OUTLINE_IT out_it = &outlines;
+      start = WallTime();
+      block_edges(binary, &block, &out_it);
+      edge_time += WallTime() - start;
+      pixDestroy(&binary);
+    }
+    threshold_times.push_back(threshold_time);
+    edge_times.push_back(edge_time);
+  }
+  Report("ThresholdRectToPix", pages.size(), &threshold_times);
+  Report("block_edges", pages.size(), &edge_times);
+}
+
+// Times the class pruner on the samples of the corpus and saves the best
+// classes of each for BenchmarkMatcher. The pruner is run the way the
+// classifier runs it, through CharNormTrainingSample, so the time includes
+// the char norm arrays that it needs as well as ClassPruner::ComputeScores.
+static void BenchmarkPruner(Classify* classify, RecognizedCorpus* corpus) {
+  GenericVector<double> times;
+  GenericVector<UnicharRating> results;
+  for (int run = 0; run < FLAGS_runs; ++run) {
+    bool last_run = run + 1 == FLAGS_runs;
+    double start = WallTime();
+    for (int s = 0; s < corpus->samples.size(); ++s) {
+      classify->CharNormTrainingSample(true, -1, *corpus->samples[s],
+                                       &results);
+      if (last_run) {
+        GenericVector<int> classes;
+        for (int r = 0; r < results.size() && r < kMatchClasses; ++r)
+          classes.push_back(results[r].unichar_id);
+        corpus->pruner_classes.push_back(classes);
+      }
+    }
+    times.push_back(WallTime() - start);
+  }
+  Report("CharNormTrainingSample(pruner)", corpus->samples.size(), &times);
+}
+
+// Times the IntegerMatcher on each sample of the corpus against the best
+// classes of the pruner.
+static void BenchmarkMatcher(Classify* classify,
+                             const RecognizedCorpus& corpus) {
+  IntegerMatcher matcher;
+  matcher.Init(&classify->classify_debug_level);
+  GenericVector<double> times;
+  int ops = 0;
+  for (int run = 0; run < FLAGS_runs; ++run) {
+    ops = 0;
+    double start = WallTime();
+    for (int s = 0; s < corpus.pruner_classes.size(); ++s) {
+      const TrainingSample* sample = corpus.samples[s];
+      const GenericVector<int>& classes = corpus.pruner_classes[s];
+      for (int c = 0; c < classes.size(); ++c) {
+        INT_CLASS int_class =
+            ClassForClassId(classify->PreTrainedTemplates, classes[c]);
+        if (int_class == NULL) continue;
+        INT_RESULT_STRUCT int_result;
+        matcher.Match(int_class, classify->AllProtosOn,
+                      classify->AllConfigsOn, sample->num_features(),
+                      sample->features(), &int_result,
+                      classify->classify_adapt_feature_threshold, 0, false);
+        ++ops;
+      }
+    }
+    times.push_back(WallTime() - start);
+  }
+  Report("IntegerMatcher::Match", ops, &times);
+}
+
+// Times looking up every prefix of every word of the corpus in each of the
+// SquishedDawgs of dict.
+static void BenchmarkDawgs(Dict* dict, const RecognizedCorpus& corpus) {
+  GenericVector<double> times;
+  int ops = 0;
+  int num_words = corpus.word_starts.size();
+  for (int run = 0; run < FLAGS_runs; ++run) {
+    ops = 0;
+    double start = WallTime();
+    for (int d = 0; d < dict->NumDawgs(); ++d) {
+      const SquishedDawg* dawg =
+          dynamic_cast<const SquishedDawg*>(dict->GetDawg(d));
+      if (dawg == NULL) continue;
+      for (int w = 0; w < num_words; ++w) {
+        int end = w + 1 < num_words ? corpus.word_starts[w + 1]
+                                    : corpus.ids.size();
+        NODE_REF node = 0;
+        for (int i = corpus.word_starts[w]; i < end; ++i) {
+          EDGE_REF edge = dawg->edge_char_of(node, corpus.ids[i],
+                                             i + 1 == end);
+          ++ops;
+          if (edge == NO_EDGE || (node = dawg->next_node(edge)) == 0)
+            break;
+        }
+      }
+    }
+    times.push_back(WallTime() - start);
+  }
+  Report("SquishedDawg::edge_char_of", ops, &times);
+}
+
+// Times filling a BlobChoiceTable from each ratings cell of the corpus, as
+// LanguageModel::UpdateState does, against a single walk of the same list.
+static void BenchmarkChoiceTable(const RecognizedCorpus& corpus) {
+  BlobChoiceTable table;
+  GenericVector<double> set_times, walk_times;
+  float sum = 0.0f;
+  for (int run = 0; run < FLAGS_runs; ++run) {
+    double start = WallTime();
+    for (int l = 0; l < corpus.choice_lists.size(); ++l) {
+      table.Set(corpus.choice_lists[l]);
+      sum += table.certainty(table.size() - 1);
+    }
+    set_times.push_back(WallTime() - start);
+    start = WallTime();
+    for (int l = 0; l < corpus.choice_lists.size(); ++l) {
+      BLOB_CHOICE_IT c_it(corpus.choice_lists[l]);
+      for (c_it.mark_cycle_pt(); !c_it.cycled_list(); c_it.forward())
+        sum += c_it.data()->certainty();
+    }
+    walk_times.push_back(WallTime() - start);
+  }
+  // Stores the sum so that the loops are not optimized away.
+  volatile float sink = sum;
+  (void)sink;
+  Report("BlobChoiceTable::Set", corpus.choice_lists.size(), &set_times);
+  Report("BLOB_CHOICE_LIST walk", corpus.choice_lists.size(), &walk_times);
+}
+
+}  // namespace tesseract
+
+int main(int argc, char** argv) {
+  tesseract::ParseCommandLineFlags(argv[0], &argc, &argv, true);
+  GenericVector<Pix*> seeds;
+  if (!tesseract::ReadSeedImages(FLAGS_images.c_str(), &seeds))
+    return 1;
+  tesseract::TRand randomizer;
+  randomizer.set_seed(FLAGS_seed);
+  GenericVector<Pix*> pages;
+  for (int p = 0; p < FLAGS_pages; ++p)
+    pages.push_back(tesseract::MakeSyntheticPage(seeds, p, &randomizer));
+  for (int i = 0; i < seeds.size(); ++i)
+    pixDestroy(&seeds[i]);
+
+  tesseract::BenchmarkAPI api;
+  if (api.Init(FLAGS_tessdata_dir.c_str(), FLAGS_lang.c_str(),
+               tesseract::OEM_TESSERACT_ONLY) < 0) {
+    tprintf("Failed to initialize tesseract for language %s\n",
+            FLAGS_lang.c_str());
+    return 1;
+  }
+  tesseract::Tesseract* tess = api.tesseract();
+  printf("%d pages, %d runs\n", pages.size(), static_cast<int>(FLAGS_runs));
+  printf("%-36s %10s %12s %12s %12s\n", "Benchmark", "Ops", "Median ms",
+         "Min ms", "Median us/op");
+  tesseract::RecognizedCorpus corpus;
+  tesseract::BenchmarkPages(pages, &api, &corpus);
+  tesseract::BenchmarkThresholding(pages);
+  if (tess->PreTrainedTemplates != NULL) {
+    tesseract::BenchmarkPruner(tess, &corpus);
+    tesseract::BenchmarkMatcher(tess, corpus);
+  }
+  tesseract::BenchmarkDawgs(&tess->getDict(), corpus);
+  tesseract::BenchmarkChoiceTable(corpus);
+  api.End();
+  for (int p = 0; p < pages.size(); ++p)
+    pixDestroy(&pages[p]);
+  return 0;
+}
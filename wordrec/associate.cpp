@@ -49,8 +49,8 @@ void AssociateUtils::ComputeStats(int col, int row,
     return;
   }
   if (debug) {
-    tprintf("AssociateUtils::ComputeStats() for col=%d, row=%d%s\n",
-            col, row, fixed_pitch ? " (fixed pitch)" : "");
+    tprintf_level(1, "AssociateUtils::ComputeStats() for col=%d, row=%d%s\n",
+                  col, row, fixed_pitch ? " (fixed pitch)" : "");
   }
   float normalizing_height = kBlnXHeight;
   ROW* blob_row = word_res->blob_row;
@@ -66,9 +66,10 @@ void AssociateUtils::ComputeStats(int col, int row,
           (blob_row->x_height() + blob_row->ascenders());
     }
     if (debug) {
-      tprintf("normalizing height = %g (scale %g xheight %g ascenders %g)\n",
-              normalizing_height, word_res->denorm.y_scale(),
-              blob_row->x_height(), blob_row->ascenders());
+      tprintf_level(1,
+          "normalizing height = %g (scale %g xheight %g ascenders %g)\n",
+          normalizing_height, word_res->denorm.y_scale(), blob_row->x_height(),
+          blob_row->ascenders());
     }
   }
   float wh_ratio = word_res->GetBlobsWidth(col, row) / normalizing_height;
@@ -84,9 +85,9 @@ void AssociateUtils::ComputeStats(int col, int row,
   }
   if (stats->gap_sum == 0) stats->gap_sum = negative_gap_sum;
   if (debug) {
-    tprintf("wh_ratio=%g (max_char_wh_ratio=%g) gap_sum=%d %s\n",
-            wh_ratio, max_char_wh_ratio, stats->gap_sum,
-            stats->bad_shape ? "bad_shape" : "");
+    tprintf_level(1, "wh_ratio=%g (max_char_wh_ratio=%g) gap_sum=%d %s\n",
+                  wh_ratio, max_char_wh_ratio, stats->gap_sum,
+                  stats->bad_shape ? "bad_shape" : "");
   }
   // Compute shape_cost (for fixed pitch mode).
   if (fixed_pitch) {
@@ -102,8 +103,8 @@ void AssociateUtils::ComputeStats(int col, int row,
         stats->bad_shape = true;
       }
       if (debug) {
-        tprintf("left_gap %g, left_seam %g %s\n", left_gap, left_seam->priority,
-                stats->bad_shape ? "bad_shape" : "");
+        tprintf_level(1, "left_gap %g, left_seam %g %s\n", left_gap,
+                      left_seam->priority, stats->bad_shape ? "bad_shape" : "");
       }
     }
     float right_gap = 0.0f;
@@ -115,9 +116,9 @@ void AssociateUtils::ComputeStats(int col, int row,
         if (right_gap < kMinGap) stats->bad_fixed_pitch_right_gap = true;
       }
       if (debug) {
-        tprintf("right_gap %g right_seam %g %s\n",
-                right_gap, right_seam->priority,
-                stats->bad_shape ? "bad_shape" : "");
+        tprintf_level(1, "right_gap %g right_seam %g %s\n",
+                      right_gap, right_seam->priority,
+                      stats->bad_shape ? "bad_shape" : "");
       }
     }
 
@@ -138,9 +139,10 @@ void AssociateUtils::ComputeStats(int col, int row,
       stats->full_wh_ratio_total = stats->full_wh_ratio;
     }
     if (debug) {
-      tprintf("full_wh_ratio %g full_wh_ratio_total %g full_wh_ratio_var %g\n",
-              stats->full_wh_ratio, stats->full_wh_ratio_total,
-              stats->full_wh_ratio_var);
+      tprintf_level(1,
+          "full_wh_ratio %g full_wh_ratio_total %g full_wh_ratio_var %g\n",
+          stats->full_wh_ratio, stats->full_wh_ratio_total,
+          stats->full_wh_ratio_var);
     }
 
     stats->shape_cost =
@@ -153,7 +155,7 @@ void AssociateUtils::ComputeStats(int col, int row,
       stats->shape_cost += 10;
     }
     stats->shape_cost += stats->full_wh_ratio_var;
-    if (debug) tprintf("shape_cost %g\n", stats->shape_cost);
+    if (debug) tprintf_level(1, "shape_cost %g\n", stats->shape_cost);
   }
 }
 
@@ -175,6 +175,7 @@ namespace tesseract {
 SEAM *Wordrec::attempt_blob_chop(TWERD *word, TBLOB *blob, inT32 blob_number,
                                  bool italic_blob,
                                  const GenericVector<SEAM*>& seams) {
+  page_stats.Increment(PAGE_COUNTER_CHOPS);
   if (repair_unchopped_blobs)
     preserve_outline_tree (blob->outlines);
   TBLOB *other_blob = TBLOB::ShallowCopy(*blob);       /* Make new blob */
@@ -339,7 +340,8 @@ SEAM* Wordrec::improve_one_blob(const GenericVector<BLOB_CHOICE*>& blob_choices,
   SEAM *seam = NULL;
   do {
     *blob_number = select_blob_to_split_from_fixpt(fixpt);
-    if (chop_debug) tprintf("blob_number from fixpt = %d\n", *blob_number);
+    if (chop_debug)
+      tprintf_level(1, "blob_number from fixpt = %d\n", *blob_number);
     bool split_point_from_dict = (*blob_number != -1);
     if (split_point_from_dict) {
       fixpt->clear();
@@ -347,7 +349,7 @@ SEAM* Wordrec::improve_one_blob(const GenericVector<BLOB_CHOICE*>& blob_choices,
       *blob_number = select_blob_to_split(blob_choices, rating_ceiling,
                                           split_next_to_fragment);
     }
-    if (chop_debug) tprintf("blob_number = %d\n", *blob_number);
+    if (chop_debug) tprintf_level(1, "blob_number = %d\n", *blob_number);
     if (*blob_number == -1)
       return NULL;
 
@@ -648,12 +650,12 @@ int Wordrec::select_blob_to_split(
             worst_index_near_fragment = x;
             worst_near_fragment = blob_choice->rating();
             if (chop_debug) {
-              tprintf("worst_index_near_fragment=%d"
-                      " expand_following_fragment=%d"
-                      " expand_preceding_fragment=%d\n",
-                      worst_index_near_fragment,
-                      expand_following_fragment,
-                      expand_preceding_fragment);
+              tprintf_level(1, "worst_index_near_fragment=%d"
+                            " expand_following_fragment=%d"
+                            " expand_preceding_fragment=%d\n",
+                            worst_index_near_fragment,
+                            expand_following_fragment,
+                            expand_preceding_fragment);
             }
           }
         }
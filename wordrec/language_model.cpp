@@ -200,26 +200,17 @@ static void ScanParentsForCaseMix(const UNICHARSET& unicharset,
   }
 }
 
-// Helper returns true if the given choice has a better case variant before
-// it in the choice_list that is not distinguishable by size.
+// Helper returns true if the choice at the given index of the table has a
+// better case variant before it that is not distinguishable by size.
 static bool HasBetterCaseVariant(const UNICHARSET& unicharset,
-                                 const BLOB_CHOICE* choice,
-                                 BLOB_CHOICE_LIST* choices) {
-  UNICHAR_ID choice_id = choice->unichar_id();
+                                 int index, const BlobChoiceTable& choices) {
+  UNICHAR_ID choice_id = choices.unichar_id(index);
   UNICHAR_ID other_case = unicharset.get_other_case(choice_id);
   if (other_case == choice_id || other_case == INVALID_UNICHAR_ID)
     return false;  // Not upper or lower or not in unicharset.
   if (unicharset.SizesDistinct(choice_id, other_case))
     return false;  // Can be separated by size.
-  BLOB_CHOICE_IT bc_it(choices);
-  for (bc_it.mark_cycle_pt(); !bc_it.cycled_list(); bc_it.forward()) {
-    BLOB_CHOICE* better_choice = bc_it.data();
-    if (better_choice->unichar_id() == other_case)
-      return true;  // Found an earlier instance of other_case.
-    else if (better_choice == choice)
-      return false;  // Reached the original choice.
-  }
-  return false;  // Should never happen, but just in case.
+  return choices.FindUnichar(other_case, index) >= 0;
 }
 
 // UpdateState has the job of combining the ViterbiStateEntry lists on each
@@ -256,14 +247,17 @@ bool LanguageModel::UpdateState(
     tprintf("\nUpdateState: col=%d row=%d %s",
             curr_col, curr_row, just_classified ? "just_classified" : "");
     if (language_model_debug_level > 5)
-      tprintf("(parent=%p)\n", parent_node);
+      tprintf_level(6, "(parent=%p)\n", parent_node);
     else
       tprintf("\n");
   }
   // Initialize helper variables.
   bool word_end = (curr_row+1 >= word_res->ratings->dimension());
   bool new_changed = false;
-  float denom = (language_model_ngram_on) ? ComputeDenom(curr_list) : 1.0f;
+  // The choices are scanned many times below, so copy them to a compact
+  // table once.
+  choice_table_.Set(curr_list);
+  float denom = (language_model_ngram_on) ? ComputeDenom(choice_table_) : 1.0f;
   const UNICHARSET& unicharset = dict_->getUnicharset();
   BLOB_CHOICE *first_lower = NULL;
   BLOB_CHOICE *first_upper = NULL;
@@ -273,13 +267,13 @@ bool LanguageModel::UpdateState(
     int result = SetTopParentLowerUpperDigit(parent_node);
     if (result < 0) {
       if (language_model_debug_level > 0)
-        tprintf("No parents found to process\n");
+        tprintf_level(1, "No parents found to process\n");
       return false;
     }
     if (result > 0)
       has_alnum_mix = true;
   }
-  if (!GetTopLowerUpperDigit(curr_list, &first_lower, &first_upper,
+  if (!GetTopLowerUpperDigit(choice_table_, &first_lower, &first_upper,
                              &first_digit))
     has_alnum_mix = false;;
   ScanParentsForCaseMix(unicharset, parent_node);
@@ -290,20 +284,19 @@ bool LanguageModel::UpdateState(
 
   // Call AddViterbiStateEntry() for each parent+child ViterbiStateEntry.
   ViterbiStateEntry_IT vit;
-  BLOB_CHOICE_IT c_it(curr_list);
-  for (c_it.mark_cycle_pt(); !c_it.cycled_list(); c_it.forward()) {
-    BLOB_CHOICE* choice = c_it.data();
+  for (int c = 0; c < choice_table_.size(); ++c) {
+    BLOB_CHOICE* choice = choice_table_.choice(c);
     // TODO(antonova): make sure commenting this out if ok for ngram
     // model scoring (I think this was introduced to fix ngram model quirks).
     // Skip NULL unichars unless it is the only choice.
     //if (!curr_list->singleton() && c_it.data()->unichar_id() == 0) continue;
-    UNICHAR_ID unichar_id = choice->unichar_id();
+    UNICHAR_ID unichar_id = choice_table_.unichar_id(c);
     if (unicharset.get_fragment(unichar_id)) {
       continue;  // skip fragments
     }
     // Set top choice flags.
     LanguageModelFlagsType blob_choice_flags = kXhtConsistentFlag;
-    if (c_it.at_first() || !new_changed)
+    if (c == 0 || !new_changed)
       blob_choice_flags |= kSmallestRatingFlag;
     if (first_lower == choice) blob_choice_flags |= kLowerCaseFlag;
     if (first_upper == choice) blob_choice_flags |= kUpperCaseFlag;
@@ -321,7 +314,7 @@ bool LanguageModel::UpdateState(
       // increases the chances of choosing IPoc simply because it doesn't
       // include such a transition. iPoc will beat iPOC and ipoc because
       // the other words are baseline/x-height inconsistent.
-      if (HasBetterCaseVariant(unicharset, choice, curr_list))
+      if (HasBetterCaseVariant(unicharset, c, choice_table_))
         continue;
       // Upper counts as lower at the beginning of a word.
       if (blob_choice_flags & kUpperCaseFlag)
@@ -338,7 +331,7 @@ bool LanguageModel::UpdateState(
       ViterbiStateEntry* parent_vse = NULL;
       LanguageModelFlagsType top_choice_flags;
       while ((parent_vse = GetNextParentVSE(just_classified, has_alnum_mix,
-                                            c_it.data(), blob_choice_flags,
+                                            choice, blob_choice_flags,
                                             unicharset, word_res, &vit,
                                             &top_choice_flags)) != NULL) {
         // Skip pruned entries and do not look at prunable entries if already
@@ -353,13 +346,13 @@ bool LanguageModel::UpdateState(
         // distinguished by size, skip this blob choice/parent, as with the
         // initial blob treatment above.
         if (!parent_vse->HasAlnumChoice(unicharset) &&
-            HasBetterCaseVariant(unicharset, choice, curr_list))
+            HasBetterCaseVariant(unicharset, c, choice_table_))
           continue;
-        // Create a new ViterbiStateEntry if BLOB_CHOICE in c_it.data()
+        // Create a new ViterbiStateEntry if the BLOB_CHOICE in choice
         // looks good according to the Dawgs or character ngram model.
         new_changed |= AddViterbiStateEntry(
             top_choice_flags, denom, word_end, curr_col, curr_row,
-            c_it.data(), curr_state, parent_vse, pain_points,
+            choice, curr_state, parent_vse, pain_points,
             word_res, best_choice_bundle, blamer_bundle);
       }
     }
@@ -367,30 +360,29 @@ bool LanguageModel::UpdateState(
   return new_changed;
 }
 
-// Finds the first lower and upper case letter and first digit in curr_list.
+// Finds the first lower and upper case letter and first digit in choices.
 // For non-upper/lower languages, alpha counts as upper.
 // Uses the first character in the list in place of empty results.
 // Returns true if both alpha and digits are found.
-bool LanguageModel::GetTopLowerUpperDigit(BLOB_CHOICE_LIST *curr_list,
+bool LanguageModel::GetTopLowerUpperDigit(const BlobChoiceTable &choices,
                                           BLOB_CHOICE **first_lower,
                                           BLOB_CHOICE **first_upper,
                                           BLOB_CHOICE **first_digit) const {
-  BLOB_CHOICE_IT c_it(curr_list);
   const UNICHARSET &unicharset = dict_->getUnicharset();
   BLOB_CHOICE *first_unichar = NULL;
-  for (c_it.mark_cycle_pt(); !c_it.cycled_list(); c_it.forward()) {
-    UNICHAR_ID unichar_id = c_it.data()->unichar_id();
+  for (int c = 0; c < choices.size(); ++c) {
+    UNICHAR_ID unichar_id = choices.unichar_id(c);
     if (unicharset.get_fragment(unichar_id)) continue;  // skip fragments
-    if (first_unichar == NULL) first_unichar = c_it.data();
+    if (first_unichar == NULL) first_unichar = choices.choice(c);
     if (*first_lower == NULL && unicharset.get_islower(unichar_id)) {
-      *first_lower = c_it.data();
+      *first_lower = choices.choice(c);
     }
     if (*first_upper == NULL && unicharset.get_isalpha(unichar_id) &&
         !unicharset.get_islower(unichar_id)) {
-      *first_upper = c_it.data();
+      *first_upper = choices.choice(c);
     }
     if (*first_digit == NULL && unicharset.get_isdigit(unichar_id)) {
-      *first_digit = c_it.data();
+      *first_digit = choices.choice(c);
     }
   }
   ASSERT_HOST(first_unichar != NULL);
@@ -525,9 +517,9 @@ ViterbiStateEntry* LanguageModel::GetNextParentVSE(
       const BLOB_CHOICE* competing_b = parent_vse->competing_vse->curr_b;
       UNICHAR_ID other_id = competing_b->unichar_id();
       if (language_model_debug_level >= 5) {
-        tprintf("Parent %s has competition %s\n",
-                unicharset.id_to_unichar(parent_id),
-                unicharset.id_to_unichar(other_id));
+        tprintf_level(5, "Parent %s has competition %s\n",
+                      unicharset.id_to_unichar(parent_id),
+                      unicharset.id_to_unichar(other_id));
       }
       if (unicharset.SizesDistinct(parent_id, other_id)) {
         // If other_id matches bc wrt position and size, and parent_id, doesn't,
@@ -564,7 +556,7 @@ bool LanguageModel::AddViterbiStateEntry(
             dict_->getUnicharset().id_to_unichar(b->unichar_id()),
             b->rating(), b->certainty(), top_choice_flags);
     if (language_model_debug_level > 5)
-      tprintf(" parent_vse=%p\n", parent_vse);
+      tprintf_level(6, " parent_vse=%p\n", parent_vse);
     else
       tprintf("\n");
   }
@@ -573,7 +565,7 @@ bool LanguageModel::AddViterbiStateEntry(
       curr_state->viterbi_state_entries_length >=
           language_model_viterbi_list_max_size) {
     if (language_model_debug_level > 1) {
-      tprintf("AddViterbiStateEntry: viterbi list is full!\n");
+      tprintf_level(2, "AddViterbiStateEntry: viterbi list is full!\n");
     }
     return false;
   }
@@ -598,7 +590,8 @@ bool LanguageModel::AddViterbiStateEntry(
   // xheight, and not top choice.
   if (!liked_by_language_model && top_choice_flags == 0) {
     if (language_model_debug_level > 1) {
-      tprintf("Language model components very early pruned this entry\n");
+      tprintf_level(2,
+                    "Language model components very early pruned this entry\n");
     }
     delete ngram_info;
     delete dawg_info;
@@ -621,7 +614,7 @@ bool LanguageModel::AddViterbiStateEntry(
   // and not top choice.
   if (!liked_by_language_model && top_choice_flags == 0) {
     if (language_model_debug_level > 1) {
-      tprintf("Language model components early pruned this entry\n");
+      tprintf_level(2, "Language model components early pruned this entry\n");
     }
     delete ngram_info;
     delete dawg_info;
@@ -666,7 +659,7 @@ bool LanguageModel::AddViterbiStateEntry(
   }
   if (!keep) {
     if (language_model_debug_level > 1) {
-      tprintf("Language model components did not like this entry\n");
+      tprintf_level(2, "Language model components did not like this entry\n");
     }
     delete new_vse;
     return false;
@@ -680,9 +673,9 @@ bool LanguageModel::AddViterbiStateEntry(
        language_model_viterbi_list_max_num_prunable) &&
       new_vse->cost >= curr_state->viterbi_state_entries_prunable_max_cost) {
     if (language_model_debug_level > 1) {
-      tprintf("Discarded ViterbiEntry with high cost %g max cost %g\n",
-              new_vse->cost,
-              curr_state->viterbi_state_entries_prunable_max_cost);
+      tprintf_level(2, "Discarded ViterbiEntry with high cost %g max cost %g\n",
+                    new_vse->cost,
+                    curr_state->viterbi_state_entries_prunable_max_cost);
     }
     delete new_vse;
     return false;
@@ -696,7 +689,8 @@ bool LanguageModel::AddViterbiStateEntry(
     if (new_vse->cost >= WERD_CHOICE::kBadRating &&
         new_vse != best_choice_bundle->best_vse) {
       if (language_model_debug_level > 1) {
-        tprintf("Discarded ViterbiEntry with high cost %g\n", new_vse->cost);
+        tprintf_level(2, "Discarded ViterbiEntry with high cost %g\n",
+                      new_vse->cost);
       }
       delete new_vse;
       return false;
@@ -733,8 +727,9 @@ bool LanguageModel::AddViterbiStateEntry(
       if (prunable_counter == 0) {
         curr_state->viterbi_state_entries_prunable_max_cost = vit.data()->cost;
         if (language_model_debug_level > 1) {
-          tprintf("Set viterbi_state_entries_prunable_max_cost to %g\n",
-                  curr_state->viterbi_state_entries_prunable_max_cost);
+          tprintf_level(2,
+                        "Set viterbi_state_entries_prunable_max_cost to %g\n",
+                        curr_state->viterbi_state_entries_prunable_max_cost);
         }
         prunable_counter = -1;  // stop counting
       }
@@ -762,8 +757,8 @@ void LanguageModel::GenerateTopChoiceInfo(ViterbiStateEntry *new_vse,
     new_vse->top_choice_flags &= ~(vit.data()->top_choice_flags);
   }
   if (language_model_debug_level > 2) {
-    tprintf("GenerateTopChoiceInfo: top_choice_flags=0x%x\n",
-            new_vse->top_choice_flags);
+    tprintf_level(3, "GenerateTopChoiceInfo: top_choice_flags=0x%x\n",
+                  new_vse->top_choice_flags);
   }
 }
 
@@ -785,7 +780,8 @@ LanguageModelDawgInfo *LanguageModel::GenerateDawgInfo(
 
   // Deal with hyphenated words.
   if (word_end && dict_->has_hyphen_end(b.unichar_id(), curr_col == 0)) {
-    if (language_model_debug_level > 0) tprintf("Hyphenated word found\n");
+    if (language_model_debug_level > 0)
+      tprintf_level(1, "Hyphenated word found\n");
     return new LanguageModelDawgInfo(dawg_args_->active_dawgs,
                                      COMPOUND_PERM);
   }
@@ -793,7 +789,8 @@ LanguageModelDawgInfo *LanguageModel::GenerateDawgInfo(
   // Deal with compound words.
   if (dict_->compound_marker(b.unichar_id()) &&
       (parent_vse == NULL || parent_vse->dawg_info->permuter != NUMBER_PERM)) {
-    if (language_model_debug_level > 0) tprintf("Found compound marker\n");
+    if (language_model_debug_level > 0)
+      tprintf_level(1, "Found compound marker\n");
     // Do not allow compound operators at the beginning and end of the word.
     // Do not allow more than one compound operator per word.
     // Do not allow compounding of words with lengths shorter than
@@ -818,7 +815,8 @@ LanguageModelDawgInfo *LanguageModel::GenerateDawgInfo(
     }
     if (!has_word_ending) return NULL;
 
-    if (language_model_debug_level > 0) tprintf("Compound word found\n");
+    if (language_model_debug_level > 0)
+      tprintf_level(1, "Compound word found\n");
     return new LanguageModelDawgInfo(beginning_active_dawgs_, COMPOUND_PERM);
   }  // done dealing with compound words
 
@@ -832,8 +830,8 @@ LanguageModelDawgInfo *LanguageModel::GenerateDawgInfo(
   DawgPositionVector tmp_active_dawgs;
   for (int i = 0; i < normed_ids.size(); ++i) {
     if (language_model_debug_level > 2)
-      tprintf("Test Letter OK for unichar %d, normed %d\n",
-              b.unichar_id(), normed_ids[i]);
+      tprintf_level(3, "Test Letter OK for unichar %d, normed %d\n",
+                    b.unichar_id(), normed_ids[i]);
     dict_->LetterIsOkay(dawg_args_, normed_ids[i],
                         word_end && i == normed_ids.size() - 1);
     if (dawg_args_->permuter == NO_PERM) {
@@ -843,16 +841,16 @@ LanguageModelDawgInfo *LanguageModel::GenerateDawgInfo(
       dawg_args_->active_dawgs = &tmp_active_dawgs;
     }
     if (language_model_debug_level > 2)
-      tprintf("Letter was OK for unichar %d, normed %d\n",
-              b.unichar_id(), normed_ids[i]);
+      tprintf_level(3, "Letter was OK for unichar %d, normed %d\n",
+                    b.unichar_id(), normed_ids[i]);
   }
   dawg_args_->active_dawgs = NULL;
   if (dawg_args_->permuter != NO_PERM) {
     dawg_info = new LanguageModelDawgInfo(dawg_args_->updated_dawgs,
                                           dawg_args_->permuter);
   } else if (language_model_debug_level > 3) {
-    tprintf("Letter %s not OK!\n",
-            dict_->getUnicharset().id_to_unichar(b.unichar_id()));
+    tprintf_level(4, "Letter %s not OK!\n",
+                  dict_->getUnicharset().id_to_unichar(b.unichar_id()));
   }
 
   return dawg_info;
@@ -932,8 +930,8 @@ float LanguageModel::ComputeNgramCost(const char *unichar,
   while (unichar_ptr < unichar_end &&
          (step = UNICHAR::utf8_step(unichar_ptr)) > 0) {
     if (language_model_debug_level > 1) {
-      tprintf("prob(%s | %s)=%g\n", unichar_ptr, context_ptr,
-              dict_->ProbabilityInContext(context_ptr, -1, unichar_ptr, step));
+      tprintf_level(2, "prob(%s | %s)=%g\n", unichar_ptr, context_ptr,
+          dict_->ProbabilityInContext(context_ptr, -1, unichar_ptr, step));
     }
     prob += dict_->ProbabilityInContext(context_ptr, -1, unichar_ptr, step);
     ++(*unichar_step_len);
@@ -958,7 +956,8 @@ float LanguageModel::ComputeNgramCost(const char *unichar,
   }
   prob /= static_cast<float>(*unichar_step_len);  // normalize
   if (prob < language_model_ngram_small_prob) {
-    if (language_model_debug_level > 0) tprintf("Found small prob %g\n", prob);
+    if (language_model_debug_level > 0)
+      tprintf_level(1, "Found small prob %g\n", prob);
     *found_small_prob = true;
     prob = language_model_ngram_small_prob;
   }
@@ -967,25 +966,21 @@ float LanguageModel::ComputeNgramCost(const char *unichar,
       -1.0*log2(CertaintyScore(certainty)/denom) +
       *ngram_cost * language_model_ngram_scale_factor;
   if (language_model_debug_level > 1) {
-    tprintf("-log [ p(%s) * p(%s | %s) ] = -log2(%g*%g) = %g\n", unichar,
-            unichar, context_ptr, CertaintyScore(certainty)/denom, prob,
-            ngram_and_classifier_cost);
+    tprintf_level(2,
+                  "-log [ p(%s) * p(%s | %s) ] = -log2(%g*%g) = %g\n", unichar,
+                  unichar, context_ptr, CertaintyScore(certainty)/denom, prob,
+                  ngram_and_classifier_cost);
   }
   if (modified_context != NULL) delete[] modified_context;
   return ngram_and_classifier_cost;
 }
 
-float LanguageModel::ComputeDenom(BLOB_CHOICE_LIST *curr_list) {
-  if (curr_list->empty()) return 1.0f;
+float LanguageModel::ComputeDenom(const BlobChoiceTable &choices) {
+  if (choices.empty()) return 1.0f;
   float denom = 0.0f;
-  int len = 0;
-  BLOB_CHOICE_IT c_it(curr_list);
-  for (c_it.mark_cycle_pt(); !c_it.cycled_list(); c_it.forward()) {
-    ASSERT_HOST(c_it.data() != NULL);
-    ++len;
-    denom += CertaintyScore(c_it.data()->certainty());
-  }
-  assert(len != 0);
+  int len = choices.size();
+  for (int c = 0; c < len; ++c)
+    denom += CertaintyScore(choices.certainty(c));
   // The ideal situation would be to have the classifier scores for
   // classifying each position as each of the characters in the unicharset.
   // Since we can not do this because of speed, we add a very crude estimate
@@ -1164,10 +1159,11 @@ void LanguageModel::FillConsistencyInfo(
           consistency_info->num_inconsistent_spaces++;
         }
         if (language_model_debug_level > 1) {
-          tprintf("spacing for %s(%d) %s(%d) col %d: expected %g actual %g\n",
-                  unicharset.id_to_unichar(parent_b->unichar_id()),
-                  parent_b->unichar_id(), unicharset.id_to_unichar(unichar_id),
-                  unichar_id, curr_col, expected_gap, actual_gap);
+          tprintf_level(2,
+              "spacing for %s(%d) %s(%d) col %d: expected %g actual %g\n",
+              unicharset.id_to_unichar(parent_b->unichar_id()),
+              parent_b->unichar_id(), unicharset.id_to_unichar(unichar_id),
+              unichar_id, curr_col, expected_gap, actual_gap);
         }
       }
     }
@@ -1414,8 +1410,8 @@ WERD_CHOICE *LanguageModel::ConstructWord(
       vse->associate_stats.full_wh_ratio_var +=
         pow(full_wh_ratio_mean - curr_vse->associate_stats.full_wh_ratio, 2);
       if (language_model_debug_level > 2) {
-        tprintf("full_wh_ratio_var += (%g-%g)^2\n",
-                full_wh_ratio_mean, curr_vse->associate_stats.full_wh_ratio);
+        tprintf_level(3, "full_wh_ratio_var += (%g-%g)^2\n", full_wh_ratio_mean,
+                      curr_vse->associate_stats.full_wh_ratio);
       }
     }
 
@@ -150,10 +150,10 @@ class LanguageModel {
   // probability.
   float ComputeAdjustedPathCost(ViterbiStateEntry *vse);
 
-  // Finds the first lower and upper case letter and first digit in curr_list.
+  // Finds the first lower and upper case letter and first digit in choices.
   // Uses the first character in the list in place of empty results.
   // Returns true if both alpha and digits are found.
-  bool GetTopLowerUpperDigit(BLOB_CHOICE_LIST *curr_list,
+  bool GetTopLowerUpperDigit(const BlobChoiceTable &choices,
                              BLOB_CHOICE **first_lower,
                              BLOB_CHOICE **first_upper,
                              BLOB_CHOICE **first_digit) const;
@@ -230,7 +230,7 @@ class LanguageModel {
 
   // Computes the normalization factors for the classifier confidences
   // (used by ComputeNgramCost()).
-  float ComputeDenom(BLOB_CHOICE_LIST *curr_list);
+  float ComputeDenom(const BlobChoiceTable &choices);
 
   // Fills the given consistenty_info based on parent_vse.consistency_info
   // and on the consistency of the given unichar_id with parent_vse.
@@ -362,6 +362,9 @@ class LanguageModel {
   DawgArgs *dawg_args_;
   // Scaling for recovering blob outline length from rating and certainty.
   float rating_cert_scale_;
+  // Compact copy of the choices of the cell being processed by UpdateState,
+  // re-used across calls to avoid dynamic memory re-allocation.
+  BlobChoiceTable choice_table_;
 
   // The following variables are set at construction time.
 
@@ -153,8 +153,8 @@ bool LMPainPoints::GeneratePainPoint(
     return false;
   }
   if (debug_level_ > 3) {
-    tprintf("Generating pain point for col=%d row=%d type=%s\n",
-            col, row, LMPainPointsTypeName[pp_type]);
+    tprintf_level(4, "Generating pain point for col=%d row=%d type=%s\n",
+                  col, row, LMPainPointsTypeName[pp_type]);
   }
   // Compute associate stats.
   AssociateStats associate_stats;
@@ -176,7 +176,7 @@ bool LMPainPoints::GeneratePainPoint(
   }
   if (associate_stats.bad_shape) {
     if (debug_level_ > 3) {
-      tprintf("Discarded pain point with a bad shape\n");
+      tprintf_level(4, "Discarded pain point with a bad shape\n");
     }
     return false;
   }
@@ -193,11 +193,11 @@ bool LMPainPoints::GeneratePainPoint(
     MatrixCoordPair pain_point(priority, MATRIX_COORD(col, row));
     pain_points_heaps_[pp_type].Push(&pain_point);
     if (debug_level_) {
-      tprintf("Added pain point with priority %g\n", priority);
+      tprintf_level(1, "Added pain point with priority %g\n", priority);
     }
     return true;
   } else {
-    if (debug_level_) tprintf("Pain points heap is full\n");
+    if (debug_level_) tprintf_level(1, "Pain points heap is full\n");
     return false;
   }
 }
@@ -20,10 +20,25 @@
 
 #include "lm_state.h"
 
+#include "objectpool.h"
+
 namespace tesseract {
 
 ELISTIZE(ViterbiStateEntry);
 
+// Free blocks for recycling ViterbiStateEntries.
+static TESS_THREAD_LOCAL FreeBlockList viterbi_state_entry_blocks;
+
+void* ViterbiStateEntry::operator new(size_t size) {
+  return FreeBlockList::Alloc(size, sizeof(ViterbiStateEntry),
+                              &viterbi_state_entry_blocks);
+}
+
+void ViterbiStateEntry::operator delete(void* block, size_t size) {
+  FreeBlockList::Free(block, size, sizeof(ViterbiStateEntry),
+                      &viterbi_state_entry_blocks);
+}
+
 void ViterbiStateEntry::Print(const char *msg) const {
   tprintf("%s ViterbiStateEntry", msg);
   if (updated) tprintf("(NEW)");
@@ -122,6 +122,10 @@ struct ViterbiStateEntry : public ELIST_LINK {
     delete ngram_info;
     delete debug_str;
   }
+  // Instances are recycled through a per-thread FreeBlockList, as very
+  // many are made and destroyed for every word.
+  static void* operator new(size_t size);
+  static void operator delete(void* block, size_t size);
   // Comparator function for sorting ViterbiStateEntry_LISTs in
   // non-increasing order of costs.
   static int Compare(const void *e1, const void *e2) {
@@ -37,6 +37,7 @@ void Wordrec::DoSegSearch(WERD_RES* word_res) {
 void Wordrec::SegSearch(WERD_RES* word_res,
                         BestChoiceBundle* best_choice_bundle,
                         BlamerBundle* blamer_bundle) {
+  PageStageTimer timer(&page_stats, PAGE_STAGE_SEGSEARCH);
   if (segsearch_debug_level > 0) {
     tprintf("Starting SegSearch on ratings matrix%s:\n",
             wordrec_enable_assoc ? " (with assoc)" : "");
@@ -85,7 +86,8 @@ void Wordrec::SegSearch(WERD_RES* word_res,
                        &pain_points, best_choice_bundle, blamer_bundle);
 
   if (!SegSearchDone(0)) {  // find a better choice
-    if (chop_enable && word_res->chopped_word != NULL) {
+    if (chop_enable && !(skipped_work_ & SKIP_CHOPPING) &&
+        word_res->chopped_word != NULL) {
       improve_by_chopping(rating_cert_scale, word_res, best_choice_bundle,
                           blamer_bundle, &pain_points, &pending);
     }
@@ -100,7 +102,7 @@ void Wordrec::SegSearch(WERD_RES* word_res,
   // Keep trying to find a better path by fixing the "pain points".
   int num_futile_classifications = 0;
   STRING blamer_debug;
-  while (wordrec_enable_assoc &&
+  while (wordrec_enable_assoc && !(skipped_work_ & SKIP_SEGSEARCH) &&
       (!SegSearchDone(num_futile_classifications) ||
           (blamer_bundle != NULL &&
               blamer_bundle->GuidedSegsearchStillGoing()))) {
@@ -121,7 +123,8 @@ void Wordrec::SegSearch(WERD_RES* word_res,
       }
     }
     if (found_nothing) {
-      if (segsearch_debug_level > 0) tprintf("Pain points queue is empty\n");
+      if (segsearch_debug_level > 0)
+        tprintf_level(1, "Pain points queue is empty\n");
       break;
     }
     ProcessSegSearchPainPoint(pain_point_priority, pain_point,
@@ -134,7 +137,8 @@ void Wordrec::SegSearch(WERD_RES* word_res,
     if (!best_choice_bundle->updated) ++num_futile_classifications;
 
     if (segsearch_debug_level > 0) {
-      tprintf("num_futile_classifications %d\n", num_futile_classifications);
+      tprintf_level(1, "num_futile_classifications %d\n",
+                    num_futile_classifications);
     }
 
     best_choice_bundle->updated = false;  // reset updated
@@ -154,8 +158,8 @@ void Wordrec::SegSearch(WERD_RES* word_res,
   }
 
   if (segsearch_debug_level > 0) {
-    tprintf("Done with SegSearch (AcceptableChoiceFound: %d)\n",
-            language_model_->AcceptableChoiceFound());
+    tprintf_level(1, "Done with SegSearch (AcceptableChoiceFound: %d)\n",
+                  language_model_->AcceptableChoiceFound());
   }
 }
 
@@ -179,9 +183,9 @@ void Wordrec::UpdateSegSearchNodes(
       first_row = last_row = (*pending)[col].SingleRow();
     }
     if (segsearch_debug_level > 0) {
-      tprintf("\n\nUpdateSegSearchNodes: col=%d, rows=[%d,%d], alljust=%d\n",
-              col, first_row, last_row,
-              (*pending)[col].IsRowJustClassified(MAX_INT32));
+      tprintf_level(1,
+          "\n\nUpdateSegSearchNodes: col=%d, rows=[%d,%d], alljust=%d\n", col,
+          first_row, last_row, (*pending)[col].IsRowJustClassified(MAX_INT32));
     }
     // Iterate over the pending list for this column.
     for (int row = first_row; row <= last_row; ++row) {
@@ -199,7 +203,7 @@ void Wordrec::UpdateSegSearchNodes(
         // the child column.
         (*pending)[row + 1].RevisitWholeColumn();
         if (segsearch_debug_level > 0) {
-          tprintf("Added child col=%d to pending\n", row + 1);
+          tprintf_level(1, "Added child col=%d to pending\n", row + 1);
         }
       }  // end if UpdateState.
     }  // end for row.
@@ -232,10 +236,12 @@ void Wordrec::ProcessSegSearchPainPoint(
     const MATRIX_COORD &pain_point, const char* pain_point_type,
     GenericVector<SegSearchPending>* pending, WERD_RES *word_res,
     LMPainPoints *pain_points, BlamerBundle *blamer_bundle) {
+  page_stats.Increment(PAGE_COUNTER_PAIN_POINTS);
   if (segsearch_debug_level > 0) {
-    tprintf("Classifying pain point %s priority=%.4f, col=%d, row=%d\n",
-            pain_point_type, pain_point_priority,
-            pain_point.col, pain_point.row);
+    tprintf_level(1,
+                  "Classifying pain point %s priority=%.4f, col=%d, row=%d\n",
+                  pain_point_type, pain_point_priority,
+                  pain_point.col, pain_point.row);
   }
   ASSERT_HOST(pain_points != NULL);
   MATRIX *ratings = word_res->ratings;
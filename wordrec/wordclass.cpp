@@ -61,6 +61,7 @@ BLOB_CHOICE_LIST *Wordrec::classify_blob(TBLOB *blob,
     display_blob(blob, color);
 #endif
   // TODO(rays) collapse with call_matcher and move all to wordrec.cpp.
+  page_stats.Increment(PAGE_COUNTER_BLOBS_CLASSIFIED);
   BLOB_CHOICE_LIST* choices = call_matcher(blob);
   // If a blob with the same bounding box as one of the truth character
   // bounding boxes is not classified as the corresponding truth character
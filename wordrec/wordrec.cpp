@@ -115,6 +115,7 @@ Wordrec::Wordrec() :
               " and segmentation search",
               params()) {
   prev_word_best_choice_ = NULL;
+  skipped_work_ = SKIP_NONE;
   language_model_ = new LanguageModel(&get_fontinfo_table(),
                                       &(getDict()));
   fill_lattice_ = NULL;
@@ -418,6 +418,9 @@ class Wordrec : public Classify {
   // This variable is modified by PAGE_RES_IT when iterating over
   // words to OCR on the page.
   WERD_CHOICE *prev_word_best_choice_;
+  // Bit mask of SkippedWork to leave out of the recognition of the current
+  // word, to meet a deadline.
+  int skipped_work_;
   // Sums of blame reasons computed by the blamer.
   GenericVector<int> blame_reasons_;
   // Function used to fill char choice lattices.